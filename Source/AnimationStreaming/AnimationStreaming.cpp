@@ -4,3 +4,13 @@
 #include "Modules/ModuleManager.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, AnimationStreaming, "AnimationStreaming" );
+
+DEFINE_LOG_CATEGORY(LogAnimationStreaming);
+
+DEFINE_STAT(STAT_AnimationStreaming_Read);
+DEFINE_STAT(STAT_AnimationStreaming_Tokenize);
+DEFINE_STAT(STAT_AnimationStreaming_Convert);
+DEFINE_STAT(STAT_AnimationStreaming_SequenceLookup);
+DEFINE_STAT(STAT_AnimationStreaming_ChannelWrite);
+DEFINE_STAT(STAT_AnimationStreaming_Modify);
+DEFINE_STAT(STAT_AnimationStreaming_Playback);
@@ -3,4 +3,19 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
 
+//Import summaries log at Log, per-frame dumps at VeryVerbose and stay compiled out of the default output.
+ANIMATIONSTREAMING_API DECLARE_LOG_CATEGORY_EXTERN(LogAnimationStreaming, Log, All);
+
+//Import phases, visible with "stat AnimationStreaming" and as cpu scopes in Unreal Insights.
+//Phases do not nest, so they add up like FKeyframeImportReport: Tokenize includes narrowing into float channels, Convert is the channel key build.
+DECLARE_STATS_GROUP(TEXT("AnimationStreaming"), STATGROUP_AnimationStreaming, STATCAT_Advanced);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Read"), STAT_AnimationStreaming_Read, STATGROUP_AnimationStreaming, ANIMATIONSTREAMING_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tokenize"), STAT_AnimationStreaming_Tokenize, STATGROUP_AnimationStreaming, ANIMATIONSTREAMING_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Convert"), STAT_AnimationStreaming_Convert, STATGROUP_AnimationStreaming, ANIMATIONSTREAMING_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Sequence Lookup"), STAT_AnimationStreaming_SequenceLookup, STATGROUP_AnimationStreaming, ANIMATIONSTREAMING_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Channel Write"), STAT_AnimationStreaming_ChannelWrite, STATGROUP_AnimationStreaming, ANIMATIONSTREAMING_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Modify"), STAT_AnimationStreaming_Modify, STATGROUP_AnimationStreaming, ANIMATIONSTREAMING_API);
+//Runtime playback, track evaluation and the transform writes of one tick.
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Playback"), STAT_AnimationStreaming_Playback, STATGROUP_AnimationStreaming, ANIMATIONSTREAMING_API);
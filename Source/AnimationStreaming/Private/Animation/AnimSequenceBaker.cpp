@@ -0,0 +1,212 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Animation/AnimSequenceBaker.h"
+
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+#include "Animation/AnimData/IAnimationDataController.h"
+
+#include "Algo/StableSort.h"
+#include "Async/ParallelFor.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "AnimationStreaming.h"
+
+
+namespace AnimSequenceBaker
+{
+    void WriteSample(FBoneTrackKeys& OutKeys, const int32 Sample, const FTransform& Transform)
+    {
+        OutKeys.Positions[Sample] = FVector3f(Transform.GetLocation());
+        OutKeys.Rotations[Sample] = FQuat4f(Transform.GetRotation().GetNormalized());
+        OutKeys.Scales[Sample] = FVector3f(Transform.GetScale3D());
+    }
+
+    UAnimSequence* FindOrCreateAnimSequence(const FString& AssetPath, bool& bOutCreated)
+    {
+        const FString AssetName{ FPackageName::GetShortName(AssetPath) };
+        bOutCreated = false;
+        if (UAnimSequence* Existing = LoadObject<UAnimSequence>(nullptr, *(AssetPath + TEXT(".") + AssetName), nullptr, LOAD_NoWarn | LOAD_Quiet))
+        {
+            return Existing;
+        }
+
+        UPackage* Package{ CreatePackage(*AssetPath) };
+        if (!IsValid(Package))
+        {
+            return nullptr;
+        }
+
+        bOutCreated = true;
+        return NewObject<UAnimSequence>(Package, *AssetName, RF_Public | RF_Standalone | RF_Transactional);
+    }
+}
+
+void FAnimSequenceBaker::BuildBoneKeys(const TArray<FKeyframes>& Keyframes, const int32 FirstFrame, const int32 NumFrames, FBoneTrackKeys& OutKeys)
+{
+    OutKeys.Positions.SetNumUninitialized(NumFrames);
+    OutKeys.Rotations.SetNumUninitialized(NumFrames);
+    OutKeys.Scales.SetNumUninitialized(NumFrames);
+    if (Keyframes.Num() == 0)
+    {
+        return;
+    }
+
+    TArray<int32> Order;
+    Order.SetNumUninitialized(Keyframes.Num());
+    for (int32 Index = 0; Index < Keyframes.Num(); ++Index)
+    {
+        Order[Index] = Index;
+    }
+    Algo::StableSort(Order, [&Keyframes](const int32 A, const int32 B) { return Keyframes[A].Frame < Keyframes[B].Frame; });
+
+    //Holds the first key before it, blends between keys and holds the last key after it. Duplicated frames keep the last.
+    const FKeyframes* Previous{ nullptr };
+    for (const int32 Index : Order)
+    {
+        const FKeyframes& Keyframe{ Keyframes[Index] };
+        const int32 Sample{ FMath::Clamp(Keyframe.Frame - FirstFrame, 0, NumFrames - 1) };
+        const int32 PreviousSample{ Previous != nullptr ? Previous->Frame - FirstFrame : -1 };
+        for (int32 Gap = PreviousSample + 1; Gap < Sample; ++Gap)
+        {
+            if (Previous == nullptr)
+            {
+                AnimSequenceBaker::WriteSample(OutKeys, Gap, Keyframe.Coordinates);
+                continue;
+            }
+
+            FTransform Blended;
+            Blended.Blend(Previous->Coordinates, Keyframe.Coordinates, static_cast<float>(Gap - PreviousSample) / static_cast<float>(Sample - PreviousSample));
+            AnimSequenceBaker::WriteSample(OutKeys, Gap, Blended);
+        }
+
+        AnimSequenceBaker::WriteSample(OutKeys, Sample, Keyframe.Coordinates);
+        Previous = &Keyframe;
+    }
+
+    for (int32 Sample = Previous->Frame - FirstFrame + 1; Sample < NumFrames; ++Sample)
+    {
+        AnimSequenceBaker::WriteSample(OutKeys, Sample, Previous->Coordinates);
+    }
+
+    //Neighbouring quaternions on the same hemisphere so the sequence interpolates the short way.
+    for (int32 Sample = 1; Sample < NumFrames; ++Sample)
+    {
+        if ((OutKeys.Rotations[Sample] | OutKeys.Rotations[Sample - 1]) < 0.0f)
+        {
+            OutKeys.Rotations[Sample] *= -1.0f;
+        }
+    }
+}
+
+UAnimSequence* FAnimSequenceBaker::Bake(const TMap<FString, FKeyframeTrack>& Controls, USkeleton* Skeleton, const FString& AssetPath, const FFrameRate& FrameRate, const FAnimBakeSettings& Settings, bool& bOutSuccess, FString& OutInfoMessage)
+{
+#if WITH_EDITOR
+    check(IsInGameThread());
+    TRACE_CPUPROFILER_EVENT_SCOPE(FAnimSequenceBaker::Bake);
+
+    if (!IsValid(Skeleton))
+    {
+        bOutSuccess = false;
+        OutInfoMessage = TEXT("Skeleton is not valid");
+
+        return nullptr;
+    }
+
+    //Every bone receives at most one control.
+    const FReferenceSkeleton& ReferenceSkeleton{ Skeleton->GetReferenceSkeleton() };
+    TArray<const FKeyframeTrack*> Tracks;
+    TArray<FName> Bones;
+    int32 FirstFrame{ MAX_int32 };
+    int32 LastFrame{ MIN_int32 };
+    for (const TPair<FString, FKeyframeTrack>& Control : Controls)
+    {
+        const FName* MappedBone{ Settings.ControlToBone.Find(Control.Key) };
+        const FName Bone{ MappedBone != nullptr ? *MappedBone : FName(*Control.Key) };
+        if (ReferenceSkeleton.FindBoneIndex(Bone) == INDEX_NONE || Bones.Contains(Bone))
+        {
+            if (!Settings.bSkipUnmatchedControls)
+            {
+                bOutSuccess = false;
+                OutInfoMessage = FString::Printf(TEXT("Control '%s' has no free bone '%s' in the skeleton"), *Control.Key, *Bone.ToString());
+
+                return nullptr;
+            }
+
+            UE_LOG(LogAnimationStreaming, Warning, TEXT("Bake skips control '%s': no free bone '%s' in the skeleton"), *Control.Key, *Bone.ToString());
+            continue;
+        }
+
+        if (Control.Value.Keyframes.Num() == 0)
+        {
+            continue;
+        }
+
+        Tracks.Add(&Control.Value);
+        Bones.Add(Bone);
+        for (const FKeyframes& Keyframe : Control.Value.Keyframes)
+        {
+            FirstFrame = FMath::Min(FirstFrame, Keyframe.Frame);
+            LastFrame = FMath::Max(LastFrame, Keyframe.Frame);
+        }
+    }
+
+    if (Tracks.Num() == 0)
+    {
+        bOutSuccess = false;
+        OutInfoMessage = TEXT("No control matches a bone of the skeleton");
+
+        return nullptr;
+    }
+
+    //A sequence needs at least two keys, a single frame capture is held for one frame.
+    const int32 NumSamples{ FMath::Max(LastFrame - FirstFrame + 1, 2) };
+    TArray<FBoneTrackKeys> BoneKeys;
+    BoneKeys.SetNum(Tracks.Num());
+    ParallelFor(Tracks.Num(), [&Tracks, &Bones, &BoneKeys, FirstFrame, NumSamples](const int32 Index)
+    {
+        BoneKeys[Index].BoneName = Bones[Index];
+        BuildBoneKeys(Tracks[Index]->Keyframes, FirstFrame, NumSamples, BoneKeys[Index]);
+    });
+
+    bool bCreated{ false };
+    UAnimSequence* AnimSequence{ AnimSequenceBaker::FindOrCreateAnimSequence(AssetPath, bCreated) };
+    if (!IsValid(AnimSequence))
+    {
+        bOutSuccess = false;
+        OutInfoMessage = FString::Printf(TEXT("Anim sequence is not valid - '%s'"), *AssetPath);
+
+        return nullptr;
+    }
+    AnimSequence->SetSkeleton(Skeleton);
+
+    //One bracket, the model notifies its listeners once when it is closed.
+    IAnimationDataController& Controller{ AnimSequence->GetController() };
+    Controller.OpenBracket(NSLOCTEXT("AnimSequenceBaker", "BakeCapture", "Bake capture"), false);
+    if (bCreated)
+    {
+        Controller.InitializeModel();
+    }
+    Controller.RemoveAllBoneTracks(false);
+    Controller.SetFrameRate(FrameRate, false);
+    Controller.SetNumberOfFrames(FFrameNumber(NumSamples - 1), false);
+    for (const FBoneTrackKeys& Keys : BoneKeys)
+    {
+        Controller.AddBoneCurve(Keys.BoneName, false);
+        Controller.SetBoneTrackKeys(Keys.BoneName, Keys.Positions, Keys.Rotations, Keys.Scales, false);
+    }
+    Controller.NotifyPopulated();
+    Controller.CloseBracket(false);
+
+    AnimSequence->MarkPackageDirty();
+    bOutSuccess = true;
+
+    return AnimSequence;
+#else
+    bOutSuccess = false;
+    OutInfoMessage = TEXT("Baking anim sequences needs an editor build");
+
+    return nullptr;
+#endif
+}
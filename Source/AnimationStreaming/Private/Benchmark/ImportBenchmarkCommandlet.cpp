@@ -0,0 +1,950 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Benchmark/ImportBenchmarkCommandlet.h"
+
+#include "Benchmark/SyntheticCapture.h"
+#include "Format/KeyframeBinarySource.h"
+#include "Json/JsonManager.h"
+#include "Json/KeyframeCache.h"
+#include "Json/KeyframeJsonParser.h"
+#include "Math/KeyframeVectorMath.h"
+#include "Playback/KeyframePlaybackTrack.h"
+#include "Sequencer/SequencerImportSession.h"
+#include "Sequencer/SequencerManager.h"
+#include "Sequencer/KeyframeDeltaImport.h"
+#include "Sequencer/KeyframeFrameIndex.h"
+#include "Struct/KeyframeCompressedTrack.h"
+#include "AnimationStreaming.h"
+
+#include "Runtime/LevelSequence/Public/LevelSequence.h"
+#include "MovieScene.h"
+#include "Tracks/MovieScene3DTransformTrack.h"
+#include "Channels/MovieSceneChannelProxy.h"
+#include "Channels/MovieSceneDoubleChannel.h"
+
+#include "Algo/StableSort.h"
+#include "Engine/World.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "Serialization/JsonSerializer.h"
+#include "UObject/Package.h"
+
+
+namespace ImportBenchmark
+{
+    constexpr int32 Seed{ 1337 };
+
+    void ParseIntList(const FString& Params, const TCHAR* Switch, TArray<int32>& InOutValues)
+    {
+        FString Value;
+        if (!FParse::Value(*Params, Switch, Value))
+        {
+            return;
+        }
+
+        TArray<FString> Entries;
+        Value.ParseIntoArray(Entries, TEXT(","));
+        InOutValues.Reset(Entries.Num());
+        for (const FString& Entry : Entries)
+        {
+            InOutValues.Add(FCString::Atoi(*Entry));
+        }
+    }
+
+    FString MakeCaseName(const int32 Frames, const int32 Controls)
+    {
+        return FString::Printf(TEXT("%d_frames_%d_controls"), Frames, Controls);
+    }
+
+    //Runs Body once and returns its wall-clock seconds.
+    template <typename BodyType>
+    double Time(BodyType&& Body)
+    {
+        const double StartSeconds{ FPlatformTime::Seconds() };
+        Body();
+
+        return FPlatformTime::Seconds() - StartSeconds;
+    }
+
+    void DeleteCache(const FString& CapturePath)
+    {
+        IFileManager::Get().Delete(*FKeyframeCache::GetCachePath(CapturePath), false, true, true);
+    }
+
+    //Copy of USequencerManager::AddTransformKeyframe before FSequencerImportSession, kept as the per-key baseline:
+    //the sequence is loaded and the binding, track and section are resolved for every key, every channel write
+    //goes through the channel proxy and its own Modify().
+    void AddKeyframeToDoubleChannelResolvePerCall(UMovieSceneSection* Section, const int ChannelIndex, const int Frame, double Value, int KeyInterpolation, bool& bOutSuccess)
+    {
+        FMovieSceneDoubleChannel* Channel{ Section->GetChannelProxy().GetChannel<FMovieSceneDoubleChannel>(ChannelIndex) };
+        ULevelSequence* LevelSequence{ Cast<ULevelSequence>(Section->GetOutermostObject()) };
+        if (Channel == nullptr || !IsValid(LevelSequence))
+        {
+            bOutSuccess = false;
+
+            return;
+        }
+
+        const int TickPerFrame = LevelSequence->MovieScene->GetTickResolution().AsDecimal() / LevelSequence->MovieScene->GetDisplayRate().AsDecimal();
+        const FFrameNumber FrameNumber{ FFrameNumber(Frame * TickPerFrame) };
+
+        if (KeyInterpolation == 0)
+        {
+            Channel->AddCubicKey(FrameNumber, Value);
+        }
+        else if (KeyInterpolation == 1)
+        {
+            Channel->AddLinearKey(FrameNumber, Value);
+        }
+        else
+        {
+            Channel->AddConstantKey(FrameNumber, Value);
+        }
+
+        Section->Modify();
+    }
+
+    void AddTransformKeyframeResolvePerCall(AActor* Actor, const FString& SequencerPath, const int SectionIndex, const int Frame, const FTransform& Transform, int KeyInterpolation, bool& bOutSuccess)
+    {
+        //Loaded once for the binding and once more for the track, as GetTransformSectionFromActor did.
+        ULevelSequence* LevelSequence{ Cast<ULevelSequence>(StaticLoadObject(ULevelSequence::StaticClass(), nullptr, *SequencerPath)) };
+        const FGuid ActorID{ IsValid(LevelSequence) ? LevelSequence->FindBindingFromObject(Actor, Actor->GetWorld()) : FGuid() };
+        LevelSequence = Cast<ULevelSequence>(StaticLoadObject(ULevelSequence::StaticClass(), nullptr, *SequencerPath));
+        UMovieScene3DTransformTrack* TransformTrack{ ActorID.IsValid() && IsValid(LevelSequence) ? LevelSequence->MovieScene->FindTrack<UMovieScene3DTransformTrack>(ActorID) : nullptr };
+        if (!IsValid(TransformTrack))
+        {
+            bOutSuccess = false;
+
+            return;
+        }
+
+        const TArray<UMovieSceneSection*> AllSections{ TransformTrack->GetAllSections() };
+        UMovieSceneSection* Section{ AllSections.IsValidIndex(SectionIndex) ? AllSections[SectionIndex] : nullptr };
+        if (!IsValid(Section))
+        {
+            bOutSuccess = false;
+
+            return;
+        }
+
+        AddKeyframeToDoubleChannelResolvePerCall(Section, 0, Frame, Transform.GetLocation().X, KeyInterpolation, bOutSuccess);
+        AddKeyframeToDoubleChannelResolvePerCall(Section, 1, Frame, Transform.GetLocation().Y, KeyInterpolation, bOutSuccess);
+        AddKeyframeToDoubleChannelResolvePerCall(Section, 2, Frame, Transform.GetLocation().Z, KeyInterpolation, bOutSuccess);
+        AddKeyframeToDoubleChannelResolvePerCall(Section, 3, Frame, Transform.Rotator().Roll, KeyInterpolation, bOutSuccess);
+        AddKeyframeToDoubleChannelResolvePerCall(Section, 4, Frame, Transform.Rotator().Pitch, KeyInterpolation, bOutSuccess);
+        AddKeyframeToDoubleChannelResolvePerCall(Section, 5, Frame, Transform.Rotator().Yaw, KeyInterpolation, bOutSuccess);
+        AddKeyframeToDoubleChannelResolvePerCall(Section, 6, Frame, Transform.GetScale3D().X, KeyInterpolation, bOutSuccess);
+        AddKeyframeToDoubleChannelResolvePerCall(Section, 7, Frame, Transform.GetScale3D().Y, KeyInterpolation, bOutSuccess);
+        AddKeyframeToDoubleChannelResolvePerCall(Section, 8, Frame, Transform.GetScale3D().Z, KeyInterpolation, bOutSuccess);
+    }
+
+    //LLM tag every measured body allocates under, run with -llm to get the held bytes in the results.
+    const TCHAR* const MemoryTag{ TEXT("AnimationStreaming/Benchmark") };
+
+    //Bytes held under MemoryTag, INDEX_NONE when LLM is not running.
+    int64 GetTaggedBytes()
+    {
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+        if (FLowLevelMemTracker::IsEnabled())
+        {
+            FLowLevelMemTracker::Get().UpdateStatsPerFrame();
+            return FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, FName(MemoryTag), ELLMTagSet::None);
+        }
+#endif
+        return INDEX_NONE;
+    }
+
+    //Runs Body once inside a trace region and under MemoryTag. Returns the bytes Body left allocated,
+    //INDEX_NONE without -llm. Allocation counts and peaks of every thread are in the region of a
+    //-trace=default,memory capture in Unreal Insights.
+    template <typename BodyType>
+    int64 MeasureMemory(const FString& Region, BodyType&& Body)
+    {
+        const int64 StartBytes{ GetTaggedBytes() };
+
+        TRACE_BEGIN_REGION(*Region);
+        {
+            LLM_SCOPE_BYNAME(MemoryTag);
+            Body();
+        }
+        TRACE_END_REGION(*Region);
+
+        const int64 EndBytes{ GetTaggedBytes() };
+
+        return StartBytes != INDEX_NONE && EndBytes != INDEX_NONE ? EndBytes - StartBytes : INDEX_NONE;
+    }
+}
+
+UImportBenchmarkCommandlet::UImportBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+}
+
+int32 UImportBenchmarkCommandlet::Main(const FString& Params)
+{
+    TArray<int32> FrameCounts{ 1000, 100000, 1000000 };
+    TArray<int32> ControlCounts{ 1, 50, 300 };
+    ImportBenchmark::ParseIntList(Params, TEXT("frames="), FrameCounts);
+    ImportBenchmark::ParseIntList(Params, TEXT("controls="), ControlCounts);
+
+    FString SuitesValue{ TEXT("parse,bake,kernels,compression") };
+    FParse::Value(*Params, TEXT("suites="), SuitesValue);
+    TArray<FString> Suites;
+    SuitesValue.ParseIntoArray(Suites, TEXT(","));
+
+    //The full 1M x 300 capture would be tens of gigabytes of json, larger cases are skipped.
+    //Every skipped case is logged as a warning and written to the results as a "skipped" row.
+    int64 MaxTotalFrames{ 5000000 };
+    FParse::Value(*Params, TEXT("maxtotalframes="), MaxTotalFrames);
+    FParse::Value(*Params, TEXT("perkeylimit="), PerKeyLimit);
+
+    FString OutputDirectory{ FPaths::ProjectSavedDir() / TEXT("Benchmark") };
+    FParse::Value(*Params, TEXT("output="), OutputDirectory);
+    IFileManager::Get().MakeDirectory(*OutputDirectory, true);
+    const bool bKeepCaptures{ FParse::Param(*Params, TEXT("keepcaptures")) };
+
+    if (Suites.Contains(TEXT("kernels")))
+    {
+        RunKernelSuite(FMath::Max(FrameCounts));
+    }
+
+    if (Suites.Contains(TEXT("compression")))
+    {
+        //Ratios and errors do not depend on the control count, a few controls are enough.
+        constexpr int32 CompressionControls{ 8 };
+        for (const int32 Frames : FrameCounts)
+        {
+            if (static_cast<int64>(Frames) * CompressionControls > MaxTotalFrames)
+            {
+                SkipCase(TEXT("compression"), Frames, CompressionControls, MaxTotalFrames);
+                continue;
+            }
+            RunCompressionSuite(Frames, CompressionControls);
+        }
+    }
+
+    const bool bParse{ Suites.Contains(TEXT("parse")) };
+    const bool bBake{ Suites.Contains(TEXT("bake")) };
+    for (const int32 Frames : FrameCounts)
+    {
+        for (const int32 Controls : ControlCounts)
+        {
+            if (!bParse && !bBake)
+            {
+                break;
+            }
+
+            const FString Case{ ImportBenchmark::MakeCaseName(Frames, Controls) };
+            if (static_cast<int64>(Frames) * Controls > MaxTotalFrames)
+            {
+                SkipCase(bParse ? TEXT("parse") : TEXT("bake"), Frames, Controls, MaxTotalFrames);
+                continue;
+            }
+
+            TArray<uint8> Json;
+            AddResult(TEXT("setup"), Case, Frames, Controls, TEXT("generate"), ImportBenchmark::Time([&Json, Frames, Controls]()
+            {
+                FSyntheticCapture::WriteJson(Frames, Controls, ImportBenchmark::Seed, Json);
+            }), TEXT("s"));
+
+            const FString CapturePath{ OutputDirectory / FString::Printf(TEXT("capture_%s.json"), *Case) };
+            if (!FFileHelper::SaveArrayToFile(Json, *CapturePath))
+            {
+                UE_LOG(LogTemp, Error, TEXT("ImportBenchmark is failed: Failed to write '%s'"), *CapturePath);
+                return 1;
+            }
+            ImportBenchmark::DeleteCache(CapturePath);
+
+            if (bParse)
+            {
+                RunParseSuite(CapturePath, Json, Frames, Controls);
+            }
+
+            //The bake suite reads the capture back itself.
+            Json.Empty();
+            if (bBake)
+            {
+                RunBakeSuite(CapturePath, Frames, Controls);
+            }
+
+            if (!bKeepCaptures)
+            {
+                IFileManager::Get().Delete(*CapturePath);
+                ImportBenchmark::DeleteCache(CapturePath);
+            }
+            CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+        }
+    }
+
+    //Skipped cases are easy to miss in a long log, they are repeated at the end.
+    for (const FImportBenchmarkResult& Result : Results)
+    {
+        if (Result.Metric == TEXT("skipped"))
+        {
+            UE_LOG(LogAnimationStreaming, Warning, TEXT("Not measured: %s %s (%.0f frames in total), raise -maxtotalframes to run it"), *Result.Suite, *Result.Case, Result.Value);
+        }
+    }
+
+    return WriteResults(OutputDirectory) ? 0 : 1;
+}
+
+void UImportBenchmarkCommandlet::SkipCase(const FString& Suite, const int32 Frames, const int32 Controls, const int64 MaxTotalFrames)
+{
+    const FString Case{ ImportBenchmark::MakeCaseName(Frames, Controls) };
+    const int64 TotalFrames{ static_cast<int64>(Frames) * Controls };
+    UE_LOG(LogAnimationStreaming, Warning, TEXT("Skipping %s %s: %lld frames in total is above -maxtotalframes=%lld"), *Suite, *Case, static_cast<long long>(TotalFrames), static_cast<long long>(MaxTotalFrames));
+    AddResult(Suite, Case, Frames, Controls, TEXT("skipped"), static_cast<double>(TotalFrames), TEXT("frames"));
+}
+
+void UImportBenchmarkCommandlet::RunParseSuite(const FString& CapturePath, TArrayView<const uint8> Json, const int32 Frames, const int32 Controls)
+{
+    const FString Case{ ImportBenchmark::MakeCaseName(Frames, Controls) };
+    const double MegaBytes{ Json.Num() / (1024.0 * 1024.0) };
+    AddResult(TEXT("parse"), Case, Frames, Controls, TEXT("json_size"), MegaBytes, TEXT("MB"));
+
+    //Tokenizer alone, the bytes are already in memory.
+    {
+        TMap<FString, FKeyframeTrack> Parsed;
+        FString InfoMessage;
+        const double Seconds{ ImportBenchmark::Time([&Json, &Parsed, &InfoMessage]() { FKeyframeJsonParser::ParseAllControls(Json, Parsed, InfoMessage); }) };
+        AddResult(TEXT("parse"), Case, Frames, Controls, TEXT("parse_all_controls"), Seconds, TEXT("s"));
+        AddResult(TEXT("parse"), Case, Frames, Controls, TEXT("parse_all_controls_throughput"), MegaBytes / FMath::Max(Seconds, UE_DOUBLE_SMALL_NUMBER), TEXT("MB/s"));
+    }
+
+    //Memory the parse paths leave allocated, against the FJsonObject DOM the importer used to build.
+    //Every result is kept alive until the block ends so its size is what gets measured.
+    {
+        const auto AddMemory = [this, &Case, Frames, Controls](const FString& Metric, const int64 Bytes)
+        {
+            if (Bytes != INDEX_NONE)
+            {
+                AddResult(TEXT("parse"), Case, Frames, Controls, Metric + TEXT("_held"), Bytes / (1024.0 * 1024.0), TEXT("MB"));
+            }
+        };
+
+        //The DOM of a large capture takes many times its size in memory.
+        constexpr int64 MaxDomBytes{ 64 * 1024 * 1024 };
+        TSharedPtr<FJsonObject> Root;
+        if (Json.Num() <= MaxDomBytes)
+        {
+            AddMemory(TEXT("json_dom"), ImportBenchmark::MeasureMemory(TEXT("json_dom"), [&Json, &Root]()
+            {
+                const FString JsonString{ FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Json.GetData()), Json.Num()) };
+                FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JsonString), Root);
+            }));
+        }
+
+        TMap<FString, FKeyframeTrack> Parsed;
+        FString InfoMessage;
+        AddMemory(TEXT("parse_all_controls"), ImportBenchmark::MeasureMemory(TEXT("parse_all_controls"), [&Json, &Parsed, &InfoMessage]()
+        {
+            FKeyframeJsonParser::ParseAllControls(Json, Parsed, InfoMessage);
+        }));
+
+        const FString ControlName{ FSyntheticCapture::GetControlName(0) };
+        TArray<FKeyframes> SerialKeyframes;
+        TArray<FKeyframes> RangeKeyframes;
+        for (const int32 NumRanges : { 1, 0 })
+        {
+            const FString Metric{ NumRanges == 1 ? TEXT("parse_control_serial") : TEXT("parse_control_ranges") };
+            TArray<FKeyframes>& Keyframes{ NumRanges == 1 ? SerialKeyframes : RangeKeyframes };
+            AddMemory(Metric, ImportBenchmark::MeasureMemory(Metric, [&Json, &ControlName, &Keyframes, &InfoMessage, NumRanges]()
+            {
+                FKeyframeJsonParser::ParseControl(Json, ControlName, Keyframes, InfoMessage, NumRanges);
+            }));
+        }
+
+        if (const FKeyframeTrack* Track = Parsed.Find(ControlName))
+        {
+            FTransformChannelKeys ChannelKeys;
+            AddMemory(TEXT("build_channel_keys"), ImportBenchmark::MeasureMemory(TEXT("build_channel_keys"), [Track, &ChannelKeys]()
+            {
+                FSequencerImportSession::BuildChannelKeys(Track->Keyframes, FKeyframeTimeMapping(), 1, ChannelKeys);
+            }));
+        }
+    }
+
+    //One control split into ranges, throughput against the number of ranges parsed at once.
+    if (Controls == 1)
+    {
+        const FString ControlName{ FSyntheticCapture::GetControlName(0) };
+        const int32 MaxThreads{ FTaskGraphInterface::Get().GetNumWorkerThreads() + 1 };
+        double SerialSeconds{ 0.0 };
+        for (int32 Threads = 1; Threads <= MaxThreads; Threads = Threads < MaxThreads ? FMath::Min(Threads * 2, MaxThreads) : Threads + 1)
+        {
+            FKeyframeTrackSoA Track;
+            FString InfoMessage;
+            const double Seconds{ ImportBenchmark::Time([&Json, &ControlName, &Track, &InfoMessage, Threads]()
+            {
+                FKeyframeJsonParser::ParseControl(Json, ControlName, Track, InfoMessage, Threads);
+            }) };
+            if (Threads == 1)
+            {
+                SerialSeconds = Seconds;
+            }
+
+            const FString Metric{ FString::Printf(TEXT("parse_control_%d_threads"), Threads) };
+            AddResult(TEXT("parse"), Case, Frames, Controls, Metric + TEXT("_throughput"), MegaBytes / FMath::Max(Seconds, UE_DOUBLE_SMALL_NUMBER), TEXT("MB/s"));
+            AddResult(TEXT("parse"), Case, Frames, Controls, Metric + TEXT("_speedup"), SerialSeconds / FMath::Max(Seconds, UE_DOUBLE_SMALL_NUMBER), TEXT("x"));
+        }
+    }
+
+    //The same capture in the binary frame format, full and float16 records, decoded from memory.
+    {
+        TMap<FString, FKeyframeTrackSoA> Tracks;
+        for (int32 ControlIndex = 0; ControlIndex < Controls; ++ControlIndex)
+        {
+            Tracks.Add(FSyntheticCapture::GetControlName(ControlIndex), FSyntheticCapture::MakeTrack(Frames, ControlIndex, ImportBenchmark::Seed));
+        }
+
+        const FKeyframeBinarySource BinarySource;
+        for (const bool bFloat16 : { false, true })
+        {
+            const FString Format{ bFloat16 ? TEXT("binary_half") : TEXT("binary") };
+            TArray<uint8> Binary;
+            FKeyframeBinarySource::Write(Tracks, bFloat16, Binary);
+            AddResult(TEXT("parse"), Case, Frames, Controls, Format + TEXT("_size"), Binary.Num() / (1024.0 * 1024.0), TEXT("MB"));
+
+            TMap<FString, FKeyframeTrackSoA> Decoded;
+            FString InfoMessage;
+            AddResult(TEXT("parse"), Case, Frames, Controls, Format + TEXT("_load_all_controls"), ImportBenchmark::Time([&BinarySource, &Binary, &Decoded, &InfoMessage]()
+            {
+                BinarySource.LoadAllControls(Binary, Decoded, InfoMessage);
+            }), TEXT("s"));
+        }
+    }
+
+    //UJsonManager entry points: read, parse and sidecar write, then the sidecar hit.
+    bool bSuccess{ false };
+    FString InfoMessage;
+    ImportBenchmark::DeleteCache(CapturePath);
+    AddResult(TEXT("parse"), Case, Frames, Controls, TEXT("load_track_cold"), ImportBenchmark::Time([&CapturePath, &bSuccess, &InfoMessage]()
+    {
+        UJsonManager::LoadJsonToTrack(CapturePath, FSyntheticCapture::GetControlName(0), bSuccess, InfoMessage);
+    }), TEXT("s"));
+
+    ImportBenchmark::DeleteCache(CapturePath);
+    AddResult(TEXT("parse"), Case, Frames, Controls, TEXT("load_all_controls_cold"), ImportBenchmark::Time([&CapturePath, &bSuccess, &InfoMessage]()
+    {
+        UJsonManager::LoadAllControls(CapturePath, bSuccess, InfoMessage);
+    }), TEXT("s"));
+
+    AddResult(TEXT("parse"), Case, Frames, Controls, TEXT("load_all_controls_cached"), ImportBenchmark::Time([&CapturePath, &bSuccess, &InfoMessage]()
+    {
+        UJsonManager::LoadAllControls(CapturePath, bSuccess, InfoMessage);
+    }), TEXT("s"));
+}
+
+void UImportBenchmarkCommandlet::RunBakeSuite(const FString& CapturePath, const int32 Frames, const int32 Controls)
+{
+    const FString Case{ ImportBenchmark::MakeCaseName(Frames, Controls) };
+
+    bool bLoaded{ false };
+    FString InfoMessage;
+    const TMap<FString, FKeyframeTrack> Loaded{ UJsonManager::LoadAllControls(CapturePath, bLoaded, InfoMessage) };
+    if (!bLoaded)
+    {
+        UE_LOG(LogTemp, Error, TEXT("ImportBenchmark is failed: %s"), *InfoMessage);
+        return;
+    }
+
+    TArray<FKeyframeTrackSoA> Tracks;
+    Tracks.SetNum(Controls);
+    for (int32 ControlIndex = 0; ControlIndex < Controls; ++ControlIndex)
+    {
+        if (const FKeyframeTrack* Track = Loaded.Find(FSyntheticCapture::GetControlName(ControlIndex)))
+        {
+            Tracks[ControlIndex] = FKeyframeTrackSoA::FromKeyframes(Track->Keyframes);
+        }
+    }
+
+    //Batch path: sessions resolved once, keys built in parallel, one commit per control.
+    TArray<FGuid> Bindings;
+    ULevelSequence* Sequence{ FSyntheticCapture::MakeTransientSequence(Controls, Bindings) };
+
+    TArray<FSequencerImportSession> Sessions;
+    AddResult(TEXT("bake"), Case, Frames, Controls, TEXT("session_lookup"), ImportBenchmark::Time([&Sessions, &Bindings, Sequence]()
+    {
+        Sessions.Reserve(Bindings.Num());
+        for (const FGuid& Binding : Bindings)
+        {
+            bool bSuccess{ false };
+            Sessions.Emplace(Sequence, Binding, 0, bSuccess);
+        }
+    }), TEXT("s"));
+
+    TArray<FTransformChannelKeys> ChannelKeys;
+    ChannelKeys.SetNum(Controls);
+    AddResult(TEXT("bake"), Case, Frames, Controls, TEXT("build_keys"), ImportBenchmark::Time([&Sessions, &Tracks, &ChannelKeys]()
+    {
+        ParallelFor(Sessions.Num(), [&Sessions, &Tracks, &ChannelKeys](const int32 Index)
+        {
+            FSequencerImportSession::BuildChannelKeys(Tracks[Index], Sessions[Index].GetTimeMapping(), 0, ChannelKeys[Index]);
+        });
+    }), TEXT("s"));
+
+    FKeyframeImportReport Report;
+    AddResult(TEXT("bake"), Case, Frames, Controls, TEXT("commit"), ImportBenchmark::Time([&Sessions, &ChannelKeys, &Report]()
+    {
+        for (int32 Index = 0; Index < Sessions.Num(); ++Index)
+        {
+            bool bSuccess{ false };
+            Sessions[Index].CommitChannelKeys(ChannelKeys[Index], bSuccess, Report);
+        }
+    }), TEXT("s"));
+    AddResult(TEXT("bake"), Case, Frames, Controls, TEXT("modify"), Report.ModifySeconds, TEXT("s"));
+    AddResult(TEXT("bake"), Case, Frames, Controls, TEXT("keys_written"), Report.KeysWritten, TEXT("keys"));
+
+    //Delta re-import of a one frame edit: the first pass records the block hashes, the second rewrites one block.
+    if (Sessions.Num() > 0 && Tracks[0].Num() > 0)
+    {
+        bool bSuccess{ false };
+        FTransformChannelKeys DeltaKeys;
+        FKeyframeImportReport DeltaReport;
+        FSequencerImportSession::BuildChannelKeys(Tracks[0], Sessions[0].GetTimeMapping(), 0, DeltaKeys);
+        FKeyframeDeltaImporter::Reimport(Sessions[0], DeltaKeys, bSuccess, DeltaReport);
+
+        Tracks[0].TranslationX[Tracks[0].Num() / 2] += 1.0f;
+        FSequencerImportSession::BuildChannelKeys(Tracks[0], Sessions[0].GetTimeMapping(), 0, DeltaKeys);
+        DeltaReport = FKeyframeImportReport();
+        AddResult(TEXT("bake"), Case, Frames, 1, TEXT("delta_reimport"), ImportBenchmark::Time([&Sessions, &DeltaKeys, &DeltaReport, &bSuccess]()
+        {
+            FKeyframeDeltaImporter::Reimport(Sessions[0], DeltaKeys, bSuccess, DeltaReport);
+        }), TEXT("s"));
+        AddResult(TEXT("bake"), Case, Frames, 1, TEXT("delta_changed_blocks"), DeltaReport.ChangedBlocks, TEXT("blocks"));
+    }
+    Sequence->MarkAsGarbage();
+
+    //Shot variant fan-out: one take into FanOutSequences sequences in one transaction against a single import.
+    if (Controls > 0 && Tracks[0].Num() > 0)
+    {
+        constexpr int32 FanOutSequences{ 8 };
+        TArray<ULevelSequence*> FanOutTargets;
+        TArray<FSequencerImportSession> FanOutSessions;
+        //The last two targets are the warm-up and the single import baseline, so every timed sequence starts empty.
+        for (int32 Index = 0; Index < FanOutSequences + 2; ++Index)
+        {
+            TArray<FGuid> FanOutBindings;
+            FanOutTargets.Add(FSyntheticCapture::MakeTransientSequence(1, FanOutBindings));
+            bool bSuccess{ false };
+            FanOutSessions.Emplace(FanOutTargets.Last(), FanOutBindings[0], 0, bSuccess);
+        }
+
+        //Untimed, so neither timed run pays for the first transaction and the cold caches.
+        {
+            TArray<FSequencerImportSession> WarmUpSession{ FanOutSessions.Pop() };
+            FKeyframeImportReport WarmUpReport;
+            bool bSuccess{ false };
+            FSequencerImportSession::CommitTrackToSessions(WarmUpSession, Tracks[0], 0, bSuccess, WarmUpReport);
+        }
+
+        TArray<FSequencerImportSession> SingleSession{ FanOutSessions.Pop() };
+        FKeyframeImportReport SingleReport;
+        const double SingleSeconds{ ImportBenchmark::Time([&SingleSession, &Tracks, &SingleReport]()
+        {
+            bool bSuccess{ false };
+            FSequencerImportSession::CommitTrackToSessions(SingleSession, Tracks[0], 0, bSuccess, SingleReport);
+        }) };
+
+        FKeyframeImportReport FanOutReport;
+        const double FanOutSeconds{ ImportBenchmark::Time([&FanOutSessions, &Tracks, &FanOutReport]()
+        {
+            bool bSuccess{ false };
+            FSequencerImportSession::CommitTrackToSessions(FanOutSessions, Tracks[0], 0, bSuccess, FanOutReport);
+        }) };
+
+        AddResult(TEXT("bake"), Case, Frames, 1, TEXT("single_sequence_import"), SingleSeconds, TEXT("s"));
+        AddResult(TEXT("bake"), Case, Frames, FanOutSequences, TEXT("fan_out_import"), FanOutSeconds, TEXT("s"));
+        AddResult(TEXT("bake"), Case, Frames, FanOutSequences, TEXT("fan_out_cost_ratio"), FanOutSeconds / FMath::Max(SingleSeconds, UE_DOUBLE_SMALL_NUMBER), TEXT("x"));
+
+        for (ULevelSequence* Target : FanOutTargets)
+        {
+            Target->MarkAsGarbage();
+        }
+    }
+
+    //Per-key writes, every key is a sorted insert with its own tangent update. The baseline resolves the sequence,
+    //binding, track and section for every key as the manager did before sessions, the manager case goes through
+    //the current USequencerManager::AddTransformKeyframe and the session case resolves once per control.
+    if (static_cast<int64>(Frames) * Controls > PerKeyLimit)
+    {
+        return;
+    }
+
+    UWorld* PerKeyWorld{ UWorld::CreateWorld(EWorldType::Game, false) };
+    TArray<AActor*> PerKeyActors;
+    for (int32 Index = 0; Index < Controls; ++Index)
+    {
+        PerKeyActors.Add(PerKeyWorld->SpawnActor<AActor>());
+    }
+
+    //Each case keys into its own empty sequence.
+    const TCHAR* PerKeyCases[]{ TEXT("per_key_insert_baseline"), TEXT("per_key_insert_manager"), TEXT("per_key_insert_session") };
+    for (int32 CaseIndex = 0; CaseIndex < UE_ARRAY_COUNT(PerKeyCases); ++CaseIndex)
+    {
+        ULevelSequence* PerKeySequence{ FSyntheticCapture::MakeTransientSequence(0, Bindings) };
+        const FString PerKeyPath{ PerKeySequence->GetPathName() };
+
+        bool bBound{ true };
+        for (AActor* Actor : PerKeyActors)
+        {
+            USequencerManager::AddActorToLevelSequence(Actor, PerKeyPath, bBound);
+            USequencerManager::AddTransformTrackToActor(Actor, PerKeyPath, bBound);
+            USequencerManager::AddTransformSectionToActor(Actor, PerKeyPath, 0, Frames, EMovieSceneBlendType::Absolute, bBound);
+        }
+
+        if (!bBound)
+        {
+            UE_LOG(LogTemp, Error, TEXT("ImportBenchmark is failed: %s bindings are not valid"), PerKeyCases[CaseIndex]);
+            PerKeySequence->MarkAsGarbage();
+            continue;
+        }
+
+        int64 PerKeyKeys{ 0 };
+        const double PerKeySeconds{ ImportBenchmark::Time([&Tracks, &PerKeyActors, &PerKeyPath, &PerKeyKeys, CaseIndex]()
+        {
+            for (int32 Index = 0; Index < PerKeyActors.Num(); ++Index)
+            {
+                bool bSuccess{ true };
+                FSequencerImportSession Session;
+                if (CaseIndex == 2)
+                {
+                    Session = FSequencerImportSession(PerKeyActors[Index], PerKeyPath, 0, bSuccess);
+                }
+
+                for (int32 Frame = 0; Frame < Tracks[Index].Num(); ++Frame)
+                {
+                    const FTransform Transform{ Tracks[Index].GetTransform(Frame) };
+                    bSuccess = true;
+                    if (CaseIndex == 0)
+                    {
+                        ImportBenchmark::AddTransformKeyframeResolvePerCall(PerKeyActors[Index], PerKeyPath, 0, Tracks[Index].Frames[Frame], Transform, 0, bSuccess);
+                    }
+                    else if (CaseIndex == 1)
+                    {
+                        USequencerManager::AddTransformKeyframe(PerKeyActors[Index], PerKeyPath, 0, Tracks[Index].Frames[Frame], Transform, 0, bSuccess);
+                    }
+                    else
+                    {
+                        Session.AddTransformKeyframe(Tracks[Index].Frames[Frame], Transform, 0, bSuccess);
+                    }
+                    PerKeyKeys += bSuccess ? FSequencerImportSession::NumTransformChannels : 0;
+                }
+            }
+        }) };
+        AddResult(TEXT("bake"), Case, Frames, Controls, PerKeyCases[CaseIndex], PerKeySeconds, TEXT("s"));
+        AddResult(TEXT("bake"), Case, Frames, Controls, FString::Printf(TEXT("%s_rate"), PerKeyCases[CaseIndex]), PerKeyKeys / FMath::Max(PerKeySeconds, UE_DOUBLE_SMALL_NUMBER), TEXT("keys/s"));
+
+        PerKeySequence->MarkAsGarbage();
+    }
+
+    PerKeyWorld->DestroyWorld(false);
+}
+
+void UImportBenchmarkCommandlet::RunKernelSuite(const int32 Frames)
+{
+    const FString Case{ FString::Printf(TEXT("%d_frames"), Frames) };
+    const FKeyframeTrackSoA Track{ FSyntheticCapture::MakeTrack(Frames, 0, ImportBenchmark::Seed) };
+
+    TArray<float> ScalarQuat[4];
+    TArray<float> BatchQuat[4];
+    for (int Component = 0; Component < 4; ++Component)
+    {
+        ScalarQuat[Component].SetNumUninitialized(Frames);
+        BatchQuat[Component].SetNumUninitialized(Frames);
+    }
+
+    //Degrees to quaternion.
+    AddResult(TEXT("kernels"), Case, Frames, 1, TEXT("euler_to_quat_scalar"), ImportBenchmark::Time([&Track, &ScalarQuat]()
+    {
+        for (int32 Index = 0; Index < Track.Num(); ++Index)
+        {
+            const FQuat4f Quat{ FRotator3f(Track.Pitch[Index], Track.Yaw[Index], Track.Roll[Index]).Quaternion() };
+            ScalarQuat[0][Index] = Quat.X;
+            ScalarQuat[1][Index] = Quat.Y;
+            ScalarQuat[2][Index] = Quat.Z;
+            ScalarQuat[3][Index] = Quat.W;
+        }
+    }), TEXT("s"));
+    AddResult(TEXT("kernels"), Case, Frames, 1, TEXT("euler_to_quat_batch"), ImportBenchmark::Time([&Track, &BatchQuat]()
+    {
+        FKeyframeVectorMath::EulerToQuat(Track.Roll.GetData(), Track.Pitch.GetData(), Track.Yaw.GetData(), BatchQuat[0].GetData(), BatchQuat[1].GetData(), BatchQuat[2].GetData(), BatchQuat[3].GetData(), Track.Num());
+    }), TEXT("s"));
+
+    float MaxQuatError{ 0.0f };
+    for (int Component = 0; Component < 4; ++Component)
+    {
+        for (int32 Index = 0; Index < Frames; ++Index)
+        {
+            MaxQuatError = FMath::Max(MaxQuatError, FMath::Abs(ScalarQuat[Component][Index] - BatchQuat[Component][Index]));
+        }
+    }
+    AddResult(TEXT("kernels"), Case, Frames, 1, TEXT("euler_to_quat_max_error"), MaxQuatError, TEXT("abs"));
+
+    //Quaternion back to degrees.
+    TArray<float> ScalarEuler[3];
+    TArray<float> BatchEuler[3];
+    for (int Axis = 0; Axis < 3; ++Axis)
+    {
+        ScalarEuler[Axis].SetNumUninitialized(Frames);
+        BatchEuler[Axis].SetNumUninitialized(Frames);
+    }
+
+    AddResult(TEXT("kernels"), Case, Frames, 1, TEXT("quat_to_euler_scalar"), ImportBenchmark::Time([&ScalarQuat, &ScalarEuler, Frames]()
+    {
+        for (int32 Index = 0; Index < Frames; ++Index)
+        {
+            const FRotator3f Rotation{ FQuat4f(ScalarQuat[0][Index], ScalarQuat[1][Index], ScalarQuat[2][Index], ScalarQuat[3][Index]).Rotator() };
+            ScalarEuler[0][Index] = Rotation.Roll;
+            ScalarEuler[1][Index] = Rotation.Pitch;
+            ScalarEuler[2][Index] = Rotation.Yaw;
+        }
+    }), TEXT("s"));
+    AddResult(TEXT("kernels"), Case, Frames, 1, TEXT("quat_to_euler_batch"), ImportBenchmark::Time([&ScalarQuat, &BatchEuler, Frames]()
+    {
+        FKeyframeVectorMath::QuatToEuler(ScalarQuat[0].GetData(), ScalarQuat[1].GetData(), ScalarQuat[2].GetData(), ScalarQuat[3].GetData(), BatchEuler[0].GetData(), BatchEuler[1].GetData(), BatchEuler[2].GetData(), Frames);
+    }), TEXT("s"));
+
+    float MaxEulerError{ 0.0f };
+    for (int Axis = 0; Axis < 3; ++Axis)
+    {
+        for (int32 Index = 0; Index < Frames; ++Index)
+        {
+            MaxEulerError = FMath::Max(MaxEulerError, FMath::Abs(FRotator3f::NormalizeAxis(ScalarEuler[Axis][Index] - BatchEuler[Axis][Index])));
+        }
+    }
+    AddResult(TEXT("kernels"), Case, Frames, 1, TEXT("quat_to_euler_max_error"), MaxEulerError, TEXT("deg"));
+
+    //Range-checked narrowing of the nine parsed channels.
+    TArray<double> Wide;
+    Wide.SetNumUninitialized(Frames * FKeyframeTrackSoA::NumChannels);
+    for (int ChannelIndex = 0; ChannelIndex < FKeyframeTrackSoA::NumChannels; ++ChannelIndex)
+    {
+        for (int32 Index = 0; Index < Frames; ++Index)
+        {
+            Wide[ChannelIndex * Frames + Index] = Track.GetChannel(ChannelIndex)[Index];
+        }
+    }
+
+    TArray<float> Narrow;
+    Narrow.SetNumUninitialized(Wide.Num());
+    AddResult(TEXT("kernels"), Case, Frames, 1, TEXT("narrow_scalar"), ImportBenchmark::Time([&Wide, &Narrow]()
+    {
+        for (int32 Index = 0; Index < Wide.Num(); ++Index)
+        {
+            const double Value{ Wide[Index] };
+            Narrow[Index] = Value >= -DBL_MAX && Value <= DBL_MAX ? static_cast<float>(Value) : 0.0f;
+        }
+    }), TEXT("s"));
+    AddResult(TEXT("kernels"), Case, Frames, 1, TEXT("narrow_batch"), ImportBenchmark::Time([&Wide, &Narrow]()
+    {
+        FKeyframeVectorMath::NarrowToFloat(Wide.GetData(), Narrow.GetData(), Wide.Num());
+    }), TEXT("s"));
+
+    //Frame ordering of a shuffled take, comparison sort against the radix frame index.
+    TArray<int32> Shuffled{ Track.Frames };
+    FRandomStream Random{ ImportBenchmark::Seed };
+    for (int32 Index = Shuffled.Num() - 1; Index > 0; --Index)
+    {
+        Shuffled.Swap(Index, Random.RandRange(0, Index));
+    }
+
+    AddResult(TEXT("kernels"), Case, Frames, 1, TEXT("frame_order_stable_sort"), ImportBenchmark::Time([&Shuffled]()
+    {
+        TArray<int32> Order;
+        Order.SetNumUninitialized(Shuffled.Num());
+        for (int32 Index = 0; Index < Shuffled.Num(); ++Index)
+        {
+            Order[Index] = Index;
+        }
+        Algo::StableSort(Order, [&Shuffled](const int32 A, const int32 B) { return Shuffled[A] < Shuffled[B]; });
+    }), TEXT("s"));
+    AddResult(TEXT("kernels"), Case, Frames, 1, TEXT("frame_order_radix_index"), ImportBenchmark::Time([&Shuffled]()
+    {
+        const FKeyframeFrameIndex FrameIndex{ Shuffled };
+    }), TEXT("s"));
+
+    //Runtime playback of one tick for a crowd of actors at half-frame steps, hinted against searching every key.
+    constexpr int32 PlaybackActors{ 256 };
+    const int32 PlaybackTicks{ FMath::Min(Frames * 2, 4096) };
+    FKeyframePlaybackTrack PlaybackTrack;
+    PlaybackTrack.Build(Track);
+
+    for (const int KeyInterpolation : { 1, 0 })
+    {
+        for (const bool bHinted : { true, false })
+        {
+            TArray<int32> Hints;
+            Hints.SetNumZeroed(PlaybackActors);
+            TArray<FTransform> Pose;
+            Pose.SetNumUninitialized(PlaybackActors);
+            const double Seconds{ ImportBenchmark::Time([&PlaybackTrack, &Hints, &Pose, PlaybackTicks, KeyInterpolation, bHinted]()
+            {
+                for (int32 Tick = 0; Tick < PlaybackTicks; ++Tick)
+                {
+                    const double Frame{ PlaybackTrack.GetFirstFrame() + Tick * 0.5 };
+                    ParallelFor(TEXT("KeyframePlayback.Benchmark"), PlaybackActors, 32, [&PlaybackTrack, &Hints, &Pose, Frame, KeyInterpolation, bHinted](const int32 Index)
+                    {
+                        if (!bHinted)
+                        {
+                            Hints[Index] = 0;
+                        }
+                        Pose[Index] = PlaybackTrack.Evaluate(Frame + Index, KeyInterpolation, Hints[Index]);
+                    });
+                }
+            }) };
+
+            const FString Metric{ FString::Printf(TEXT("playback_tick_%s_%s"), KeyInterpolation == 0 ? TEXT("cubic") : TEXT("linear"), bHinted ? TEXT("hinted") : TEXT("search")) };
+            AddResult(TEXT("kernels"), Case, Frames, PlaybackActors, Metric, Seconds * 1.0e6 / FMath::Max(PlaybackTicks, 1), TEXT("us"));
+        }
+    }
+}
+
+void UImportBenchmarkCommandlet::RunCompressionSuite(const int32 Frames, const int32 Controls)
+{
+    const FString Case{ ImportBenchmark::MakeCaseName(Frames, Controls) };
+    const FKeyframeCompressionSettings Settings;
+
+    TArray<FKeyframeTrackSoA> Tracks;
+    TArray<TArray<FKeyframes>> Keyframes;
+    Tracks.Reserve(Controls);
+    Keyframes.SetNum(Controls);
+    int64 KeyframeBytes{ 0 };
+    int64 SoABytes{ 0 };
+    for (int32 ControlIndex = 0; ControlIndex < Controls; ++ControlIndex)
+    {
+        Tracks.Add(FSyntheticCapture::MakeTrack(Frames, ControlIndex, ImportBenchmark::Seed));
+        Tracks.Last().ToKeyframes(Keyframes[ControlIndex]);
+        KeyframeBytes += Keyframes[ControlIndex].GetAllocatedSize();
+        SoABytes += Tracks.Last().Frames.GetAllocatedSize() * (FKeyframeTrackSoA::NumChannels + 1);
+    }
+
+    TArray<FKeyframeCompressedTrack> Compressed;
+    Compressed.SetNum(Controls);
+    AddResult(TEXT("compression"), Case, Frames, Controls, TEXT("compress"), ImportBenchmark::Time([&Tracks, &Compressed, &Settings]()
+    {
+        ParallelFor(Tracks.Num(), [&Tracks, &Compressed, &Settings](const int32 Index)
+        {
+            Compressed[Index].Compress(Tracks[Index], Settings);
+        });
+    }), TEXT("s"));
+
+    int64 CompressedBytes{ 0 };
+    for (const FKeyframeCompressedTrack& Track : Compressed)
+    {
+        CompressedBytes += Track.GetAllocatedSize();
+    }
+
+    TArray<TArray<FKeyframes>> Decompressed;
+    Decompressed.SetNum(Controls);
+    AddResult(TEXT("compression"), Case, Frames, Controls, TEXT("decompress"), ImportBenchmark::Time([&Compressed, &Decompressed]()
+    {
+        for (int32 Index = 0; Index < Compressed.Num(); ++Index)
+        {
+            Compressed[Index].Decompress(Decompressed[Index]);
+        }
+    }), TEXT("s"));
+
+    //Random blocks, the access pattern of scrubbing through a review library.
+    constexpr int32 BlockReads{ 4096 };
+    FRandomStream Random{ ImportBenchmark::Seed };
+    TArray<FKeyframes> Block;
+    const double BlockSeconds{ ImportBenchmark::Time([&Compressed, &Random, &Block]()
+    {
+        for (int32 Read = 0; Read < BlockReads; ++Read)
+        {
+            const FKeyframeCompressedTrack& Track{ Compressed[Random.RandRange(0, Compressed.Num() - 1)] };
+            Track.DecompressBlock(Random.RandRange(0, FMath::Max(Track.GetNumBlocks() - 1, 0)), Block);
+        }
+    }) };
+    AddResult(TEXT("compression"), Case, Frames, Controls, TEXT("decompress_block"), BlockSeconds * 1.0e6 / BlockReads, TEXT("us"));
+
+    //Errors against the parsed track, the synthetic frames are contiguous and unique.
+    double MaxTranslationError{ 0.0 };
+    double MaxRotationError{ 0.0 };
+    double MaxScaleError{ 0.0 };
+    for (int32 ControlIndex = 0; ControlIndex < Controls; ++ControlIndex)
+    {
+        for (int32 Index = 0; Index < Frames; ++Index)
+        {
+            const FTransform Expected{ Tracks[ControlIndex].GetTransform(Index) };
+            const FTransform& Actual{ Decompressed[ControlIndex][Index].Coordinates };
+            const FVector TranslationDelta{ (Expected.GetLocation() - Actual.GetLocation()).GetAbs() };
+            const FVector ScaleDelta{ (Expected.GetScale3D() - Actual.GetScale3D()).GetAbs() };
+            MaxTranslationError = FMath::Max(MaxTranslationError, TranslationDelta.GetMax());
+            MaxScaleError = FMath::Max(MaxScaleError, ScaleDelta.GetMax());
+            MaxRotationError = FMath::Max(MaxRotationError, FMath::RadiansToDegrees(Expected.GetRotation().AngularDistance(Actual.GetRotation())));
+        }
+    }
+
+    const bool bWithinTolerance{ MaxTranslationError <= Settings.TranslationTolerance && MaxRotationError <= Settings.RotationTolerance && MaxScaleError <= Settings.ScaleTolerance };
+    if (!bWithinTolerance)
+    {
+        UE_LOG(LogAnimationStreaming, Warning, TEXT("ImportBenchmark: %s compression error is above the tolerance"), *Case);
+    }
+
+    AddResult(TEXT("compression"), Case, Frames, Controls, TEXT("keyframes_bytes"), KeyframeBytes, TEXT("bytes"));
+    AddResult(TEXT("compression"), Case, Frames, Controls, TEXT("soa_bytes"), SoABytes, TEXT("bytes"));
+    AddResult(TEXT("compression"), Case, Frames, Controls, TEXT("compressed_bytes"), CompressedBytes, TEXT("bytes"));
+    AddResult(TEXT("compression"), Case, Frames, Controls, TEXT("bits_per_frame"), Compressed.Num() > 0 ? Compressed[0].GetBitsPerFrame() : 0, TEXT("bits"));
+    AddResult(TEXT("compression"), Case, Frames, Controls, TEXT("ratio_vs_keyframes"), static_cast<double>(KeyframeBytes) / FMath::Max<int64>(CompressedBytes, 1), TEXT("x"));
+    AddResult(TEXT("compression"), Case, Frames, Controls, TEXT("ratio_vs_soa"), static_cast<double>(SoABytes) / FMath::Max<int64>(CompressedBytes, 1), TEXT("x"));
+    AddResult(TEXT("compression"), Case, Frames, Controls, TEXT("max_translation_error"), MaxTranslationError, TEXT("cm"));
+    AddResult(TEXT("compression"), Case, Frames, Controls, TEXT("max_rotation_error"), MaxRotationError, TEXT("deg"));
+    AddResult(TEXT("compression"), Case, Frames, Controls, TEXT("max_scale_error"), MaxScaleError, TEXT("abs"));
+    AddResult(TEXT("compression"), Case, Frames, Controls, TEXT("within_tolerance"), bWithinTolerance ? 1.0 : 0.0, TEXT("bool"));
+}
+
+void UImportBenchmarkCommandlet::AddResult(const FString& Suite, const FString& Case, const int32 Frames, const int32 Controls, const FString& Metric, const double Value, const FString& Unit)
+{
+    UE_LOG(LogAnimationStreaming, Display, TEXT("%s %s %s = %f %s"), *Suite, *Case, *Metric, Value, *Unit);
+    Results.Add({ Suite, Case, Frames, Controls, Metric, Value, Unit });
+}
+
+bool UImportBenchmarkCommandlet::WriteResults(const FString& OutputDirectory) const
+{
+    FString Csv{ TEXT("suite,case,frames,controls,metric,value,unit\n") };
+    TArray<TSharedPtr<FJsonValue>> JsonResults;
+    for (const FImportBenchmarkResult& Result : Results)
+    {
+        Csv += FString::Printf(TEXT("%s,%s,%d,%d,%s,%.9g,%s\n"), *Result.Suite, *Result.Case, Result.Frames, Result.Controls, *Result.Metric, Result.Value, *Result.Unit);
+
+        TSharedRef<FJsonObject> JsonResult{ MakeShared<FJsonObject>() };
+        JsonResult->SetStringField(TEXT("suite"), Result.Suite);
+        JsonResult->SetStringField(TEXT("case"), Result.Case);
+        JsonResult->SetNumberField(TEXT("frames"), Result.Frames);
+        JsonResult->SetNumberField(TEXT("controls"), Result.Controls);
+        JsonResult->SetStringField(TEXT("metric"), Result.Metric);
+        JsonResult->SetNumberField(TEXT("value"), Result.Value);
+        JsonResult->SetStringField(TEXT("unit"), Result.Unit);
+        JsonResults.Add(MakeShared<FJsonValueObject>(JsonResult));
+    }
+
+    TSharedRef<FJsonObject> Root{ MakeShared<FJsonObject>() };
+    Root->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+    Root->SetArrayField(TEXT("results"), JsonResults);
+
+    FString Json;
+    FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&Json));
+
+    const FString CsvPath{ OutputDirectory / TEXT("results.csv") };
+    const FString JsonPath{ OutputDirectory / TEXT("results.json") };
+    if (!FFileHelper::SaveStringToFile(Csv, *CsvPath) || !FFileHelper::SaveStringToFile(Json, *JsonPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("ImportBenchmark is failed: Failed to write results to '%s'"), *OutputDirectory);
+        return false;
+    }
+
+    UE_LOG(LogAnimationStreaming, Display, TEXT("Wrote %d results to '%s'"), Results.Num(), *CsvPath);
+    return true;
+}
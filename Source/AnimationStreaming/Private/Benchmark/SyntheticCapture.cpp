@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Benchmark/SyntheticCapture.h"
+
+#include "Runtime/LevelSequence/Public/LevelSequence.h"
+#include "MovieScene.h"
+#include "Tracks/MovieScene3DTransformTrack.h"
+
+#include "GameFramework/Actor.h"
+#include "Math/RandomStream.h"
+#include "UObject/Package.h"
+
+
+namespace SyntheticCapture
+{
+    //Rough size of one frame entry, used to reserve the output once.
+    constexpr int64 BytesPerFrame{ 240 };
+
+    void Append(TArray<uint8>& Out, const ANSICHAR* Text, const int32 Length)
+    {
+        Out.Append(reinterpret_cast<const uint8*>(Text), Length);
+    }
+
+    void AppendVector(TArray<uint8>& Out, const ANSICHAR* Name, const float X, const float Y, const float Z)
+    {
+        ANSICHAR Buffer[192];
+        const int32 Length{ FCStringAnsi::Snprintf(Buffer, UE_ARRAY_COUNT(Buffer), "\"%s\": {\"x\": %.5f, \"y\": %.5f, \"z\": %.5f}", Name, X, Y, Z) };
+        Append(Out, Buffer, Length);
+    }
+}
+
+FString FSyntheticCapture::GetControlName(const int32 ControlIndex)
+{
+    return ControlIndex == 0 ? FString(TEXT("global_ctrl")) : FString::Printf(TEXT("ctrl_%d"), ControlIndex);
+}
+
+FKeyframeTrackSoA FSyntheticCapture::MakeTrack(const int32 NumFrames, const int32 ControlIndex, const int32 Seed)
+{
+    FRandomStream Random{ Seed + ControlIndex * 7919 };
+    const float Phase{ static_cast<float>(ControlIndex) * 0.37f };
+
+    FKeyframeTrackSoA Track;
+    Track.Reserve(NumFrames);
+    for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        const float Time{ static_cast<float>(Frame) / 30.0f };
+        const float Noise{ Random.FRandRange(-0.01f, 0.01f) };
+
+        const float Translation[3]{ 100.0f * FMath::Sin(Time * 0.7f + Phase) + Noise, 50.0f * FMath::Cos(Time * 0.3f + Phase), 10.0f * FMath::Sin(Time * 2.1f) };
+        //Yaw keeps turning so the captures cross the +-180 seam.
+        const float Rotation[3]{ 15.0f * FMath::Sin(Time + Phase), 30.0f * FMath::Cos(Time * 0.5f), FRotator::NormalizeAxis(Time * 45.0f + Phase * 100.0f) };
+        const float Scale[3]{ 1.0f, 1.0f, 1.0f + 0.001f * FMath::Sin(Time) };
+        Track.Add(Frame, Translation, Rotation, Scale);
+    }
+
+    return Track;
+}
+
+void FSyntheticCapture::WriteJson(const int32 NumFrames, const int32 NumControls, const int32 Seed, TArray<uint8>& OutJson)
+{
+    OutJson.Reset(SyntheticCapture::BytesPerFrame * NumFrames * NumControls + 64);
+    SyntheticCapture::Append(OutJson, "{\n", 2);
+
+    ANSICHAR Buffer[64];
+    for (int32 ControlIndex = 0; ControlIndex < NumControls; ++ControlIndex)
+    {
+        const FKeyframeTrackSoA Track{ MakeTrack(NumFrames, ControlIndex, Seed) };
+        const FTCHARToUTF8 ControlName{ *GetControlName(ControlIndex) };
+
+        SyntheticCapture::Append(OutJson, "\"", 1);
+        SyntheticCapture::Append(OutJson, ControlName.Get(), ControlName.Length());
+        SyntheticCapture::Append(OutJson, "\": {\n", 5);
+
+        for (int32 Index = 0; Index < Track.Num(); ++Index)
+        {
+            const int32 Length{ FCStringAnsi::Snprintf(Buffer, UE_ARRAY_COUNT(Buffer), "%s\"%d\": {", Index > 0 ? ",\n" : "", Track.Frames[Index]) };
+            SyntheticCapture::Append(OutJson, Buffer, Length);
+            //Json rotation is x = roll, y = pitch, z = yaw.
+            SyntheticCapture::AppendVector(OutJson, "rotation", Track.Roll[Index], Track.Pitch[Index], Track.Yaw[Index]);
+            SyntheticCapture::Append(OutJson, ", ", 2);
+            SyntheticCapture::AppendVector(OutJson, "translation", Track.TranslationX[Index], Track.TranslationY[Index], Track.TranslationZ[Index]);
+            SyntheticCapture::Append(OutJson, ", ", 2);
+            SyntheticCapture::AppendVector(OutJson, "scale", Track.ScaleX[Index], Track.ScaleY[Index], Track.ScaleZ[Index]);
+            SyntheticCapture::Append(OutJson, "}", 1);
+        }
+
+        SyntheticCapture::Append(OutJson, ControlIndex + 1 < NumControls ? "\n},\n" : "\n}\n", ControlIndex + 1 < NumControls ? 4 : 3);
+    }
+
+    SyntheticCapture::Append(OutJson, "}\n", 2);
+}
+
+ULevelSequence* FSyntheticCapture::MakeTransientSequence(const int32 NumBindings, TArray<FGuid>& OutBindings)
+{
+    ULevelSequence* Sequence{ NewObject<ULevelSequence>(GetTransientPackage(), NAME_None, RF_Transient) };
+    Sequence->Initialize();
+
+    UMovieScene* MovieScene{ Sequence->GetMovieScene() };
+    MovieScene->SetDisplayRate(FFrameRate(30, 1));
+
+    OutBindings.Reset(NumBindings);
+    for (int32 Index = 0; Index < NumBindings; ++Index)
+    {
+        const FGuid Binding{ MovieScene->AddPossessable(FString::Printf(TEXT("Control_%d"), Index), AActor::StaticClass()) };
+        UMovieScene3DTransformTrack* Track{ MovieScene->AddTrack<UMovieScene3DTransformTrack>(Binding) };
+        UMovieSceneSection* Section{ Track->CreateNewSection() };
+        Section->SetRange(TRange<FFrameNumber>::All());
+        Track->AddSection(*Section);
+        OutBindings.Add(Binding);
+    }
+
+    return Sequence;
+}
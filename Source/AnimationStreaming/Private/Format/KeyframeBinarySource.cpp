@@ -0,0 +1,254 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Format/KeyframeBinarySource.h"
+
+#include "Algo/StableSort.h"
+#include "Async/ParallelFor.h"
+#include "AnimationStreaming.h"
+
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "FKeyframeBinarySource reads records in place and expects a little-endian platform");
+
+namespace KeyframeBinarySource
+{
+    constexpr int64 Align(const int64 Value)
+    {
+        return (Value + 3) & ~int64(3);
+    }
+
+    template <typename Type>
+    void Append(TArray<uint8>& OutBytes, const Type& Value)
+    {
+        OutBytes.Append(reinterpret_cast<const uint8*>(&Value), sizeof(Type));
+    }
+}
+
+FName FKeyframeBinarySource::GetFormatName() const
+{
+    return TEXT("Binary");
+}
+
+bool FKeyframeBinarySource::MatchesHeader(TArrayView<const uint8> Head) const
+{
+    uint32 Magic{ 0 };
+    if (Head.Num() < static_cast<int32>(sizeof(Magic)))
+    {
+        return false;
+    }
+    FMemory::Memcpy(&Magic, Head.GetData(), sizeof(Magic));
+
+    return Magic == FKeyframeBinaryHeader::ExpectedMagic;
+}
+
+bool FKeyframeBinarySource::MatchesExtension(const FString& Extension) const
+{
+    return Extension == TEXT("kfb");
+}
+
+bool FKeyframeBinarySource::LoadControl(TArrayView<const uint8> Bytes, const FString& ControlName, FKeyframeTrackSoA& OutTrack, FString& OutInfoMessage) const
+{
+    bool bFloat16{ false };
+    TArray<FControlRange> Controls;
+    if (!ReadControlTable(Bytes, bFloat16, Controls, OutInfoMessage))
+    {
+        return false;
+    }
+
+    const FControlRange* Control{ Controls.FindByPredicate([&ControlName](const FControlRange& Range) { return Range.Name.Equals(ControlName, ESearchCase::IgnoreCase); }) };
+    if (Control == nullptr)
+    {
+        OutInfoMessage = FString::Printf(TEXT("Failed to find '%s' control in binary capture"), *ControlName);
+        return false;
+    }
+
+    DecodeRecords(Bytes, *Control, bFloat16, OutTrack);
+
+    return true;
+}
+
+bool FKeyframeBinarySource::LoadAllControls(TArrayView<const uint8> Bytes, TMap<FString, FKeyframeTrackSoA>& OutControls, FString& OutInfoMessage) const
+{
+    bool bFloat16{ false };
+    TArray<FControlRange> Controls;
+    if (!ReadControlTable(Bytes, bFloat16, Controls, OutInfoMessage))
+    {
+        return false;
+    }
+
+    TArray<FKeyframeTrackSoA> Tracks;
+    Tracks.SetNum(Controls.Num());
+    ParallelFor(Controls.Num(), [&Bytes, &Controls, &Tracks, bFloat16](const int32 Index)
+    {
+        DecodeRecords(Bytes, Controls[Index], bFloat16, Tracks[Index]);
+    });
+
+    OutControls.Reserve(OutControls.Num() + Controls.Num());
+    for (int32 Index = 0; Index < Controls.Num(); ++Index)
+    {
+        OutControls.Add(Controls[Index].Name, MoveTemp(Tracks[Index]));
+    }
+
+    return true;
+}
+
+void FKeyframeBinarySource::Write(const TMap<FString, FKeyframeTrackSoA>& Controls, const bool bFloat16, TArray<uint8>& OutBytes)
+{
+    FKeyframeBinaryHeader Header;
+    Header.Flags = bFloat16 ? FKeyframeBinaryHeader::Float16Flag : 0;
+    Header.NumControls = Controls.Num();
+
+    OutBytes.Reset();
+    KeyframeBinarySource::Append(OutBytes, Header);
+    for (const TPair<FString, FKeyframeTrackSoA>& Control : Controls)
+    {
+        const FKeyframeTrackSoA& Track{ Control.Value };
+        const FTCHARToUTF8 Name{ *Control.Key };
+
+        FKeyframeBinaryControlHeader ControlHeader;
+        ControlHeader.NameLength = Name.Length();
+        ControlHeader.NumRecords = Track.Num();
+        KeyframeBinarySource::Append(OutBytes, ControlHeader);
+        OutBytes.Append(reinterpret_cast<const uint8*>(Name.Get()), Name.Length());
+        OutBytes.SetNumZeroed(KeyframeBinarySource::Align(OutBytes.Num()));
+
+        TArray<int32> Order;
+        Order.SetNumUninitialized(Track.Num());
+        for (int32 Index = 0; Index < Track.Num(); ++Index)
+        {
+            Order[Index] = Index;
+        }
+        Algo::StableSort(Order, [&Track](const int32 A, const int32 B) { return Track.Frames[A] < Track.Frames[B]; });
+
+        for (const int32 Index : Order)
+        {
+            if (bFloat16)
+            {
+                FKeyframeHalfRecord Record;
+                Record.Frame = Track.Frames[Index];
+                for (int ChannelIndex = 0; ChannelIndex < FKeyframeTrackSoA::NumChannels; ++ChannelIndex)
+                {
+                    Record.Channels[ChannelIndex] = Track.GetChannel(ChannelIndex)[Index];
+                }
+                KeyframeBinarySource::Append(OutBytes, Record);
+            }
+            else
+            {
+                FKeyframePacketRecord Record;
+                Record.Frame = Track.Frames[Index];
+                for (int Axis = 0; Axis < 3; ++Axis)
+                {
+                    Record.Translation[Axis] = Track.GetChannel(Axis)[Index];
+                    Record.Rotation[Axis] = Track.GetChannel(3 + Axis)[Index];
+                    Record.Scale[Axis] = Track.GetChannel(6 + Axis)[Index];
+                }
+                KeyframeBinarySource::Append(OutBytes, Record);
+            }
+        }
+    }
+}
+
+bool FKeyframeBinarySource::ReadControlTable(TArrayView<const uint8> Bytes, bool& bOutFloat16, TArray<FControlRange>& OutControls, FString& OutInfoMessage)
+{
+    FKeyframeBinaryHeader Header;
+    if (Bytes.Num() < static_cast<int32>(sizeof(Header)))
+    {
+        OutInfoMessage = TEXT("Binary capture is truncated");
+        return false;
+    }
+    FMemory::Memcpy(&Header, Bytes.GetData(), sizeof(Header));
+
+    if (Header.Magic != FKeyframeBinaryHeader::ExpectedMagic || Header.Version != FKeyframeBinaryHeader::CurrentVersion)
+    {
+        OutInfoMessage = FString::Printf(TEXT("Binary capture has an unknown magic or version %u"), Header.Version);
+        return false;
+    }
+
+    bOutFloat16 = (Header.Flags & FKeyframeBinaryHeader::Float16Flag) != 0;
+    const int64 RecordSize{ bOutFloat16 ? static_cast<int64>(sizeof(FKeyframeHalfRecord)) : static_cast<int64>(sizeof(FKeyframePacketRecord)) };
+
+    //The counts are untrusted, every control needs at least its header so a larger count cannot fit.
+    const int64 MaxControls{ (Bytes.Num() - static_cast<int64>(sizeof(Header))) / static_cast<int64>(sizeof(FKeyframeBinaryControlHeader)) };
+    if (Header.NumControls > MaxControls)
+    {
+        OutInfoMessage = FString::Printf(TEXT("Binary capture claims %u controls but holds at most %lld"), Header.NumControls, MaxControls);
+        return false;
+    }
+
+    int64 Offset{ sizeof(Header) };
+    OutControls.Reset(Header.NumControls);
+    for (uint32 ControlIndex = 0; ControlIndex < Header.NumControls; ++ControlIndex)
+    {
+        FKeyframeBinaryControlHeader ControlHeader;
+        if (Offset + static_cast<int64>(sizeof(ControlHeader)) > Bytes.Num())
+        {
+            OutInfoMessage = FString::Printf(TEXT("Binary capture is truncated in control %u"), ControlIndex);
+            OutControls.Reset();
+            return false;
+        }
+        FMemory::Memcpy(&ControlHeader, Bytes.GetData() + Offset, sizeof(ControlHeader));
+        Offset += sizeof(ControlHeader);
+
+        const int64 NameOffset{ Offset };
+        Offset = KeyframeBinarySource::Align(Offset + ControlHeader.NameLength);
+        const int64 RecordsEnd{ Offset + ControlHeader.NumRecords * RecordSize };
+        if (ControlHeader.NameLength > static_cast<uint32>(MAX_int32) || ControlHeader.NumRecords > static_cast<uint32>(MAX_int32) || RecordsEnd > Bytes.Num())
+        {
+            OutInfoMessage = FString::Printf(TEXT("Binary capture is truncated in control %u"), ControlIndex);
+            OutControls.Reset();
+            return false;
+        }
+
+        const FUTF8ToTCHAR Name{ reinterpret_cast<const ANSICHAR*>(Bytes.GetData() + NameOffset), static_cast<int32>(ControlHeader.NameLength) };
+        FControlRange& Control{ OutControls.AddDefaulted_GetRef() };
+        Control.Name = FString(Name.Length(), Name.Get());
+        Control.RecordsOffset = Offset;
+        Control.NumRecords = static_cast<int32>(ControlHeader.NumRecords);
+        Offset = RecordsEnd;
+    }
+
+    return true;
+}
+
+void FKeyframeBinarySource::DecodeRecords(TArrayView<const uint8> Bytes, const FControlRange& Control, const bool bFloat16, FKeyframeTrackSoA& OutTrack)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FKeyframeBinarySource::DecodeRecords);
+    SCOPE_CYCLE_COUNTER(STAT_AnimationStreaming_Tokenize);
+
+    //Records to channels is a transpose, nothing is parsed.
+    const int32 Offset{ OutTrack.Num() };
+    OutTrack.SetNumUninitialized(Offset + Control.NumRecords);
+    int32* Frames{ OutTrack.Frames.GetData() + Offset };
+    float* Channels[FKeyframeTrackSoA::NumChannels];
+    for (int ChannelIndex = 0; ChannelIndex < FKeyframeTrackSoA::NumChannels; ++ChannelIndex)
+    {
+        Channels[ChannelIndex] = OutTrack.GetChannel(ChannelIndex).GetData() + Offset;
+    }
+
+    const uint8* Records{ Bytes.GetData() + Control.RecordsOffset };
+    for (int32 Index = 0; Index < Control.NumRecords; ++Index)
+    {
+        if (bFloat16)
+        {
+            FKeyframeHalfRecord Record;
+            FMemory::Memcpy(&Record, Records + Index * sizeof(FKeyframeHalfRecord), sizeof(Record));
+            Frames[Index] = Record.Frame;
+            for (int ChannelIndex = 0; ChannelIndex < FKeyframeTrackSoA::NumChannels; ++ChannelIndex)
+            {
+                Channels[ChannelIndex][Index] = Record.Channels[ChannelIndex].GetFloat();
+            }
+        }
+        else
+        {
+            FKeyframePacketRecord Record;
+            FMemory::Memcpy(&Record, Records + Index * sizeof(FKeyframePacketRecord), sizeof(Record));
+            Frames[Index] = Record.Frame;
+            for (int Axis = 0; Axis < 3; ++Axis)
+            {
+                Channels[Axis][Index] = Record.Translation[Axis];
+                Channels[3 + Axis][Index] = Record.Rotation[Axis];
+                Channels[6 + Axis][Index] = Record.Scale[Axis];
+            }
+        }
+    }
+}
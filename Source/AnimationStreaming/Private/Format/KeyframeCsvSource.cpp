@@ -0,0 +1,318 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Format/KeyframeCsvSource.h"
+
+#include "AnimationStreaming.h"
+
+
+namespace KeyframeCsvSource
+{
+    constexpr int32 ControlColumn{ -1 };
+    constexpr int32 FrameColumn{ -2 };
+    constexpr int32 IgnoredColumn{ -3 };
+
+    //Channel columns in section order.
+    const FAnsiStringView ChannelColumns[]{ "tx", "ty", "tz", "roll", "pitch", "yaw", "sx", "sy", "sz" };
+
+    FAnsiStringView Trim(FAnsiStringView Field)
+    {
+        while (Field.Len() > 0 && (Field[0] == ' ' || Field[0] == '\t'))
+        {
+            Field.RightChopInline(1);
+        }
+        while (Field.Len() > 0 && (Field[Field.Len() - 1] == ' ' || Field[Field.Len() - 1] == '\t' || Field[Field.Len() - 1] == '\r'))
+        {
+            Field.LeftChopInline(1);
+        }
+
+        return Field;
+    }
+
+    FAnsiStringView NextLine(const ANSICHAR*& Cursor, const ANSICHAR* End)
+    {
+        const ANSICHAR* LineBegin{ Cursor };
+        while (Cursor < End && *Cursor != '\n')
+        {
+            ++Cursor;
+        }
+        const FAnsiStringView Line{ LineBegin, static_cast<int32>(Cursor - LineBegin) };
+        if (Cursor < End)
+        {
+            ++Cursor;
+        }
+
+        return Trim(Line);
+    }
+
+    //Splits on commas, fields are trimmed.
+    void SplitFields(const FAnsiStringView Line, TArray<FAnsiStringView, TInlineAllocator<16>>& OutFields)
+    {
+        OutFields.Reset();
+        int32 FieldBegin{ 0 };
+        for (int32 Index = 0; Index <= Line.Len(); ++Index)
+        {
+            if (Index == Line.Len() || Line[Index] == ',')
+            {
+                OutFields.Add(Trim(Line.Mid(FieldBegin, Index - FieldBegin)));
+                FieldBegin = Index + 1;
+            }
+        }
+    }
+
+    //Channel values follow the JSON number grammar, the exporters write them the same way.
+    bool ParseNumber(const FAnsiStringView Field, double& OutValue)
+    {
+        ANSICHAR Buffer[64];
+        if (Field.Len() >= UE_ARRAY_COUNT(Buffer) || !FKeyframeJsonParser::IsValidNumber(Field))
+        {
+            return false;
+        }
+
+        FMemory::Memcpy(Buffer, Field.GetData(), Field.Len());
+        Buffer[Field.Len()] = '\0';
+        OutValue = FCStringAnsi::Atod(Buffer);
+        return true;
+    }
+
+    //Frames are whole numbers in int32 range, "12.5" or "1e3" are not truncated into a frame.
+    bool ParseFrame(const FAnsiStringView Field, int32& OutFrame)
+    {
+        int32 Index{ Field.Len() > 0 && Field[0] == '-' ? 1 : 0 };
+        if (Index >= Field.Len())
+        {
+            return false;
+        }
+
+        const bool bNegative{ Index == 1 };
+        int64 Frame{ 0 };
+        for (; Index < Field.Len(); ++Index)
+        {
+            if (!FCharAnsi::IsDigit(Field[Index]))
+            {
+                return false;
+            }
+
+            Frame = Frame * 10 + (Field[Index] - '0');
+            if (Frame > MAX_int32)
+            {
+                return false;
+            }
+        }
+
+        OutFrame = static_cast<int32>(bNegative ? -Frame : Frame);
+        return true;
+    }
+}
+
+FName FKeyframeCsvSource::GetFormatName() const
+{
+    return TEXT("Csv");
+}
+
+bool FKeyframeCsvSource::MatchesHeader(TArrayView<const uint8> Head) const
+{
+    const FAnsiStringView Text{ reinterpret_cast<const ANSICHAR*>(Head.GetData()), Head.Num() };
+
+    return Text.StartsWith("control,", ESearchCase::IgnoreCase) || Text.StartsWith("frame,", ESearchCase::IgnoreCase);
+}
+
+bool FKeyframeCsvSource::MatchesExtension(const FString& Extension) const
+{
+    return Extension == TEXT("csv");
+}
+
+bool FKeyframeCsvSource::LoadControl(TArrayView<const uint8> Bytes, const FString& ControlName, FKeyframeTrackSoA& OutTrack, FString& OutInfoMessage) const
+{
+    const FTCHARToUTF8 ControlNameUtf8{ *ControlName };
+    const FAnsiStringView Name{ ControlNameUtf8.Get(), ControlNameUtf8.Length() };
+
+    FKeyframeJsonParser::FTrackBlockWriter Writer;
+    int32 NumRows{ 0 };
+    const bool bParsed{ ParseRows(Bytes, [&Name, &Writer, &OutTrack, &NumRows](const FAnsiStringView Control, const FKeyframeJsonParser::FParsedFrame& Frame)
+    {
+        if (Control.Len() == 0 || Control.Equals(Name, ESearchCase::IgnoreCase))
+        {
+            ++NumRows;
+            if (Writer.Add(Frame))
+            {
+                Writer.Flush(OutTrack);
+            }
+        }
+    }, OutInfoMessage) };
+    Writer.Flush(OutTrack);
+
+    if (bParsed && NumRows == 0)
+    {
+        OutInfoMessage = FString::Printf(TEXT("Failed to find '%s' rows in CSV"), *ControlName);
+        return false;
+    }
+
+    return bParsed;
+}
+
+bool FKeyframeCsvSource::LoadAllControls(TArrayView<const uint8> Bytes, TMap<FString, FKeyframeTrackSoA>& OutControls, FString& OutInfoMessage) const
+{
+    //Rows are usually grouped by control, the writer is flushed whenever the control changes.
+    TMap<FString, FKeyframeTrackSoA> Tracks;
+    FKeyframeTrackSoA* Current{ nullptr };
+    FString CurrentName;
+    FKeyframeJsonParser::FTrackBlockWriter Writer;
+    const bool bParsed{ ParseRows(Bytes, [&Tracks, &Current, &CurrentName, &Writer](const FAnsiStringView Control, const FKeyframeJsonParser::FParsedFrame& Frame)
+    {
+        const FUTF8ToTCHAR Name{ Control.GetData(), Control.Len() };
+        const FString ControlName{ Control.Len() > 0 ? FString(Name.Length(), Name.Get()) : FString(TEXT("global_ctrl")) };
+        if (Current == nullptr || !ControlName.Equals(CurrentName, ESearchCase::IgnoreCase))
+        {
+            if (Current != nullptr)
+            {
+                Writer.Flush(*Current);
+            }
+            CurrentName = ControlName;
+            Current = &Tracks.FindOrAdd(CurrentName);
+        }
+
+        if (Writer.Add(Frame))
+        {
+            Writer.Flush(*Current);
+        }
+    }, OutInfoMessage) };
+
+    if (!bParsed)
+    {
+        return false;
+    }
+
+    if (Current != nullptr)
+    {
+        Writer.Flush(*Current);
+    }
+
+    for (TPair<FString, FKeyframeTrackSoA>& Track : Tracks)
+    {
+        OutControls.Add(Track.Key, MoveTemp(Track.Value));
+    }
+
+    return true;
+}
+
+bool FKeyframeCsvSource::ParseRows(TArrayView<const uint8> Bytes, TFunctionRef<void(const FAnsiStringView Control, const FKeyframeJsonParser::FParsedFrame& Frame)> Visitor, FString& OutInfoMessage)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FKeyframeCsvSource::ParseRows);
+    SCOPE_CYCLE_COUNTER(STAT_AnimationStreaming_Tokenize);
+
+    const ANSICHAR* Cursor{ reinterpret_cast<const ANSICHAR*>(Bytes.GetData()) };
+    const ANSICHAR* End{ Cursor + Bytes.Num() };
+
+    //Header names map every column to the control, the frame or a channel.
+    TArray<FAnsiStringView, TInlineAllocator<16>> Fields;
+    KeyframeCsvSource::SplitFields(KeyframeCsvSource::NextLine(Cursor, End), Fields);
+    TArray<int32, TInlineAllocator<16>> Columns;
+    for (const FAnsiStringView Field : Fields)
+    {
+        int32 Column{ KeyframeCsvSource::IgnoredColumn };
+        if (Field.Equals("control", ESearchCase::IgnoreCase))
+        {
+            Column = KeyframeCsvSource::ControlColumn;
+        }
+        else if (Field.Equals("frame", ESearchCase::IgnoreCase))
+        {
+            Column = KeyframeCsvSource::FrameColumn;
+        }
+        else
+        {
+            for (int32 ChannelIndex = 0; ChannelIndex < UE_ARRAY_COUNT(KeyframeCsvSource::ChannelColumns); ++ChannelIndex)
+            {
+                if (Field.Equals(KeyframeCsvSource::ChannelColumns[ChannelIndex], ESearchCase::IgnoreCase))
+                {
+                    Column = ChannelIndex;
+                }
+            }
+        }
+        Columns.Add(Column);
+    }
+
+    if (!Columns.Contains(KeyframeCsvSource::FrameColumn))
+    {
+        OutInfoMessage = TEXT("CSV header has no frame column");
+        return false;
+    }
+
+    int32 LineNumber{ 1 };
+    while (Cursor < End)
+    {
+        ++LineNumber;
+        const FAnsiStringView Line{ KeyframeCsvSource::NextLine(Cursor, End) };
+        if (Line.Len() == 0)
+        {
+            continue;
+        }
+
+        KeyframeCsvSource::SplitFields(Line, Fields);
+        if (Fields.Num() > Columns.Num())
+        {
+            OutInfoMessage = FString::Printf(TEXT("CSV line %d has more fields than the header"), LineNumber);
+            return false;
+        }
+
+        FKeyframeJsonParser::FParsedFrame Frame;
+        FAnsiStringView Control;
+        bool bHasFrame{ false };
+        for (int32 FieldIndex = 0; FieldIndex < Fields.Num(); ++FieldIndex)
+        {
+            const int32 Column{ Columns[FieldIndex] };
+            double Value{ 0.0 };
+            if (Column == KeyframeCsvSource::ControlColumn)
+            {
+                Control = Fields[FieldIndex];
+                continue;
+            }
+
+            if (Column == KeyframeCsvSource::FrameColumn)
+            {
+                if (!KeyframeCsvSource::ParseFrame(Fields[FieldIndex], Frame.Frame))
+                {
+                    OutInfoMessage = FString::Printf(TEXT("CSV line %d field %d is not a whole frame number in int32 range"), LineNumber, FieldIndex + 1);
+                    return false;
+                }
+                bHasFrame = true;
+                continue;
+            }
+
+            if (Column == KeyframeCsvSource::IgnoredColumn || Fields[FieldIndex].Len() == 0)
+            {
+                continue;
+            }
+
+            if (!KeyframeCsvSource::ParseNumber(Fields[FieldIndex], Value))
+            {
+                OutInfoMessage = FString::Printf(TEXT("CSV line %d field %d is not a number"), LineNumber, FieldIndex + 1);
+                return false;
+            }
+
+            if (Column < 3)
+            {
+                Frame.Translation[Column] = Value;
+            }
+            else if (Column < 6)
+            {
+                Frame.Rotation[Column - 3] = Value;
+            }
+            else
+            {
+                Frame.Scale[Column - 6] = Value;
+            }
+        }
+
+        //A short row that stops before the frame column has no frame either.
+        if (!bHasFrame)
+        {
+            OutInfoMessage = FString::Printf(TEXT("CSV line %d has no frame"), LineNumber);
+            return false;
+        }
+
+        Visitor(Control, Frame);
+    }
+
+    return true;
+}
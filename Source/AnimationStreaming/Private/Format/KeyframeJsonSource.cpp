@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Format/KeyframeJsonSource.h"
+
+#include "Json/KeyframeJsonParser.h"
+
+
+FName FKeyframeJsonSource::GetFormatName() const
+{
+    return TEXT("Json");
+}
+
+bool FKeyframeJsonSource::MatchesHeader(TArrayView<const uint8> Head) const
+{
+    //UTF-8 byte order mark and whitespace before the root object.
+    int32 Index{ Head.Num() >= 3 && Head[0] == 0xEF && Head[1] == 0xBB && Head[2] == 0xBF ? 3 : 0 };
+    while (Index < Head.Num() && FChar::IsWhitespace(static_cast<TCHAR>(Head[Index])))
+    {
+        ++Index;
+    }
+
+    return Index < Head.Num() && Head[Index] == '{';
+}
+
+bool FKeyframeJsonSource::MatchesExtension(const FString& Extension) const
+{
+    return Extension == TEXT("json");
+}
+
+bool FKeyframeJsonSource::LoadControl(TArrayView<const uint8> Bytes, const FString& ControlName, FKeyframeTrackSoA& OutTrack, FString& OutInfoMessage) const
+{
+    return FKeyframeJsonParser::ParseControl(Bytes, ControlName, OutTrack, OutInfoMessage);
+}
+
+bool FKeyframeJsonSource::LoadAllControls(TArrayView<const uint8> Bytes, TMap<FString, FKeyframeTrackSoA>& OutControls, FString& OutInfoMessage) const
+{
+    return FKeyframeJsonParser::ParseAllControls(Bytes, OutControls, OutInfoMessage);
+}
@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Format/KeyframeSource.h"
+
+#include "Format/KeyframeJsonSource.h"
+#include "Format/KeyframeCsvSource.h"
+#include "Format/KeyframeBinarySource.h"
+
+#include "Misc/Paths.h"
+
+
+namespace KeyframeSource
+{
+    constexpr int32 HeadSize{ 1024 };
+}
+
+FKeyframeSourceRegistry& FKeyframeSourceRegistry::Get()
+{
+    static FKeyframeSourceRegistry Registry;
+    return Registry;
+}
+
+FKeyframeSourceRegistry::FKeyframeSourceRegistry()
+{
+    //Most specific magic first, json only checks for a leading brace.
+    Sources.Add(MakeShared<FKeyframeBinarySource>());
+    Sources.Add(MakeShared<FKeyframeCsvSource>());
+    Sources.Add(MakeShared<FKeyframeJsonSource>());
+}
+
+void FKeyframeSourceRegistry::Register(const TSharedRef<IKeyframeSource>& Source)
+{
+    check(IsInGameThread());
+
+    Unregister(Source->GetFormatName());
+    Sources.Insert(Source, 0);
+}
+
+void FKeyframeSourceRegistry::Unregister(const FName FormatName)
+{
+    check(IsInGameThread());
+
+    Sources.RemoveAll([FormatName](const TSharedRef<IKeyframeSource>& Source) { return Source->GetFormatName() == FormatName; });
+}
+
+const IKeyframeSource* FKeyframeSourceRegistry::FindSource(const FString& FilePath, TArrayView<const uint8> Bytes) const
+{
+    const TArrayView<const uint8> Head{ Bytes.Left(KeyframeSource::HeadSize) };
+    for (const TSharedRef<IKeyframeSource>& Source : Sources)
+    {
+        if (Source->MatchesHeader(Head))
+        {
+            return &Source.Get();
+        }
+    }
+
+    const FString Extension{ FPaths::GetExtension(FilePath).ToLower() };
+    for (const TSharedRef<IKeyframeSource>& Source : Sources)
+    {
+        if (Source->MatchesExtension(Extension))
+        {
+            return &Source.Get();
+        }
+    }
+
+    return nullptr;
+}
+
+const IKeyframeSource* FKeyframeSourceRegistry::FindSourceByName(const FName FormatName) const
+{
+    for (const TSharedRef<IKeyframeSource>& Source : Sources)
+    {
+        if (Source->GetFormatName() == FormatName)
+        {
+            return &Source.Get();
+        }
+    }
+
+    return nullptr;
+}
+
+bool FKeyframeSourceRegistry::LoadControl(const FString& FilePath, TArrayView<const uint8> Bytes, const FString& ControlName, FKeyframeTrackSoA& OutTrack, FString& OutInfoMessage) const
+{
+    const IKeyframeSource* Source{ FindSource(FilePath, Bytes) };
+    if (Source == nullptr)
+    {
+        OutInfoMessage = FString::Printf(TEXT("No keyframe source reads '%s'"), *FilePath);
+        return false;
+    }
+
+    return Source->LoadControl(Bytes, ControlName, OutTrack, OutInfoMessage);
+}
+
+bool FKeyframeSourceRegistry::LoadAllControls(const FString& FilePath, TArrayView<const uint8> Bytes, TMap<FString, FKeyframeTrackSoA>& OutControls, FString& OutInfoMessage) const
+{
+    const IKeyframeSource* Source{ FindSource(FilePath, Bytes) };
+    if (Source == nullptr)
+    {
+        OutInfoMessage = FString::Printf(TEXT("No keyframe source reads '%s'"), *FilePath);
+        return false;
+    }
+
+    return Source->LoadAllControls(Bytes, OutControls, OutInfoMessage);
+}
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Format/KeyframeSourceFile.h"
+
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include "AnimationStreaming.h"
+
+
+FKeyframeSourceFile::FKeyframeSourceFile() = default;
+
+FKeyframeSourceFile::~FKeyframeSourceFile()
+{
+    Close();
+}
+
+bool FKeyframeSourceFile::Open(const FString& FilePath)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FKeyframeSourceFile::Open);
+    SCOPE_CYCLE_COUNTER(STAT_AnimationStreaming_Read);
+    Close();
+
+    IPlatformFile& PlatformFile{ FPlatformFileManager::Get().GetPlatformFile() };
+    MappedFile.Reset(PlatformFile.OpenMapped(*FilePath));
+    //The parsers index the bytes with int32, like a TArray<uint8> load.
+    if (MappedFile && MappedFile->GetFileSize() > MAX_int32)
+    {
+        Close();
+        return false;
+    }
+
+    if (MappedFile && MappedFile->GetFileSize() > 0)
+    {
+        Region.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+        if (Region)
+        {
+            Bytes = TArrayView<const uint8>{ Region->GetMappedPtr(), static_cast<int32>(Region->GetMappedSize()) };
+            return true;
+        }
+    }
+
+    //Empty files cannot be mapped, pak and other virtual files have no mapping.
+    Region.Reset();
+    MappedFile.Reset();
+    if (!FFileHelper::LoadFileToArray(Fallback, *FilePath))
+    {
+        return false;
+    }
+    Bytes = Fallback;
+
+    return true;
+}
+
+void FKeyframeSourceFile::Close()
+{
+    Bytes = TArrayView<const uint8>();
+    Fallback.Empty();
+    Region.Reset();
+    MappedFile.Reset();
+}
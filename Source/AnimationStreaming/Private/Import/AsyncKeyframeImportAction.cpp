@@ -0,0 +1,287 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Import/AsyncKeyframeImportAction.h"
+
+#include "Json/KeyframeCache.h"
+#include "Json/KeyframeJsonChunkParser.h"
+#include "Async/Async.h"
+#include "Async/AsyncFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Tasks/Task.h"
+#include "ProfilingDebugging/ScopedTimers.h"
+#include "AnimationStreaming.h"
+
+#include <atomic>
+
+
+//Shared between the action and its worker task, the action may be gone before the task ends.
+struct FAsyncKeyframeImportState
+{
+    FString FilePath;
+    FString ControlName;
+    FKeyframeTimeMapping TimeMapping;
+    int KeyInterpolation{ 0 };
+
+    std::atomic<bool> bCancelRequested{ false };
+
+    FTransformChannelKeys Keys;
+    FString InfoMessage;
+    bool bSuccess{ false };
+    FKeyframeImportReport Report;
+};
+
+namespace AsyncKeyframeImport
+{
+    constexpr int64 ChunkSize{ 4 * 1024 * 1024 };
+    //Share of the progress bar taken by reading and parsing, the rest is channel building.
+    constexpr float ParseProgressShare{ 0.9f };
+
+    void ReleaseRequest(TUniquePtr<IAsyncReadRequest>& Request)
+    {
+        if (!Request.IsValid())
+        {
+            return;
+        }
+
+        Request->Cancel();
+        Request->WaitCompletion();
+        if (uint8* Results = Request->GetReadResults())
+        {
+            FMemory::Free(Results);
+        }
+        Request.Reset();
+    }
+
+    bool ReadAndParse(FAsyncKeyframeImportState& State, FKeyframeTrackSoA& OutTrack, TFunctionRef<void(float)> ReportProgress)
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(AsyncKeyframeImport::ReadAndParse);
+        FKeyframeImportReport& Report{ State.Report };
+
+        //A valid sidecar cache makes the read unnecessary.
+        {
+            FScopedDurationTimer ReadTimer{ Report.ReadSeconds };
+            Report.bFromCache = FKeyframeCache::Load(State.FilePath, State.ControlName, OutTrack);
+        }
+
+        if (Report.bFromCache)
+        {
+            return true;
+        }
+
+        IPlatformFile& PlatformFile{ FPlatformFileManager::Get().GetPlatformFile() };
+        const int64 FileSize{ PlatformFile.FileSize(*State.FilePath) };
+        TUniquePtr<IAsyncReadFileHandle> Handle{ FileSize > 0 ? PlatformFile.OpenAsyncRead(*State.FilePath) : nullptr };
+        if (!Handle.IsValid())
+        {
+            State.InfoMessage = FString::Printf(TEXT("Failed to open file: %s"), *State.FilePath);
+            return false;
+        }
+
+        FKeyframeJsonChunkParser Parser{ State.ControlName, OutTrack };
+        int64 Offset{ 0 };
+        TUniquePtr<IAsyncReadRequest> Request{ Handle->ReadRequest(0, FMath::Min(ChunkSize, FileSize)) };
+        while (Request.IsValid())
+        {
+            //Only the time spent waiting on the disk counts as read time.
+            {
+                TRACE_CPUPROFILER_EVENT_SCOPE(AsyncKeyframeImport::WaitForRead);
+                SCOPE_CYCLE_COUNTER(STAT_AnimationStreaming_Read);
+                FScopedDurationTimer ReadTimer{ Report.ReadSeconds };
+
+                Request->WaitCompletion();
+            }
+            const int64 ReadSize{ FMath::Min(ChunkSize, FileSize - Offset) };
+            uint8* Chunk{ Request->GetReadResults() };
+            Request.Reset();
+            Offset += ReadSize;
+
+            //The next read is in flight while this chunk is parsed.
+            if (Chunk != nullptr && Offset < FileSize && !State.bCancelRequested)
+            {
+                Request.Reset(Handle->ReadRequest(Offset, FMath::Min(ChunkSize, FileSize - Offset)));
+            }
+
+            if (Chunk == nullptr)
+            {
+                State.InfoMessage = FString::Printf(TEXT("Failed to read file: %s"), *State.FilePath);
+                return false;
+            }
+
+            Report.BytesRead += ReadSize;
+            bool bParsed{ false };
+            {
+                FScopedDurationTimer TokenizeTimer{ Report.TokenizeSeconds };
+                bParsed = Parser.Consume(MakeArrayView(Chunk, static_cast<int32>(ReadSize)));
+            }
+            FMemory::Free(Chunk);
+
+            if (!bParsed || Parser.IsControlComplete() || State.bCancelRequested)
+            {
+                ReleaseRequest(Request);
+                break;
+            }
+
+            ReportProgress(ParseProgressShare * static_cast<float>(static_cast<double>(Offset) / FileSize));
+        }
+
+        if (State.bCancelRequested)
+        {
+            return false;
+        }
+
+        if (!Parser.Finish())
+        {
+            State.InfoMessage = Parser.GetError();
+            return false;
+        }
+
+        return true;
+    }
+}
+
+UAsyncKeyframeImportAction* UAsyncKeyframeImportAction::ImportJsonToSequencerAsync(AActor* Actor, const FString& FilePath, const FString& ControlName, const FString& SequencerPath, const int SectionIndex, int KeyInterpolation)
+{
+    UAsyncKeyframeImportAction* Action{ NewObject<UAsyncKeyframeImportAction>() };
+    Action->Actor = Actor;
+    Action->FilePath = FilePath;
+    Action->ControlName = ControlName;
+    Action->SequencerPath = SequencerPath;
+    Action->SectionIndex = SectionIndex;
+    Action->KeyInterpolation = KeyInterpolation;
+
+    return Action;
+}
+
+void UAsyncKeyframeImportAction::Cancel()
+{
+    if (State.IsValid())
+    {
+        State->bCancelRequested = true;
+    }
+}
+
+void UAsyncKeyframeImportAction::Activate()
+{
+    //Sequence lookup and section creation touch UObjects, they stay on the game thread.
+    StartSeconds = FPlatformTime::Seconds();
+    FKeyframeImportReport Report;
+    bool bSessionValid{ false };
+    {
+        FScopedDurationTimer LookupTimer{ Report.SequenceLookupSeconds };
+        Session = FSequencerImportSession(Actor.Get(), SequencerPath, SectionIndex, bSessionValid);
+    }
+
+    if (!bSessionValid)
+    {
+        Complete(false, TEXT("ImportJsonToSequencerAsync is failed: transform section is not valid"));
+        return;
+    }
+
+    //Editor utility graphs have no game instance to register with, keep the action alive until it completes.
+    AddToRoot();
+
+    State = MakeShared<FAsyncKeyframeImportState, ESPMode::ThreadSafe>();
+    State->FilePath = FilePath;
+    State->ControlName = ControlName;
+    State->TimeMapping = Session.GetTimeMapping();
+    State->KeyInterpolation = KeyInterpolation;
+    State->Report = Report;
+
+    TWeakObjectPtr<UAsyncKeyframeImportAction> WeakThis{ this };
+    UE::Tasks::Launch(UE_SOURCE_LOCATION, [WorkerState = State, WeakThis]()
+    {
+        int32 LastPercent{ -1 };
+        const auto ReportProgress = [WeakThis, &LastPercent](const float Progress)
+        {
+            const int32 Percent{ FMath::FloorToInt32(Progress * 100.0f) };
+            if (Percent == LastPercent)
+            {
+                return;
+            }
+            LastPercent = Percent;
+
+            AsyncTask(ENamedThreads::GameThread, [WeakThis, Progress]()
+            {
+                if (UAsyncKeyframeImportAction* Action = WeakThis.Get())
+                {
+                    Action->OnProgress.Broadcast(Progress);
+                }
+            });
+        };
+
+        FKeyframeTrackSoA Track;
+        WorkerState->bSuccess = AsyncKeyframeImport::ReadAndParse(*WorkerState, Track, ReportProgress);
+        WorkerState->Report.Frames = Track.Num();
+        WorkerState->Report.SampleMemory();
+        if (WorkerState->bSuccess && !WorkerState->bCancelRequested)
+        {
+            FScopedDurationTimer ConvertTimer{ WorkerState->Report.ConvertSeconds };
+            FSequencerImportSession::BuildChannelKeys(Track, WorkerState->TimeMapping, WorkerState->KeyInterpolation, WorkerState->Keys);
+        }
+
+        AsyncTask(ENamedThreads::GameThread, [WeakThis]()
+        {
+            if (UAsyncKeyframeImportAction* Action = WeakThis.Get())
+            {
+                Action->CommitOnGameThread();
+            }
+        });
+    });
+}
+
+void UAsyncKeyframeImportAction::CommitOnGameThread()
+{
+    if (State->bCancelRequested)
+    {
+        Complete(false, TEXT("ImportJsonToSequencerAsync is cancelled"));
+        return;
+    }
+
+    if (!State->bSuccess)
+    {
+        Complete(false, FString::Printf(TEXT("ImportJsonToSequencerAsync is failed: %s"), *State->InfoMessage));
+        return;
+    }
+
+    bool bCommitted{ false };
+    Session.CommitChannelKeys(State->Keys, bCommitted, State->Report);
+    State->Report.SampleMemory();
+    if (!bCommitted)
+    {
+        Complete(false, TEXT("ImportJsonToSequencerAsync is failed: channel commit is failed"));
+        return;
+    }
+
+    OnProgress.Broadcast(1.0f);
+    Complete(true, FString::Printf(TEXT("Imported %d frames of '%s'"), State->Keys.Times.Num(), *ControlName));
+}
+
+void UAsyncKeyframeImportAction::Complete(const bool bSuccess, const FString& InfoMessage)
+{
+    if (bCompleted)
+    {
+        return;
+    }
+    bCompleted = true;
+
+    FKeyframeImportReport Report{ State.IsValid() ? State->Report : FKeyframeImportReport() };
+    Report.TotalSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+    if (!bSuccess)
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s"), *InfoMessage);
+    }
+    else
+    {
+        Report.Log(TEXT("ImportJsonToSequencerAsync"));
+    }
+
+    OnCompleted.Broadcast(bSuccess, InfoMessage, Report);
+
+    if (IsRooted())
+    {
+        RemoveFromRoot();
+    }
+    SetReadyToDestroy();
+}
@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Import/ChunkedKeyframeImporter.h"
+
+#include "Json/KeyframeJsonChunkParser.h"
+#include "Sequencer/SequencerImportSession.h"
+#include "HAL/PlatformFileManager.h"
+#include "ProfilingDebugging/ScopedTimers.h"
+#include "AnimationStreaming.h"
+
+
+namespace ChunkedKeyframeImporter
+{
+    constexpr int32 MinChunkSize{ 4 * 1024 };
+    //The parser is fed in slices so a dense chunk cannot overshoot the flush count by much.
+    constexpr int32 SliceSize{ 64 * 1024 };
+}
+
+void FChunkedKeyframeImporter::Import(FSequencerImportSession& Session, const FString& FilePath, const FString& ControlName, int KeyInterpolation, const FChunkedImportSettings& Settings, bool& bOutSuccess, FString& OutInfoMessage, FKeyframeImportReport& OutReport)
+{
+    check(IsInGameThread());
+    TRACE_CPUPROFILER_EVENT_SCOPE(FChunkedKeyframeImporter::Import);
+    FScopedDurationTimer TotalTimer{ OutReport.TotalSeconds };
+
+    if (!Session.IsValid())
+    {
+        bOutSuccess = false;
+        OutInfoMessage = TEXT("Chunked import is failed: Section is not valid");
+
+        return;
+    }
+
+    TUniquePtr<IFileHandle> Handle{ FPlatformFileManager::Get().GetPlatformFile().OpenRead(*FilePath) };
+    if (!Handle.IsValid())
+    {
+        bOutSuccess = false;
+        OutInfoMessage = FString::Printf(TEXT("Chunked import is failed: Failed to open file: %s"), *FilePath);
+
+        return;
+    }
+
+    const int32 ChunkSize{ FMath::Max(Settings.ChunkSizeBytes, ChunkedKeyframeImporter::MinChunkSize) };
+    const int32 FlushFrameCount{ FMath::Max(Settings.FlushFrameCount, 1) };
+
+    TArray<uint8> Chunk;
+    Chunk.SetNumUninitialized(ChunkSize);
+
+    //Both buffers keep their allocation between batches.
+    FKeyframeTrackSoA Batch;
+    Batch.Reserve(FlushFrameCount + FKeyframeJsonParser::FTrackBlockWriter::BlockSize);
+    FTransformChannelKeys Keys;
+    FKeyframeJsonChunkParser Parser{ ControlName, Batch };
+    int32 NumImported{ 0 };
+
+    auto FlushBatch = [&Session, &Batch, &Keys, &NumImported, &OutReport, KeyInterpolation]()
+    {
+        bool bCommitted{ true };
+        if (Batch.Num() > 0)
+        {
+            {
+                FScopedDurationTimer ConvertTimer{ OutReport.ConvertSeconds };
+                FSequencerImportSession::BuildChannelKeys(Batch, Session.GetTimeMapping(), KeyInterpolation, Keys);
+            }
+            Keys.bDeferAutoTangents = true;
+            OutReport.SampleMemory();
+            Session.CommitChannelKeys(Keys, bCommitted, OutReport);
+            NumImported += Keys.Times.Num();
+            Batch.Reset();
+        }
+
+        return bCommitted;
+    };
+
+    int64 Remaining{ Handle->Size() };
+    while (Remaining > 0 && !Parser.IsControlComplete())
+    {
+        const int32 ReadSize{ static_cast<int32>(FMath::Min<int64>(ChunkSize, Remaining)) };
+        bool bRead{ false };
+        {
+            TRACE_CPUPROFILER_EVENT_SCOPE(FChunkedKeyframeImporter::Read);
+            SCOPE_CYCLE_COUNTER(STAT_AnimationStreaming_Read);
+            FScopedDurationTimer ReadTimer{ OutReport.ReadSeconds };
+
+            bRead = Handle->Read(Chunk.GetData(), ReadSize);
+        }
+
+        if (!bRead)
+        {
+            bOutSuccess = false;
+            OutInfoMessage = FString::Printf(TEXT("Chunked import is failed: Failed to read file: %s"), *FilePath);
+
+            return;
+        }
+        Remaining -= ReadSize;
+        OutReport.BytesRead += ReadSize;
+
+        for (int32 SliceOffset = 0; SliceOffset < ReadSize && !Parser.IsControlComplete(); SliceOffset += ChunkedKeyframeImporter::SliceSize)
+        {
+            const int32 SliceLength{ FMath::Min(ChunkedKeyframeImporter::SliceSize, ReadSize - SliceOffset) };
+            bool bConsumed{ false };
+            {
+                FScopedDurationTimer TokenizeTimer{ OutReport.TokenizeSeconds };
+                bConsumed = Parser.Consume(MakeArrayView(Chunk.GetData() + SliceOffset, SliceLength));
+            }
+
+            if (!bConsumed)
+            {
+                bOutSuccess = false;
+                OutInfoMessage = FString::Printf(TEXT("Chunked import is failed: %s"), *Parser.GetError());
+
+                return;
+            }
+
+            if (Batch.Num() >= FlushFrameCount && !FlushBatch())
+            {
+                bOutSuccess = false;
+                OutInfoMessage = TEXT("Chunked import is failed: channel commit is failed");
+
+                return;
+            }
+        }
+    }
+
+    if (!Parser.Finish() || !FlushBatch())
+    {
+        bOutSuccess = false;
+        OutInfoMessage = FString::Printf(TEXT("Chunked import is failed: %s"), Parser.GetError().IsEmpty() ? TEXT("channel commit is failed") : *Parser.GetError());
+
+        return;
+    }
+
+    //Tangents are set once over the whole take instead of once per batch.
+    if (KeyInterpolation == 0)
+    {
+        FScopedDurationTimer TangentTimer{ OutReport.ChannelWriteSeconds };
+        Session.AutoSetTangents();
+    }
+
+    OutReport.Frames = NumImported;
+    OutReport.SampleMemory();
+
+    bOutSuccess = true;
+    OutInfoMessage = FString::Printf(TEXT("Imported %d frames of '%s'"), NumImported, *ControlName);
+}
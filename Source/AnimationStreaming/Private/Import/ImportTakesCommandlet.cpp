@@ -0,0 +1,315 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Import/ImportTakesCommandlet.h"
+
+#include "Json/JsonManager.h"
+#include "Sequencer/SequencerManager.h"
+#include "Sequencer/SequencerImportSession.h"
+#include "AnimationStreaming.h"
+
+#include "Runtime/LevelSequence/Public/LevelSequence.h"
+#include "MovieScene.h"
+#include "Tracks/MovieScene3DTransformTrack.h"
+
+#include "Async/ParallelFor.h"
+#include "Dom/JsonObject.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+
+UImportTakesCommandlet::UImportTakesCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+}
+
+int32 UImportTakesCommandlet::Main(const FString& Params)
+{
+    TArray<FTakeImportJob> Jobs;
+    if (!ReadJobs(Params, Jobs))
+    {
+        return 1;
+    }
+
+    //A batch bounds how many parsed takes are in memory before their packages are saved.
+    int32 BatchSize{ 16 };
+    FParse::Value(*Params, TEXT("batchsize="), BatchSize);
+    BatchSize = FMath::Max(BatchSize, 1);
+    const bool bCreateSections{ FParse::Param(*Params, TEXT("createsections")) };
+    const bool bSave{ !FParse::Param(*Params, TEXT("nosave")) };
+
+    int32 NumFailed{ 0 };
+    for (int32 BatchStart = 0; BatchStart < Jobs.Num(); BatchStart += BatchSize)
+    {
+        const int32 BatchNum{ FMath::Min(BatchSize, Jobs.Num() - BatchStart) };
+        UE_LOG(LogAnimationStreaming, Display, TEXT("Importing takes %d-%d of %d"), BatchStart + 1, BatchStart + BatchNum, Jobs.Num());
+
+        NumFailed += ImportBatch(MakeArrayView(Jobs.GetData() + BatchStart, BatchNum), bCreateSections, bSave);
+        CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+    }
+
+    UE_LOG(LogAnimationStreaming, Display, TEXT("Imported %d of %d takes"), Jobs.Num() - NumFailed, Jobs.Num());
+
+    return NumFailed == 0 ? 0 : 1;
+}
+
+bool UImportTakesCommandlet::ReadJobs(const FString& Params, TArray<FTakeImportJob>& OutJobs)
+{
+    FString ManifestPath;
+    if (FParse::Value(*Params, TEXT("manifest="), ManifestPath))
+    {
+        FString ManifestString;
+        TSharedPtr<FJsonObject> Manifest;
+        if (!FFileHelper::LoadFileToString(ManifestString, *ManifestPath) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(ManifestString), Manifest) || !Manifest.IsValid())
+        {
+            UE_LOG(LogTemp, Error, TEXT("ImportTakes is failed: Manifest is not valid - '%s'"), *ManifestPath);
+            return false;
+        }
+
+        const FString ManifestDirectory{ FPaths::GetPath(ManifestPath) };
+        const TArray<TSharedPtr<FJsonValue>>* JobValues{ nullptr };
+        if (Manifest->TryGetArrayField(TEXT("jobs"), JobValues))
+        {
+            for (const TSharedPtr<FJsonValue>& JobValue : *JobValues)
+            {
+                const TSharedPtr<FJsonObject>* JobObject{ nullptr };
+                if (!JobValue.IsValid() || !JobValue->TryGetObject(JobObject))
+                {
+                    continue;
+                }
+
+                FTakeImportJob& Job{ OutJobs.AddDefaulted_GetRef() };
+                (*JobObject)->TryGetStringField(TEXT("file"), Job.FilePath);
+                (*JobObject)->TryGetStringField(TEXT("sequence"), Job.SequencePath);
+                (*JobObject)->TryGetStringField(TEXT("binding"), Job.Binding);
+                (*JobObject)->TryGetStringField(TEXT("control"), Job.ControlName);
+                (*JobObject)->TryGetNumberField(TEXT("section"), Job.SectionIndex);
+                (*JobObject)->TryGetNumberField(TEXT("interpolation"), Job.KeyInterpolation);
+
+                if (FPaths::IsRelative(Job.FilePath))
+                {
+                    Job.FilePath = FPaths::ConvertRelativePathToFull(ManifestDirectory, Job.FilePath);
+                }
+            }
+        }
+    }
+
+    FTakeImportJob Job;
+    if (FParse::Value(*Params, TEXT("file="), Job.FilePath))
+    {
+        FParse::Value(*Params, TEXT("sequence="), Job.SequencePath);
+        FParse::Value(*Params, TEXT("binding="), Job.Binding);
+        FParse::Value(*Params, TEXT("control="), Job.ControlName);
+        FParse::Value(*Params, TEXT("section="), Job.SectionIndex);
+        FParse::Value(*Params, TEXT("interpolation="), Job.KeyInterpolation);
+        OutJobs.Add(Job);
+    }
+
+    if (OutJobs.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("ImportTakes is failed: No jobs, pass -manifest=<takes.json> or -file= -sequence= -binding="));
+        return false;
+    }
+
+    return true;
+}
+
+int32 UImportTakesCommandlet::ImportBatch(TArrayView<const FTakeImportJob> Batch, const bool bCreateSections, const bool bSave)
+{
+    //Every file is parsed once, however many of its controls the batch uses.
+    TArray<FString> Files;
+    for (const FTakeImportJob& Job : Batch)
+    {
+        Files.AddUnique(Job.FilePath);
+    }
+
+    //Controls stay in the SoA layout of the source, no quat round trip before the channel build.
+    TArray<TMap<FString, FKeyframeTrackSoA>> ParsedFiles;
+    TArray<bool> FilesParsed;
+    TArray<FString> FileErrors;
+    ParsedFiles.SetNum(Files.Num());
+    FilesParsed.SetNumZeroed(Files.Num());
+    FileErrors.SetNum(Files.Num());
+    ParallelFor(Files.Num(), [&Files, &ParsedFiles, &FilesParsed, &FileErrors](const int32 FileIndex)
+    {
+        bool bParsed{ false };
+        ParsedFiles[FileIndex] = UJsonManager::LoadAllTracks(Files[FileIndex], bParsed, FileErrors[FileIndex]);
+        FilesParsed[FileIndex] = bParsed;
+    });
+
+    //Sequence loading and binding lookup are UObject work and stay on the game thread.
+    TArray<FSequencerImportSession> Sessions;
+    TArray<const FKeyframeTrackSoA*> Tracks;
+    TArray<FString> Errors;
+    Sessions.SetNum(Batch.Num());
+    Tracks.SetNumZeroed(Batch.Num());
+    Errors.SetNum(Batch.Num());
+    for (int32 JobIndex = 0; JobIndex < Batch.Num(); ++JobIndex)
+    {
+        const FTakeImportJob& Job{ Batch[JobIndex] };
+        const int32 FileIndex{ Files.IndexOfByKey(Job.FilePath) };
+        if (!FilesParsed[FileIndex])
+        {
+            Errors[JobIndex] = FileErrors[FileIndex];
+            continue;
+        }
+
+        Tracks[JobIndex] = ParsedFiles[FileIndex].Find(Job.ControlName);
+        if (Tracks[JobIndex] == nullptr)
+        {
+            Errors[JobIndex] = FString::Printf(TEXT("Failed to find '%s' object in JSON"), *Job.ControlName);
+            continue;
+        }
+
+        bool bSuccess{ false };
+        ULevelSequence* Sequence{ USequencerManager::GetLevelSequencer(Job.SequencePath, bSuccess) };
+        const FGuid Binding{ IsValid(Sequence) ? FindBinding(Sequence, Job.Binding) : FGuid() };
+        if (!Binding.IsValid())
+        {
+            Errors[JobIndex] = FString::Printf(TEXT("Binding '%s' is not found in '%s'"), *Job.Binding, *Job.SequencePath);
+            continue;
+        }
+
+        if (bCreateSections)
+        {
+            EnsureTransformSection(Sequence, Binding);
+        }
+
+        Sessions[JobIndex] = FSequencerImportSession(Sequence, Binding, Job.SectionIndex, bSuccess);
+        if (!bSuccess)
+        {
+            Errors[JobIndex] = TEXT("Section is not valid");
+        }
+    }
+
+    //Takes are independent, their keys are built side by side.
+    TArray<FTransformChannelKeys> ChannelKeys;
+    ChannelKeys.SetNum(Batch.Num());
+    ParallelFor(Batch.Num(), [&Batch, &Sessions, &Tracks, &Errors, &ChannelKeys](const int32 JobIndex)
+    {
+        if (Errors[JobIndex].IsEmpty())
+        {
+            FSequencerImportSession::BuildChannelKeys(*Tracks[JobIndex], Sessions[JobIndex].GetTimeMapping(), Batch[JobIndex].KeyInterpolation, ChannelKeys[JobIndex]);
+        }
+    });
+
+    int32 NumFailed{ 0 };
+    TSet<UPackage*> DirtyPackages;
+    for (int32 JobIndex = 0; JobIndex < Batch.Num(); ++JobIndex)
+    {
+        const FTakeImportJob& Job{ Batch[JobIndex] };
+        if (Errors[JobIndex].IsEmpty())
+        {
+            bool bCommitted{ false };
+            Sessions[JobIndex].CommitChannelKeys(ChannelKeys[JobIndex], bCommitted);
+            if (!bCommitted)
+            {
+                Errors[JobIndex] = TEXT("Channel commit is failed");
+            }
+        }
+
+        if (!Errors[JobIndex].IsEmpty())
+        {
+            ++NumFailed;
+            UE_LOG(LogTemp, Error, TEXT("ImportTakes is failed: '%s' -> '%s': %s"), *Job.FilePath, *Job.SequencePath, *Errors[JobIndex]);
+            continue;
+        }
+
+        UPackage* Package{ Sessions[JobIndex].GetLevelSequence()->GetPackage() };
+        Package->MarkPackageDirty();
+        DirtyPackages.Add(Package);
+        UE_LOG(LogAnimationStreaming, Display, TEXT("Imported %d frames of '%s' into '%s'"), Tracks[JobIndex]->Num(), *Job.ControlName, *Job.SequencePath);
+    }
+
+    if (bSave)
+    {
+        NumFailed += SavePackages(DirtyPackages);
+    }
+
+    return NumFailed;
+}
+
+int32 UImportTakesCommandlet::SavePackages(const TSet<UPackage*>& Packages)
+{
+    int32 NumFailed{ 0 };
+
+#if WITH_EDITOR
+    for (UPackage* Package : Packages)
+    {
+        const FString Filename{ FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension()) };
+
+        FSavePackageArgs SaveArgs;
+        SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+        SaveArgs.SaveFlags = SAVE_NoError;
+        if (!UPackage::SavePackage(Package, nullptr, *Filename, SaveArgs))
+        {
+            ++NumFailed;
+            UE_LOG(LogTemp, Error, TEXT("ImportTakes is failed: Failed to save '%s'"), *Filename);
+        }
+    }
+#else
+    if (Packages.Num() > 0)
+    {
+        NumFailed = Packages.Num();
+        UE_LOG(LogTemp, Error, TEXT("ImportTakes is failed: Saving packages needs an editor build, pass -nosave"));
+    }
+#endif
+
+    return NumFailed;
+}
+
+FGuid UImportTakesCommandlet::FindBinding(ULevelSequence* Sequence, const FString& Binding)
+{
+    FGuid BindingID;
+    if (FGuid::Parse(Binding, BindingID))
+    {
+        return BindingID;
+    }
+
+    UMovieScene* MovieScene{ Sequence->GetMovieScene() };
+    for (int32 Index = 0; Index < MovieScene->GetPossessableCount(); ++Index)
+    {
+        const FMovieScenePossessable& Possessable{ MovieScene->GetPossessable(Index) };
+        if (Possessable.GetName().Equals(Binding, ESearchCase::IgnoreCase))
+        {
+            return Possessable.GetGuid();
+        }
+    }
+
+    for (int32 Index = 0; Index < MovieScene->GetSpawnableCount(); ++Index)
+    {
+        const FMovieSceneSpawnable& Spawnable{ MovieScene->GetSpawnable(Index) };
+        if (Spawnable.GetName().Equals(Binding, ESearchCase::IgnoreCase))
+        {
+            return Spawnable.GetGuid();
+        }
+    }
+
+    return FGuid();
+}
+
+void UImportTakesCommandlet::EnsureTransformSection(ULevelSequence* Sequence, const FGuid& Binding)
+{
+    UMovieScene* MovieScene{ Sequence->GetMovieScene() };
+    UMovieScene3DTransformTrack* Track{ MovieScene->FindTrack<UMovieScene3DTransformTrack>(Binding) };
+    if (!IsValid(Track))
+    {
+        MovieScene->Modify();
+        Track = MovieScene->AddTrack<UMovieScene3DTransformTrack>(Binding);
+    }
+
+    if (Track->GetAllSections().Num() == 0)
+    {
+        Track->Modify();
+        UMovieSceneSection* Section{ Track->CreateNewSection() };
+        Section->SetRange(TRange<FFrameNumber>::All());
+        Track->AddSection(*Section);
+    }
+}
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Import/KeyframeImportReport.h"
+
+#include "AnimationStreaming.h"
+#include "HAL/PlatformMemory.h"
+
+
+void FKeyframeImportReport::SampleMemory()
+{
+    PeakUsedPhysicalBytes = FMath::Max(PeakUsedPhysicalBytes, static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical));
+}
+
+FString FKeyframeImportReport::ToString() const
+{
+    return FString::Printf(TEXT("bytes=%lld frames=%d keys=%d cache=%d blocks=%d read=%.3fms tokenize=%.3fms convert=%.3fms lookup=%.3fms write=%.3fms modify=%.3fms total=%.3fms peak=%.1fMB"),
+        static_cast<long long>(BytesRead), Frames, KeysWritten, bFromCache ? 1 : 0, ChangedBlocks,
+        ReadSeconds * 1000.0, TokenizeSeconds * 1000.0, ConvertSeconds * 1000.0, SequenceLookupSeconds * 1000.0,
+        ChannelWriteSeconds * 1000.0, ModifySeconds * 1000.0, TotalSeconds * 1000.0,
+        PeakUsedPhysicalBytes / (1024.0 * 1024.0));
+}
+
+void FKeyframeImportReport::Log(const FString& Label) const
+{
+    UE_LOG(LogAnimationStreaming, Log, TEXT("%s: %s"), *Label, *ToString());
+}
@@ -2,13 +2,31 @@
 
 
 #include "Json/JsonManager.h"
-
+#include "Json/KeyframeJsonParser.h"
+#include "Format/KeyframeSource.h"
+#include "Format/KeyframeSourceFile.h"
+#include "Json/KeyframeCache.h"
+#include "Sequencer/KeyframeFrameIndex.h"
+#include "AnimationStreaming.h"
+
+#include "Algo/IsSorted.h"
 #include "HAL/PlatformFileManager.h"
 #include "Misc/FileHelper.h"
+#include "Misc/MemStack.h"
 #include "Serialization/JsonSerializer.h"
 #include "JsonObjectConverter.h"
 
 
+void UJsonManager::OpenSourceFile(const FString& FilePath, bool& bOutSuccess, FString& OutInfoMessage, FKeyframeSourceFile& OutSourceFile)
+{
+    bOutSuccess = OutSourceFile.Open(FilePath);
+
+    if (!bOutSuccess)
+    {
+        OutInfoMessage = FString::Printf(TEXT("Load Json failed: - '%s'"), *FilePath);
+    }
+}
+
 void UJsonManager::LoadStringFromFile(const FString& FilePath, bool& bOutSuccess, FString& OutInfoMessage, FString& OutFileContents)
 {
     bOutSuccess = FFileHelper::LoadFileToString(OutFileContents, *FilePath);
@@ -53,147 +71,182 @@ FKeyframes UJsonManager::LoadJsonToStruct(const FString& FilePath, bool& bOutSuc
 
 TArray<FKeyframes> UJsonManager::LoadJsonArrayToStruct(const FString& FilePath, bool& bOutSuccess, FString& OutInfoMessage)
 {
-    // Load file from disk
-    FString JsonString{};
-    LoadStringFromFile(FilePath, bOutSuccess, OutInfoMessage, JsonString);
-    if (!bOutSuccess)
+    const FString ControlName{ TEXT("global_ctrl") };
+
+    //Re-imports map the binary sidecar instead of parsing text again.
+    TArray<FKeyframes> Keyframes{};
+    if (FKeyframeCache::Load(FilePath, ControlName, Keyframes))
     {
-        return TArray<FKeyframes>();
-    }
+        bOutSuccess = true;
+        OutInfoMessage = FString::Printf(TEXT("Loaded keyframe cache - '%s'"), *FKeyframeCache::GetCachePath(FilePath));
+        SortKeyframes(Keyframes);
+        PrintKeyframeData(Keyframes);
 
-    TSharedPtr<FJsonObject> JsonObject;
-    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
+        return Keyframes;
+    }
 
-    //Check the JsonObject for validation after
-    //Deserialize, because it's outer object.
-    if (!FJsonSerializer::Deserialize(Reader, JsonObject) && JsonObject.IsValid())
+    // Map the raw UTF-8 bytes, no FString or json DOM is built
+    FKeyframeSourceFile SourceFile{};
+    OpenSourceFile(FilePath, bOutSuccess, OutInfoMessage, SourceFile);
+    if (!bOutSuccess)
     {
-        UE_LOG(LogTemp, Error, TEXT("Failed to deserialize JSON"));
         return TArray<FKeyframes>();
     }
+    const TArrayView<const uint8> JsonBytes{ SourceFile.GetBytes() };
 
-    // Access the "global_ctrl" object directly
-    const TSharedPtr<FJsonObject>& GlobalCtrlObject = JsonObject->GetObjectField("global_ctrl");
-    // Iterate over each key-value pair in the "global_ctrl" object
-    if (!GlobalCtrlObject.IsValid())
+    //Frames of "global_ctrl" are parsed straight into a track reserved from a structural pre-scan.
+    //The cache keeps the parsed Euler values, the keyframes are built from them the same way a cache hit builds them.
+    TMap<FString, FKeyframeTrackSoA> CachedControls{};
+    FKeyframeTrackSoA& Track{ CachedControls.Add(ControlName) };
+    bOutSuccess = FKeyframeJsonParser::ParseControl(JsonBytes, ControlName, Track, OutInfoMessage);
+    if (!bOutSuccess)
     {
-        UE_LOG(LogTemp, Error, TEXT("Failed to find 'global_ctrl' object in JSON"));
+        UE_LOG(LogTemp, Error, TEXT("%s"), *OutInfoMessage);
         return TArray<FKeyframes>();
     }
 
-    //If all validation is success
-    //proceed further with parsing data.
-    TArray<FKeyframes> Keyframes{};
-    for (auto& Pair : GlobalCtrlObject->Values)
-    {
-        const FString& Key = Pair.Key;
-        const TSharedPtr<FJsonObject>& SubObject = Pair.Value->AsObject();
-        int Frame = FCString::Atoi(*Pair.Key);
+    //A failed cache write only costs the next import a full parse.
+    FKeyframeCache::Merge(FilePath, JsonBytes, CachedControls);
+    Track.ToKeyframes(Keyframes);
 
-        // Get parsed Transform
-        FTransform Coordinates
-        {
-            GetParsedRotation(SubObject).Quaternion(),
-            GetParsedLocation(SubObject),
-            GetParsedScale(SubObject)
-        };
-
-        FKeyframes FinalKeyframe{ GetInitializedKeyFrameStruct(Coordinates, Frame) };
-        Keyframes.Emplace(FinalKeyframe);
-    }
+    SortKeyframes(Keyframes);
     PrintKeyframeData(Keyframes);
 
     return Keyframes;
 }
 
-void UJsonManager::PrintKeyframeData(const TArray<FKeyframes>& Keyframes)
+FKeyframeTrackSoA UJsonManager::LoadJsonToTrack(const FString& FilePath, const FString& ControlName, bool& bOutSuccess, FString& OutInfoMessage)
 {
-    for (const auto& Keyframe : Keyframes)
+    FKeyframeTrackSoA Track{};
+    if (FKeyframeCache::Load(FilePath, ControlName, Track))
     {
-        UE_LOG(LogTemp, Warning, TEXT("Frame: (%i)"), Keyframe.Frame);
+        bOutSuccess = true;
+        OutInfoMessage = FString::Printf(TEXT("Loaded keyframe cache - '%s'"), *FKeyframeCache::GetCachePath(FilePath));
 
-        UE_LOG(LogTemp, Warning, TEXT("Rotation: (%f, %f, %f)"), Keyframe.Coordinates.GetRotation().X, Keyframe.Coordinates.GetRotation().Y, Keyframe.Coordinates.GetRotation().Z);
+        return Track;
+    }
 
-        UE_LOG(LogTemp, Warning, TEXT("Location: (%f, %f, %f)"), Keyframe.Coordinates.GetLocation().X, Keyframe.Coordinates.GetLocation().Y, Keyframe.Coordinates.GetLocation().Z);
+    FKeyframeSourceFile SourceFile{};
+    OpenSourceFile(FilePath, bOutSuccess, OutInfoMessage, SourceFile);
+    if (!bOutSuccess)
+    {
+        return Track;
+    }
+    const TArrayView<const uint8> JsonBytes{ SourceFile.GetBytes() };
 
-        UE_LOG(LogTemp, Warning, TEXT("Scale: (%f, %f, %f)"), Keyframe.Coordinates.GetScale3D().X, Keyframe.Coordinates.GetScale3D().Y, Keyframe.Coordinates.GetScale3D().Z);
+    bOutSuccess = FKeyframeSourceRegistry::Get().LoadControl(FilePath, JsonBytes, ControlName, Track, OutInfoMessage);
+    if (!bOutSuccess)
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s"), *OutInfoMessage);
+        return FKeyframeTrackSoA();
     }
+
+    TMap<FString, FKeyframeTrackSoA> CachedControls{};
+    CachedControls.Add(ControlName, Track);
+    FKeyframeCache::Merge(FilePath, JsonBytes, CachedControls);
+
+    return Track;
 }
 
-float UJsonManager::SafeConvertToFloat(const double ValueToConvert)
+TMap<FString, FKeyframeTrack> UJsonManager::LoadAllControls(const FString& FilePath, bool& bOutSuccess, FString& OutInfoMessage)
 {
-    const double MinValidValue = -DBL_MAX; // Minimum valid value
-    const double MaxValidValue = DBL_MAX; // Maximum valid value
+    TMap<FString, FKeyframeTrack> Controls{};
+    if (FKeyframeCache::LoadAll(FilePath, Controls))
+    {
+        bOutSuccess = true;
+        OutInfoMessage = FString::Printf(TEXT("Loaded keyframe cache - '%s'"), *FKeyframeCache::GetCachePath(FilePath));
 
-    if (ValueToConvert >= MinValidValue && ValueToConvert <= MaxValidValue)
+        return Controls;
+    }
+
+    const TMap<FString, FKeyframeTrackSoA> Tracks{ LoadAllTracks(FilePath, bOutSuccess, OutInfoMessage) };
+    if (!bOutSuccess)
     {
-        return static_cast<float>(ValueToConvert); // Convert safely to float
+        return Controls;
     }
-    else
+
+    Controls.Reserve(Tracks.Num());
+    for (const TPair<FString, FKeyframeTrackSoA>& Track : Tracks)
     {
-        // Handle invalid value or out of range error
-        UE_LOG(LogTemp, Error, TEXT("Invalid value encountered during conversion to float."));
-        return 0.0f; // or any default value you prefer
+        Track.Value.ToKeyframes(Controls.Add(Track.Key).Keyframes);
     }
+
+    return Controls;
 }
 
-int UJsonManager::GetLastFrame(const TMap<FString, TSharedPtr<FJsonValue>>& JsonData)
+TMap<FString, FKeyframeTrackSoA> UJsonManager::LoadAllTracks(const FString& FilePath, bool& bOutSuccess, FString& OutInfoMessage)
 {
-    int LastFrame;
-    for (auto& Pair : JsonData)
+    TMap<FString, FKeyframeTrackSoA> Tracks{};
+    if (FKeyframeCache::LoadAll(FilePath, Tracks))
     {
-        LastFrame = FCString::Atoi(*Pair.Key);
+        bOutSuccess = true;
+        OutInfoMessage = FString::Printf(TEXT("Loaded keyframe cache - '%s'"), *FKeyframeCache::GetCachePath(FilePath));
+
+        return Tracks;
     }
 
-    return LastFrame;
-}
+    FKeyframeSourceFile SourceFile{};
+    OpenSourceFile(FilePath, bOutSuccess, OutInfoMessage, SourceFile);
+    if (!bOutSuccess)
+    {
+        return Tracks;
+    }
+    const TArrayView<const uint8> JsonBytes{ SourceFile.GetBytes() };
 
-FRotator UJsonManager::GetParsedRotation(const TSharedPtr<FJsonObject>& SubObject)
-{
-    const TSharedPtr<FJsonObject>& RotationJson = SubObject->GetObjectField("rotation");
-    const FRotator Rotation
+    bOutSuccess = FKeyframeSourceRegistry::Get().LoadAllControls(FilePath, JsonBytes, Tracks, OutInfoMessage);
+    if (!bOutSuccess)
     {
-        SafeConvertToFloat(RotationJson->GetNumberField("y")),
-        SafeConvertToFloat(RotationJson->GetNumberField("z")),
-        SafeConvertToFloat(RotationJson->GetNumberField("x"))
-    };
+        UE_LOG(LogTemp, Error, TEXT("%s"), *OutInfoMessage);
+        return TMap<FString, FKeyframeTrackSoA>();
+    }
+
+    FKeyframeCache::Write(FilePath, JsonBytes, Tracks);
+    OutInfoMessage = FString::Printf(TEXT("Loaded %i controls - '%s'"), Tracks.Num(), *FilePath);
 
-    return Rotation;
+    return Tracks;
 }
 
-FVector UJsonManager::GetParsedLocation(const TSharedPtr<FJsonObject>& SubObject)
+void UJsonManager::SortKeyframes(TArray<FKeyframes>& InOutKeyframes)
 {
-    const TSharedPtr<FJsonObject>& TranslationJson = SubObject->GetObjectField("translation");
-    const FVector Location
+    FMemMark Mark{ FMemStack::Get() };
+    TArray<int32, TMemStackAllocator<>> Frames;
+    Frames.SetNumUninitialized(InOutKeyframes.Num());
+    for (int32 Index = 0; Index < InOutKeyframes.Num(); ++Index)
+    {
+        Frames[Index] = InOutKeyframes[Index].Frame;
+    }
+
+    const FKeyframeFrameIndex FrameIndex{ Frames };
+    if (FrameIndex.NumDuplicates == 0 && Algo::IsSorted(Frames))
     {
-        SafeConvertToFloat(TranslationJson->GetNumberField("x")),
-        SafeConvertToFloat(TranslationJson->GetNumberField("y")),
-        SafeConvertToFloat(TranslationJson->GetNumberField("z"))
-    };
+        return;
+    }
 
-    return Location;
+    TArray<FKeyframes> Sorted;
+    Sorted.Reserve(FrameIndex.Num());
+    for (const int32 Index : FrameIndex.Order)
+    {
+        Sorted.Add(InOutKeyframes[Index]);
+    }
+    InOutKeyframes = MoveTemp(Sorted);
 }
 
-FVector UJsonManager::GetParsedScale(const TSharedPtr<FJsonObject>& SubObject)
+void UJsonManager::PrintKeyframeData(const TArray<FKeyframes>& Keyframes)
 {
-    const TSharedPtr<FJsonObject>& ScaleJson = SubObject->GetObjectField("scale");
-    const FVector Scale
+    //Per-frame output is opt-in: "log LogAnimationStreaming VeryVerbose".
+    if (!UE_LOG_ACTIVE(LogAnimationStreaming, VeryVerbose))
     {
-        SafeConvertToFloat(ScaleJson->GetNumberField("x")),
-        SafeConvertToFloat(ScaleJson->GetNumberField("y")),
-        SafeConvertToFloat(ScaleJson->GetNumberField("z"))
-    };
+        return;
+    }
 
-    UE_LOG(LogTemp, Warning, TEXT("Scale: %s"), *Scale.ToString());
+    for (const auto& Keyframe : Keyframes)
+    {
+        UE_LOG(LogAnimationStreaming, VeryVerbose, TEXT("Frame: (%i)"), Keyframe.Frame);
 
-    return Scale;
-}
+        UE_LOG(LogAnimationStreaming, VeryVerbose, TEXT("Rotation: (%f, %f, %f)"), Keyframe.Coordinates.GetRotation().X, Keyframe.Coordinates.GetRotation().Y, Keyframe.Coordinates.GetRotation().Z);
 
-FKeyframes UJsonManager::GetInitializedKeyFrameStruct(const FTransform& Coordinates, const int Frame)
-{
-    FKeyframes Keyframe;
-    Keyframe.Frame = Frame;
-    Keyframe.Coordinates = Coordinates;
+        UE_LOG(LogAnimationStreaming, VeryVerbose, TEXT("Location: (%f, %f, %f)"), Keyframe.Coordinates.GetLocation().X, Keyframe.Coordinates.GetLocation().Y, Keyframe.Coordinates.GetLocation().Z);
 
-    return Keyframe;
+        UE_LOG(LogAnimationStreaming, VeryVerbose, TEXT("Scale: (%f, %f, %f)"), Keyframe.Coordinates.GetScale3D().X, Keyframe.Coordinates.GetScale3D().Y, Keyframe.Coordinates.GetScale3D().Z);
+    }
 }
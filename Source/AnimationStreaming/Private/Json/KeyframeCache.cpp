@@ -0,0 +1,446 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Json/KeyframeCache.h"
+
+#include "HAL/PlatformFileManager.h"
+#include "HAL/FileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Hash/xxhash.h"
+#include "Math/KeyframeVectorMath.h"
+#include "Misc/MemStack.h"
+#include "AnimationStreaming.h"
+
+
+namespace KeyframeCache
+{
+    //Read size of the streamed source hash.
+    constexpr int64 HashChunkSize{ 1024 * 1024 };
+    constexpr int64 DataAlignment{ 16 };
+
+    int64 AlignOffset(const int64 Offset)
+    {
+        return Align(Offset, DataAlignment);
+    }
+
+    void WritePadding(TArray<uint8>& Buffer, const int64 Offset)
+    {
+        Buffer.AddZeroed(static_cast<int32>(Offset - Buffer.Num()));
+    }
+
+    template <typename T>
+    void WriteValue(TArray<uint8>& Buffer, const T& Value)
+    {
+        Buffer.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+    }
+}
+
+FString FKeyframeCache::GetCachePath(const FString& SourcePath)
+{
+    return SourcePath + TEXT(".kfcache");
+}
+
+bool FKeyframeCache::Write(const FString& SourcePath, TArrayView<const uint8> SourceBytes, const TMap<FString, FKeyframeTrackSoA>& Controls)
+{
+    return WriteSidecar(SourcePath, SourceBytes, Controls, true);
+}
+
+bool FKeyframeCache::Merge(const FString& SourcePath, TArrayView<const uint8> SourceBytes, const TMap<FString, FKeyframeTrackSoA>& Controls)
+{
+    TMap<FString, FKeyframeTrackSoA> Merged{ Controls };
+    bool bComplete{ false };
+    {
+        //A stale or missing sidecar is replaced by a partial one.
+        FKeyframeCacheView View;
+        if (View.Open(SourcePath))
+        {
+            bComplete = View.IsComplete();
+            for (const FKeyframeCacheControlView& Control : View.GetControls())
+            {
+                const FUTF8ToTCHAR Name{ Control.Name.GetData(), Control.Name.Len() };
+                const FString ControlName{ Name.Length(), Name.Get() };
+                if (Merged.Contains(ControlName))
+                {
+                    continue;
+                }
+
+                FKeyframeTrackSoA& Track{ Merged.Add(ControlName) };
+                Track.Frames.Append(Control.Frames.GetData(), Control.Num());
+                for (int Channel = 0; Channel < NumChannels; ++Channel)
+                {
+                    Track.GetChannel(Channel).Append(Control.Channels[Channel].GetData(), Control.Num());
+                }
+            }
+
+            //Every control is already cached, nothing to rewrite.
+            if (Merged.Num() == View.GetControls().Num() && bComplete)
+            {
+                return true;
+            }
+        }
+        //The mapping is closed here, before the sidecar is replaced.
+    }
+
+    return WriteSidecar(SourcePath, SourceBytes, Merged, bComplete);
+}
+
+bool FKeyframeCache::WriteSidecar(const FString& SourcePath, TArrayView<const uint8> SourceBytes, const TMap<FString, FKeyframeTrackSoA>& Controls, const bool bComplete)
+{
+    IPlatformFile& PlatformFile{ FPlatformFileManager::Get().GetPlatformFile() };
+    const FFileStatData SourceStat{ PlatformFile.GetStatData(*SourcePath) };
+    if (!SourceStat.bIsValid || SourceStat.FileSize != SourceBytes.Num())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FKeyframeCache::Write is failed: Source changed while parsing - '%s'"), *SourcePath);
+        return false;
+    }
+
+    FKeyframeCacheHeader Header;
+    Header.SourceSize = SourceStat.FileSize;
+    Header.SourceTimestamp = SourceStat.ModificationTime.GetTicks();
+    Header.SourceHash = FXxHash64::HashBuffer(SourceBytes.GetData(), SourceBytes.Num()).Hash;
+    Header.NumControls = Controls.Num();
+    Header.Flags = bComplete ? FKeyframeCacheHeader::CompleteFlag : 0;
+
+    //Control names
+    TArray<TArray<uint8>> Names;
+    Names.Reserve(Controls.Num());
+    for (const TPair<FString, FKeyframeTrackSoA>& Control : Controls)
+    {
+        const FTCHARToUTF8 Name{ *Control.Key };
+        Names.Emplace(reinterpret_cast<const uint8*>(Name.Get()), Name.Length());
+    }
+
+    //Offsets: header, table, names, then aligned data blocks.
+    TArray<FKeyframeCacheControlEntry> Entries;
+    Entries.SetNum(Controls.Num());
+    int64 Offset{ static_cast<int64>(sizeof(FKeyframeCacheHeader) + sizeof(FKeyframeCacheControlEntry) * Controls.Num()) };
+    for (int32 Index = 0; Index < Names.Num(); ++Index)
+    {
+        Entries[Index].NameOffset = Offset;
+        Entries[Index].NameLength = Names[Index].Num();
+        Offset += Names[Index].Num();
+    }
+
+    int32 ControlIndex{ 0 };
+    for (const TPair<FString, FKeyframeTrackSoA>& Control : Controls)
+    {
+        Offset = KeyframeCache::AlignOffset(Offset);
+        Entries[ControlIndex].DataOffset = Offset;
+        Entries[ControlIndex].NumFrames = Control.Value.Num();
+        Offset += KeyframeCache::AlignOffset(sizeof(int32) * Control.Value.Num());
+        Offset += KeyframeCache::AlignOffset(sizeof(float) * Control.Value.Num()) * NumChannels;
+        ++ControlIndex;
+    }
+
+    if (Offset > MAX_int32)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FKeyframeCache::Write is failed: Cache would exceed 2GB - '%s'"), *SourcePath);
+        return false;
+    }
+
+    TArray<uint8> Buffer;
+    Buffer.Reserve(static_cast<int32>(Offset));
+    KeyframeCache::WriteValue(Buffer, Header);
+    for (const FKeyframeCacheControlEntry& Entry : Entries)
+    {
+        KeyframeCache::WriteValue(Buffer, Entry);
+    }
+    for (const TArray<uint8>& Name : Names)
+    {
+        Buffer.Append(Name);
+    }
+
+    ControlIndex = 0;
+    for (const TPair<FString, FKeyframeTrackSoA>& Control : Controls)
+    {
+        const FKeyframeTrackSoA& Track{ Control.Value };
+        check(Track.IsConsistent());
+        KeyframeCache::WritePadding(Buffer, static_cast<int64>(Entries[ControlIndex++].DataOffset));
+        Buffer.Append(reinterpret_cast<const uint8*>(Track.Frames.GetData()), Track.Num() * sizeof(int32));
+
+        //SoA in memory and on disk, every channel is one contiguous copy.
+        for (int Channel = 0; Channel < NumChannels; ++Channel)
+        {
+            const TArray<float>& Values{ Track.GetChannel(Channel) };
+            KeyframeCache::WritePadding(Buffer, KeyframeCache::AlignOffset(Buffer.Num()));
+            Buffer.Append(reinterpret_cast<const uint8*>(Values.GetData()), Values.Num() * sizeof(float));
+        }
+    }
+    KeyframeCache::WritePadding(Buffer, KeyframeCache::AlignOffset(Buffer.Num()));
+
+    //Write next to the final path and swap, readers never see a partial file.
+    const FString CachePath{ GetCachePath(SourcePath) };
+    const FString TempPath{ CachePath + TEXT(".tmp") };
+    TUniquePtr<FArchive> Writer{ IFileManager::Get().CreateFileWriter(*TempPath) };
+    if (!Writer)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FKeyframeCache::Write is failed: Can't open - '%s'"), *TempPath);
+        return false;
+    }
+    Writer->Serialize(Buffer.GetData(), Buffer.Num());
+    const bool bWritten{ Writer->Close() };
+    Writer.Reset();
+
+    if (!bWritten || !IFileManager::Get().Move(*CachePath, *TempPath, true, true))
+    {
+        IFileManager::Get().Delete(*TempPath);
+        UE_LOG(LogTemp, Warning, TEXT("FKeyframeCache::Write is failed: Can't write - '%s'"), *CachePath);
+        return false;
+    }
+
+    return true;
+}
+
+FKeyframeCacheView::FKeyframeCacheView() = default;
+
+FKeyframeCacheView::~FKeyframeCacheView()
+{
+    Close();
+}
+
+bool FKeyframeCacheView::Open(const FString& SourcePath)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FKeyframeCacheView::Open);
+    SCOPE_CYCLE_COUNTER(STAT_AnimationStreaming_Read);
+    Close();
+
+    IPlatformFile& PlatformFile{ FPlatformFileManager::Get().GetPlatformFile() };
+    const FString CachePath{ FKeyframeCache::GetCachePath(SourcePath) };
+    const FFileStatData SourceStat{ PlatformFile.GetStatData(*SourcePath) };
+    if (!SourceStat.bIsValid || !PlatformFile.FileExists(*CachePath))
+    {
+        return false;
+    }
+
+    MappedFile.Reset(PlatformFile.OpenMapped(*CachePath));
+    if (!MappedFile || MappedFile->GetFileSize() < static_cast<int64>(sizeof(FKeyframeCacheHeader)))
+    {
+        Close();
+        return false;
+    }
+
+    Region.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+    if (!Region)
+    {
+        Close();
+        return false;
+    }
+
+    const uint8* Data{ Region->GetMappedPtr() };
+    const int64 DataSize{ Region->GetMappedSize() };
+
+    FKeyframeCacheHeader Header;
+    FMemory::Memcpy(&Header, Data, sizeof(Header));
+    if (Header.Magic != FKeyframeCacheHeader::ExpectedMagic || Header.Version != FKeyframeCacheHeader::CurrentVersion)
+    {
+        Close();
+        return false;
+    }
+
+    //Cheap checks first, the hash streams the whole source.
+    uint64 SourceHash{ 0 };
+    if (Header.SourceSize != SourceStat.FileSize
+        || Header.SourceTimestamp != SourceStat.ModificationTime.GetTicks()
+        || !FKeyframeCache::ReadSourceHash(SourcePath, SourceHash)
+        || Header.SourceHash != SourceHash)
+    {
+        Close();
+        return false;
+    }
+
+    const int64 TableEnd{ static_cast<int64>(sizeof(FKeyframeCacheHeader) + sizeof(FKeyframeCacheControlEntry) * Header.NumControls) };
+    if (TableEnd > DataSize)
+    {
+        Close();
+        return false;
+    }
+
+    bComplete = (Header.Flags & FKeyframeCacheHeader::CompleteFlag) != 0;
+    Controls.Reserve(Header.NumControls);
+    for (uint32 ControlIndex = 0; ControlIndex < Header.NumControls; ++ControlIndex)
+    {
+        FKeyframeCacheControlEntry Entry;
+        FMemory::Memcpy(&Entry, Data + sizeof(FKeyframeCacheHeader) + sizeof(FKeyframeCacheControlEntry) * ControlIndex, sizeof(Entry));
+
+        const int64 NumFrames{ Entry.NumFrames };
+        const int64 FramesSize{ KeyframeCache::AlignOffset(sizeof(int32) * NumFrames) };
+        const int64 ChannelSize{ KeyframeCache::AlignOffset(sizeof(float) * NumFrames) };
+        if (Entry.NameOffset + Entry.NameLength > static_cast<uint64>(DataSize)
+            || static_cast<int64>(Entry.DataOffset) + FramesSize + ChannelSize * FKeyframeCache::NumChannels > DataSize)
+        {
+            Close();
+            return false;
+        }
+
+        FKeyframeCacheControlView& Control{ Controls.AddDefaulted_GetRef() };
+        Control.Name = FAnsiStringView{ reinterpret_cast<const ANSICHAR*>(Data + Entry.NameOffset), static_cast<int32>(Entry.NameLength) };
+        Control.Frames = TConstArrayView<int32>{ reinterpret_cast<const int32*>(Data + Entry.DataOffset), static_cast<int32>(NumFrames) };
+        for (int Channel = 0; Channel < FKeyframeCache::NumChannels; ++Channel)
+        {
+            Control.Channels[Channel] = TConstArrayView<float>{ reinterpret_cast<const float*>(Data + Entry.DataOffset + FramesSize + ChannelSize * Channel), static_cast<int32>(NumFrames) };
+        }
+    }
+
+    return true;
+}
+
+void FKeyframeCacheView::Close()
+{
+    Controls.Reset();
+    bComplete = false;
+    Region.Reset();
+    MappedFile.Reset();
+}
+
+const FKeyframeCacheControlView* FKeyframeCacheView::FindControl(const FString& ControlName) const
+{
+    const FTCHARToUTF8 ControlNameUtf8{ *ControlName };
+    const FAnsiStringView WantedName{ ControlNameUtf8.Get(), ControlNameUtf8.Length() };
+
+    return Controls.FindByPredicate([&WantedName](const FKeyframeCacheControlView& Control) { return Control.Name.Equals(WantedName, ESearchCase::IgnoreCase); });
+}
+
+bool FKeyframeCache::Load(const FString& SourcePath, const FString& ControlName, TArray<FKeyframes>& OutKeyframes)
+{
+    FKeyframeCacheView View;
+    const FKeyframeCacheControlView* Control{ View.Open(SourcePath) ? View.FindControl(ControlName) : nullptr };
+    if (Control == nullptr)
+    {
+        return false;
+    }
+
+    DecodeControl(*Control, OutKeyframes);
+
+    return true;
+}
+
+bool FKeyframeCache::Load(const FString& SourcePath, const FString& ControlName, FKeyframeTrackSoA& OutTrack)
+{
+    FKeyframeCacheView View;
+    const FKeyframeCacheControlView* Control{ View.Open(SourcePath) ? View.FindControl(ControlName) : nullptr };
+    if (Control == nullptr)
+    {
+        return false;
+    }
+
+    DecodeControl(*Control, OutTrack);
+
+    return true;
+}
+
+bool FKeyframeCache::LoadAll(const FString& SourcePath, TMap<FString, FKeyframeTrack>& OutControls)
+{
+    FKeyframeCacheView View;
+    //A sidecar written by single control loads would silently drop the other controls.
+    if (!View.Open(SourcePath) || !View.IsComplete() || View.GetControls().Num() == 0)
+    {
+        return false;
+    }
+
+    TMap<FString, FKeyframeTrack> Controls;
+    Controls.Reserve(View.GetControls().Num());
+    for (const FKeyframeCacheControlView& Control : View.GetControls())
+    {
+        const FUTF8ToTCHAR ControlName{ Control.Name.GetData(), Control.Name.Len() };
+        DecodeControl(Control, Controls.Add(FString(ControlName.Length(), ControlName.Get())).Keyframes);
+    }
+
+    OutControls = MoveTemp(Controls);
+
+    return true;
+}
+
+bool FKeyframeCache::LoadAll(const FString& SourcePath, TMap<FString, FKeyframeTrackSoA>& OutControls)
+{
+    FKeyframeCacheView View;
+    if (!View.Open(SourcePath) || !View.IsComplete() || View.GetControls().Num() == 0)
+    {
+        return false;
+    }
+
+    TMap<FString, FKeyframeTrackSoA> Controls;
+    Controls.Reserve(View.GetControls().Num());
+    for (const FKeyframeCacheControlView& Control : View.GetControls())
+    {
+        const FUTF8ToTCHAR ControlName{ Control.Name.GetData(), Control.Name.Len() };
+        DecodeControl(Control, Controls.Add(FString(ControlName.Length(), ControlName.Get())));
+    }
+
+    OutControls = MoveTemp(Controls);
+
+    return true;
+}
+
+void FKeyframeCache::DecodeControl(const FKeyframeCacheControlView& Control, FKeyframeTrackSoA& OutTrack)
+{
+    //Same layout as the mapped arrays, one memcpy per channel.
+    const int32 NumFrames{ Control.Num() };
+    OutTrack.SetNumUninitialized(NumFrames);
+    FMemory::Memcpy(OutTrack.Frames.GetData(), Control.Frames.GetData(), sizeof(int32) * NumFrames);
+    for (int Channel = 0; Channel < NumChannels; ++Channel)
+    {
+        FMemory::Memcpy(OutTrack.GetChannel(Channel).GetData(), Control.Channels[Channel].GetData(), sizeof(float) * NumFrames);
+    }
+}
+
+void FKeyframeCache::DecodeControl(const FKeyframeCacheControlView& Control, TArray<FKeyframes>& OutKeyframes)
+{
+    const int32 NumFrames{ Control.Num() };
+    const int32* Frames{ Control.Frames.GetData() };
+    const float* Channels[NumChannels];
+    for (int Channel = 0; Channel < NumChannels; ++Channel)
+    {
+        Channels[Channel] = Control.Channels[Channel].GetData();
+    }
+
+    FMemMark Mark{ FMemStack::Get() };
+    TArray<float, TMemStackAllocator<>> Quat[4];
+    for (TArray<float, TMemStackAllocator<>>& Component : Quat)
+    {
+        Component.SetNumUninitialized(NumFrames);
+    }
+    FKeyframeVectorMath::EulerToQuat(Channels[3], Channels[4], Channels[5], Quat[0].GetData(), Quat[1].GetData(), Quat[2].GetData(), Quat[3].GetData(), NumFrames);
+
+    OutKeyframes.Reset(NumFrames);
+    for (int32 Index = 0; Index < NumFrames; ++Index)
+    {
+        FKeyframes& Keyframe{ OutKeyframes.AddDefaulted_GetRef() };
+        Keyframe.Frame = Frames[Index];
+        Keyframe.Coordinates = FTransform
+        {
+            FQuat(Quat[0][Index], Quat[1][Index], Quat[2][Index], Quat[3][Index]),
+            FVector(Channels[0][Index], Channels[1][Index], Channels[2][Index]),
+            FVector(Channels[6][Index], Channels[7][Index], Channels[8][Index])
+        };
+    }
+}
+
+bool FKeyframeCache::ReadSourceHash(const FString& SourcePath, uint64& OutHash)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FKeyframeCache::ReadSourceHash);
+
+    TUniquePtr<IFileHandle> File{ FPlatformFileManager::Get().GetPlatformFile().OpenRead(*SourcePath) };
+    if (!File)
+    {
+        return false;
+    }
+
+    const int64 SourceSize{ File->Size() };
+    TArray<uint8> Chunk;
+    Chunk.SetNumUninitialized(static_cast<int32>(FMath::Min(KeyframeCache::HashChunkSize, FMath::Max<int64>(SourceSize, 1))));
+
+    FXxHash64Builder Hash;
+    for (int64 Offset = 0; Offset < SourceSize; Offset += Chunk.Num())
+    {
+        const int64 ReadSize{ FMath::Min<int64>(Chunk.Num(), SourceSize - Offset) };
+        if (!File->Read(Chunk.GetData(), ReadSize))
+        {
+            return false;
+        }
+        Hash.Update(Chunk.GetData(), ReadSize);
+    }
+
+    OutHash = Hash.Finalize().Hash;
+
+    return true;
+}
@@ -0,0 +1,186 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Json/KeyframeJsonChunkParser.h"
+
+#include "AnimationStreaming.h"
+
+
+FKeyframeJsonChunkParser::FKeyframeJsonChunkParser(const FString& InControlName, FKeyframeTrackSoA& InTrack)
+    : ControlName(InControlName)
+    , Track(InTrack)
+{
+    const FTCHARToUTF8 Utf8{ *InControlName };
+    ControlNameUtf8.Append(Utf8.Get(), Utf8.Length());
+}
+
+bool FKeyframeJsonChunkParser::Consume(TArrayView<const uint8> Chunk)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FKeyframeJsonChunkParser::Consume);
+    SCOPE_CYCLE_COUNTER(STAT_AnimationStreaming_Tokenize);
+
+    if (!Error.IsEmpty())
+    {
+        return false;
+    }
+
+    //Only structural characters outside of strings move the state, a byte order mark falls through.
+    for (int32 Index = 0; Index < Chunk.Num() && !bControlComplete; ++Index)
+    {
+        const ANSICHAR Character{ static_cast<ANSICHAR>(Chunk[Index]) };
+        ++BytesConsumed;
+
+        if (bCapturingEntry)
+        {
+            Pending.Add(Character);
+        }
+
+        if (bInString)
+        {
+            if (bEscaped)
+            {
+                bEscaped = false;
+            }
+            else if (Character == '\\')
+            {
+                bEscaped = true;
+            }
+            else if (Character == '"')
+            {
+                bInString = false;
+                if (bCapturingKey)
+                {
+                    bCapturingKey = false;
+                    bKeyMatches = FAnsiStringView(Pending.GetData(), Pending.Num()).Equals(FAnsiStringView(ControlNameUtf8.GetData(), ControlNameUtf8.Num()), ESearchCase::IgnoreCase);
+                }
+            }
+
+            if (bCapturingKey)
+            {
+                Pending.Add(Character);
+            }
+            continue;
+        }
+
+        switch (Character)
+        {
+        case '"':
+            bInString = true;
+            if (Depth == 1)
+            {
+                bCapturingKey = true;
+                Pending.Reset();
+            }
+            else if (Depth == 2 && bInControl && !bCapturingEntry)
+            {
+                bCapturingEntry = true;
+                Pending.Reset();
+                Pending.Add(Character);
+            }
+            break;
+
+        case '{':
+        case '[':
+            if (++Depth == 2)
+            {
+                bInControl = Character == '{' && bKeyMatches;
+                bKeyMatches = false;
+            }
+            break;
+
+        case '}':
+        case ']':
+            if (--Depth < 0)
+            {
+                return Fail(FString::Printf(TEXT("Unbalanced '%c' at byte %lld"), Character, static_cast<long long>(BytesConsumed - 1)));
+            }
+
+            if (bInControl && Depth == 2 && bCapturingEntry && !CompleteFrameEntry())
+            {
+                return false;
+            }
+
+            if (bInControl && Depth == 1)
+            {
+                //The closing brace belongs to the control, not to a half captured entry.
+                if (bCapturingEntry)
+                {
+                    Pending.Pop(false);
+                    if (!CompleteFrameEntry())
+                    {
+                        return false;
+                    }
+                }
+
+                bInControl = false;
+                bControlComplete = true;
+                BlockWriter.Flush(Track);
+            }
+            break;
+
+        case ',':
+            //A frame whose value is not an object, the entry parser reports it.
+            if (bInControl && Depth == 2 && bCapturingEntry)
+            {
+                Pending.Pop(false);
+                if (!CompleteFrameEntry())
+                {
+                    return false;
+                }
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return true;
+}
+
+bool FKeyframeJsonChunkParser::Finish()
+{
+    if (!Error.IsEmpty())
+    {
+        return false;
+    }
+
+    if (!bControlComplete)
+    {
+        return Fail(bInControl ? TEXT("Unexpected end of frame object") : FString::Printf(TEXT("Failed to find '%s' object in JSON"), *ControlName));
+    }
+
+    BlockWriter.Flush(Track);
+
+    return true;
+}
+
+bool FKeyframeJsonChunkParser::CompleteFrameEntry()
+{
+    FKeyframeJsonParser Parser{ Pending.GetData(), Pending.GetData() + Pending.Num() };
+    FKeyframeJsonParser::FParsedFrame Frame;
+    if (!Parser.ParseFrameEntry(Frame))
+    {
+        return Fail(FString::Printf(TEXT("Failed to parse '%s' frames - %s of the entry ending at byte %lld"), *ControlName, *Parser.GetError(), static_cast<long long>(BytesConsumed)));
+    }
+
+    if (BlockWriter.Add(Frame))
+    {
+        BlockWriter.Flush(Track);
+    }
+
+    bCapturingEntry = false;
+    Pending.Reset();
+
+    return true;
+}
+
+bool FKeyframeJsonChunkParser::Fail(const FString& Message)
+{
+    if (Error.IsEmpty())
+    {
+        Error = Message;
+    }
+
+    return false;
+}
@@ -0,0 +1,1023 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Json/KeyframeJsonParser.h"
+
+#include "Math/KeyframeVectorMath.h"
+#include "AnimationStreaming.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+
+
+namespace KeyframeJsonParser
+{
+    constexpr int32 MaxNumberLength{ 63 };
+
+    bool IsWhitespace(const ANSICHAR Character)
+    {
+        return Character == ' ' || Character == '\n' || Character == '\r' || Character == '\t';
+    }
+
+    bool IsNumberCharacter(const ANSICHAR Character)
+    {
+        return (Character >= '0' && Character <= '9') || Character == '-' || Character == '+' || Character == '.' || Character == 'e' || Character == 'E';
+    }
+
+    bool IsDigit(const ANSICHAR Character)
+    {
+        return Character >= '0' && Character <= '9';
+    }
+
+    int32 GetNumWorkers()
+    {
+        return FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+    }
+
+    //A few ranges per worker so uneven ranges still balance.
+    int32 GetNumRanges(const int64 Bytes, const int32 Requested)
+    {
+        if (Requested > 0)
+        {
+            return Requested;
+        }
+
+        return static_cast<int32>(FMath::Clamp<int64>(Bytes / FKeyframeJsonParser::MinRangeBytes, 1, GetNumWorkers() * 4));
+    }
+
+    void ResizeTo(TArray<FKeyframes>& OutKeyframes, const int32 Num)
+    {
+        OutKeyframes.SetNum(Num);
+    }
+
+    void ResizeTo(FKeyframeTrackSoA& OutTrack, const int32 Num)
+    {
+        OutTrack.SetNumUninitialized(Num);
+    }
+
+    TArray<FKeyframes>& GetFrameOutput(FKeyframeTrack& Track)
+    {
+        return Track.Keyframes;
+    }
+
+    FKeyframeTrackSoA& GetFrameOutput(FKeyframeTrackSoA& Track)
+    {
+        return Track;
+    }
+}
+
+FKeyframeJsonParser::FKeyframeJsonParser(const ANSICHAR* InBegin, const ANSICHAR* InEnd)
+    : Begin(InBegin)
+    , End(InEnd)
+    , Cursor(InBegin)
+{
+    //Skip UTF-8 byte order mark
+    if (End - Cursor >= 3 && static_cast<uint8>(Cursor[0]) == 0xEF && static_cast<uint8>(Cursor[1]) == 0xBB && static_cast<uint8>(Cursor[2]) == 0xBF)
+    {
+        Cursor += 3;
+    }
+}
+
+bool FKeyframeJsonParser::ParseControl(TArrayView<const uint8> Json, const FString& ControlName, TArray<FKeyframes>& OutKeyframes, FString& OutInfoMessage, const int32 NumRanges)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FKeyframeJsonParser::ParseControl);
+    SCOPE_CYCLE_COUNTER(STAT_AnimationStreaming_Tokenize);
+
+    const ANSICHAR* Data{ reinterpret_cast<const ANSICHAR*>(Json.GetData()) };
+    FKeyframeJsonParser Parser{ Data, Data + Json.Num() };
+
+    const FTCHARToUTF8 ControlNameUtf8{ *ControlName };
+    if (!Parser.FindTopLevelMember(FAnsiStringView(ControlNameUtf8.Get(), ControlNameUtf8.Length())))
+    {
+        OutInfoMessage = FString::Printf(TEXT("Failed to find '%s' object in JSON - %s"), *ControlName, *Parser.GetError());
+        return false;
+    }
+
+    if (!Parser.ParseFrameObjectInRanges(KeyframeJsonParser::GetNumRanges(Json.Num() - Parser.GetOffset(), NumRanges), OutKeyframes))
+    {
+        OutInfoMessage = FString::Printf(TEXT("Failed to parse '%s' frames - %s"), *ControlName, *Parser.GetError());
+        return false;
+    }
+
+    return true;
+}
+
+bool FKeyframeJsonParser::ParseControl(TArrayView<const uint8> Json, const FString& ControlName, FKeyframeTrackSoA& OutTrack, FString& OutInfoMessage, const int32 NumRanges)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FKeyframeJsonParser::ParseControl);
+    SCOPE_CYCLE_COUNTER(STAT_AnimationStreaming_Tokenize);
+
+    const ANSICHAR* Data{ reinterpret_cast<const ANSICHAR*>(Json.GetData()) };
+    FKeyframeJsonParser Parser{ Data, Data + Json.Num() };
+
+    const FTCHARToUTF8 ControlNameUtf8{ *ControlName };
+    if (!Parser.FindTopLevelMember(FAnsiStringView(ControlNameUtf8.Get(), ControlNameUtf8.Length())))
+    {
+        OutInfoMessage = FString::Printf(TEXT("Failed to find '%s' object in JSON - %s"), *ControlName, *Parser.GetError());
+        return false;
+    }
+
+    if (!Parser.ParseFrameObjectInRanges(KeyframeJsonParser::GetNumRanges(Json.Num() - Parser.GetOffset(), NumRanges), OutTrack))
+    {
+        OutInfoMessage = FString::Printf(TEXT("Failed to parse '%s' frames - %s"), *ControlName, *Parser.GetError());
+        return false;
+    }
+
+    return true;
+}
+
+bool FKeyframeJsonParser::ParseAllControls(TArrayView<const uint8> Json, TMap<FString, FKeyframeTrack>& OutControls, FString& OutInfoMessage)
+{
+    return ParseAllControlsImpl(Json, OutControls, OutInfoMessage);
+}
+
+bool FKeyframeJsonParser::ParseAllControls(TArrayView<const uint8> Json, TMap<FString, FKeyframeTrackSoA>& OutControls, FString& OutInfoMessage)
+{
+    return ParseAllControlsImpl(Json, OutControls, OutInfoMessage);
+}
+
+template <typename TrackType>
+bool FKeyframeJsonParser::ParseAllControlsImpl(TArrayView<const uint8> Json, TMap<FString, TrackType>& OutControls, FString& OutInfoMessage)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FKeyframeJsonParser::ParseAllControls);
+    SCOPE_CYCLE_COUNTER(STAT_AnimationStreaming_Tokenize);
+
+    const ANSICHAR* Data{ reinterpret_cast<const ANSICHAR*>(Json.GetData()) };
+    FKeyframeJsonParser Parser{ Data, Data + Json.Num() };
+
+    TArray<FMemberRange> Members;
+    if (!Parser.ScanTopLevelMembers(Members))
+    {
+        OutInfoMessage = FString::Printf(TEXT("Failed to scan controls in JSON - %s"), *Parser.GetError());
+        return false;
+    }
+
+    TArray<TrackType> Tracks;
+    TArray<FString> Errors;
+    Tracks.SetNum(Members.Num());
+    Errors.SetNum(Members.Num());
+    const auto ParseMember = [&Members, &Tracks, &Errors, Data](const int32 MemberIndex, const int32 NumRanges)
+    {
+        const FMemberRange& Member{ Members[MemberIndex] };
+        FKeyframeJsonParser ControlParser{ Data + Member.ValueBegin, Data + Member.ValueEnd };
+
+        if (!ControlParser.ParseFrameObjectInRanges(NumRanges, KeyframeJsonParser::GetFrameOutput(Tracks[MemberIndex])))
+        {
+            Errors[MemberIndex] = FString::Printf(TEXT("Failed to parse '%s' frames - %s"), *Member.Name, *ControlParser.GetError());
+        }
+    };
+
+    if (Members.Num() < KeyframeJsonParser::GetNumWorkers())
+    {
+        //Too few controls to keep the workers busy, each control is split into ranges instead.
+        for (int32 MemberIndex = 0; MemberIndex < Members.Num(); ++MemberIndex)
+        {
+            ParseMember(MemberIndex, KeyframeJsonParser::GetNumRanges(Members[MemberIndex].ValueEnd - Members[MemberIndex].ValueBegin, 0));
+        }
+    }
+    else
+    {
+        //Controls are independent byte ranges, each one is parsed on its own task.
+        ParallelFor(Members.Num(), [&ParseMember](const int32 MemberIndex)
+        {
+            ParseMember(MemberIndex, 1);
+        });
+    }
+
+    for (const FString& Error : Errors)
+    {
+        if (!Error.IsEmpty())
+        {
+            OutInfoMessage = Error;
+            return false;
+        }
+    }
+
+    OutControls.Reset();
+    OutControls.Reserve(Members.Num());
+    for (int32 MemberIndex = 0; MemberIndex < Members.Num(); ++MemberIndex)
+    {
+        OutControls.Add(Members[MemberIndex].Name, MoveTemp(Tracks[MemberIndex]));
+    }
+
+    return true;
+}
+
+bool FKeyframeJsonParser::ScanTopLevelMembers(TArray<FMemberRange>& OutMembers)
+{
+    if (!Expect('{'))
+    {
+        return false;
+    }
+
+    SkipWhitespace();
+    if (Cursor < End && *Cursor == '}')
+    {
+        ++Cursor;
+        return true;
+    }
+
+    while (Cursor < End)
+    {
+        FAnsiStringView Key;
+        if (!ParseString(Key) || !Expect(':'))
+        {
+            return false;
+        }
+
+        SkipWhitespace();
+        const int64 ValueBegin{ GetOffset() };
+        const bool bIsObject{ Cursor < End && *Cursor == '{' };
+        if (!SkipValue())
+        {
+            return false;
+        }
+
+        //Non-object members (metadata, version strings) are not controls.
+        if (bIsObject)
+        {
+            const FUTF8ToTCHAR Name{ Key.GetData(), Key.Len() };
+            FMemberRange& Member{ OutMembers.AddDefaulted_GetRef() };
+            Member.Name = FString(Name.Length(), Name.Get());
+            Member.ValueBegin = ValueBegin;
+            Member.ValueEnd = GetOffset();
+        }
+
+        SkipWhitespace();
+        if (Cursor < End && *Cursor == ',')
+        {
+            ++Cursor;
+            continue;
+        }
+
+        return Expect('}');
+    }
+
+    return Fail(TEXT("Unexpected end of root object"));
+}
+
+bool FKeyframeJsonParser::FindTopLevelMember(const FAnsiStringView ControlName)
+{
+    SkipWhitespace();
+    if (!Expect('{'))
+    {
+        return false;
+    }
+
+    SkipWhitespace();
+    if (Cursor < End && *Cursor == '}')
+    {
+        return Fail(TEXT("Root object is empty"));
+    }
+
+    while (Cursor < End)
+    {
+        FAnsiStringView Key;
+        if (!ParseString(Key) || !Expect(':'))
+        {
+            return false;
+        }
+
+        SkipWhitespace();
+        if (Key.Equals(ControlName, ESearchCase::IgnoreCase))
+        {
+            return true;
+        }
+
+        if (!SkipValue())
+        {
+            return false;
+        }
+
+        SkipWhitespace();
+        if (Cursor < End && *Cursor == ',')
+        {
+            ++Cursor;
+            continue;
+        }
+
+        break;
+    }
+
+    return Fail(TEXT("Member is not found"));
+}
+
+int32 FKeyframeJsonParser::CountObjectMembers() const
+{
+    //Structural scan only: depth and string state, no values are parsed.
+    int32 Count{ 0 };
+    int32 Depth{ 0 };
+    for (const ANSICHAR* Scan = Cursor; Scan < End; ++Scan)
+    {
+        const ANSICHAR Character{ *Scan };
+        if (Character == '"')
+        {
+            for (++Scan; Scan < End && *Scan != '"'; ++Scan)
+            {
+                if (*Scan == '\\')
+                {
+                    ++Scan;
+                }
+            }
+        }
+        else if (Character == '{' || Character == '[')
+        {
+            ++Depth;
+        }
+        else if (Character == '}' || Character == ']')
+        {
+            if (--Depth == 0)
+            {
+                break;
+            }
+        }
+        else if (Character == ':' && Depth == 1)
+        {
+            ++Count;
+        }
+    }
+
+    return Count;
+}
+
+bool FKeyframeJsonParser::ParseFrameObject(TArray<FKeyframes>& OutKeyframes)
+{
+    return ParseFrameObjectImpl([&OutKeyframes](const FParsedFrame& Frame)
+    {
+        FKeyframes& Keyframe{ OutKeyframes.AddDefaulted_GetRef() };
+        Keyframe.Frame = Frame.Frame;
+        Keyframe.Coordinates = Frame.ToTransform();
+    });
+}
+
+bool FKeyframeJsonParser::ParseFrameObject(FKeyframeTrackSoA& OutTrack)
+{
+    FTrackBlockWriter Block;
+    const bool bParsed{ ParseFrameObjectImpl([&Block, &OutTrack](const FParsedFrame& Frame)
+    {
+        if (Block.Add(Frame))
+        {
+            Block.Flush(OutTrack);
+        }
+    }) };
+    Block.Flush(OutTrack);
+
+    return bParsed;
+}
+
+bool FKeyframeJsonParser::SplitFrameObject(const int64 TargetBytes, TArray<FEntryRange>& OutRanges)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FKeyframeJsonParser::SplitFrameObject);
+
+    if (!Expect('{'))
+    {
+        return false;
+    }
+
+    //Depth and string state only, like CountObjectMembers.
+    int64 RangeBegin{ GetOffset() };
+    int32 NumEntries{ 0 };
+    int32 Depth{ 1 };
+    for (; Cursor < End; ++Cursor)
+    {
+        const ANSICHAR Character{ *Cursor };
+        if (Character == '"')
+        {
+            for (++Cursor; Cursor < End && *Cursor != '"'; ++Cursor)
+            {
+                if (*Cursor == '\\')
+                {
+                    ++Cursor;
+                }
+            }
+
+            if (Cursor >= End)
+            {
+                return Fail(TEXT("Unterminated string"));
+            }
+        }
+        else if (Character == '{' || Character == '[')
+        {
+            ++Depth;
+        }
+        else if (Character == '}' || Character == ']')
+        {
+            if (--Depth == 0)
+            {
+                OutRanges.Add({ RangeBegin, GetOffset(), NumEntries });
+                ++Cursor;
+                return true;
+            }
+        }
+        else if (Character == ':' && Depth == 1)
+        {
+            ++NumEntries;
+        }
+        else if (Character == ',' && Depth == 1 && GetOffset() - RangeBegin >= TargetBytes)
+        {
+            OutRanges.Add({ RangeBegin, GetOffset(), NumEntries });
+            RangeBegin = GetOffset() + 1;
+            NumEntries = 0;
+        }
+    }
+
+    return Fail(TEXT("Unterminated frame object"));
+}
+
+bool FKeyframeJsonParser::ParseFrameEntries(TArray<FKeyframes>& OutKeyframes, const int32 Index, const int32 NumEntries)
+{
+    FKeyframes* Output{ OutKeyframes.GetData() + Index };
+    return ParseFrameEntriesImpl(NumEntries, [&Output](const FParsedFrame& Frame)
+    {
+        FKeyframes& Keyframe{ *Output++ };
+        Keyframe.Frame = Frame.Frame;
+        Keyframe.Coordinates = Frame.ToTransform();
+    });
+}
+
+bool FKeyframeJsonParser::ParseFrameEntries(FKeyframeTrackSoA& OutTrack, const int32 Index, const int32 NumEntries)
+{
+    FTrackBlockWriter Block;
+    int32 Written{ 0 };
+    const bool bParsed{ ParseFrameEntriesImpl(NumEntries, [&Block, &OutTrack, &Written, Index](const FParsedFrame& Frame)
+    {
+        if (Block.Add(Frame))
+        {
+            Block.FlushTo(OutTrack, Index + Written);
+            Written += FTrackBlockWriter::BlockSize;
+        }
+    }) };
+    Block.FlushTo(OutTrack, Index + Written);
+
+    return bParsed;
+}
+
+template <typename SinkType>
+bool FKeyframeJsonParser::ParseFrameEntriesImpl(const int32 NumEntries, SinkType&& Sink)
+{
+    SkipWhitespace();
+
+    FParsedFrame Frame;
+    int32 NumParsed{ 0 };
+    while (Cursor < End)
+    {
+        //The output slots were sized by the pre-scan, a mismatch means the scan and the parse disagree on the input.
+        if (NumParsed == NumEntries)
+        {
+            return Fail(TEXT("More frame entries than scanned"));
+        }
+
+        if (!ParseFrameEntry(Frame))
+        {
+            return false;
+        }
+        Sink(Frame);
+        ++NumParsed;
+
+        SkipWhitespace();
+        if (Cursor < End && *Cursor == ',')
+        {
+            ++Cursor;
+            continue;
+        }
+
+        if (Cursor < End)
+        {
+            return Fail(TEXT("Expected ','"));
+        }
+    }
+
+    return NumParsed == NumEntries || Fail(TEXT("Fewer frame entries than scanned"));
+}
+
+template <typename OutputType>
+bool FKeyframeJsonParser::ParseFrameObjectInRanges(const int32 NumRanges, OutputType& Output)
+{
+    //A failed parse leaves the output as it was.
+    const int32 OriginalNum{ Output.Num() };
+    if (NumRanges <= 1)
+    {
+        Output.Reserve(Output.Num() + CountObjectMembers());
+        if (!ParseFrameObject(Output))
+        {
+            KeyframeJsonParser::ResizeTo(Output, OriginalNum);
+            return false;
+        }
+
+        return true;
+    }
+
+    TArray<FEntryRange> Ranges;
+    if (!SplitFrameObject(FMath::Max<int64>((End - Cursor) / NumRanges, 1), Ranges))
+    {
+        return false;
+    }
+
+    //The pre-scan counted every entry, so the output grows once and each range parses into its own slots.
+    TArray<int32> RangeIndices;
+    RangeIndices.SetNumUninitialized(Ranges.Num());
+    int32 NumEntries{ Output.Num() };
+    for (int32 RangeIndex = 0; RangeIndex < Ranges.Num(); ++RangeIndex)
+    {
+        RangeIndices[RangeIndex] = NumEntries;
+        NumEntries += Ranges[RangeIndex].NumEntries;
+    }
+    KeyframeJsonParser::ResizeTo(Output, NumEntries);
+
+    TArray<FString> Errors;
+    Errors.SetNum(Ranges.Num());
+    ParallelFor(Ranges.Num(), [this, &Ranges, &RangeIndices, &Output, &Errors](const int32 RangeIndex)
+    {
+        const FEntryRange& Range{ Ranges[RangeIndex] };
+        FKeyframeJsonParser RangeParser{ Begin + Range.Begin, Begin + Range.End };
+        if (!RangeParser.ParseFrameEntries(Output, RangeIndices[RangeIndex], Range.NumEntries))
+        {
+            Errors[RangeIndex] = FString::Printf(TEXT("%s of the range at byte %lld"), *RangeParser.GetError(), static_cast<long long>(Range.Begin));
+        }
+    });
+
+    for (const FString& RangeError : Errors)
+    {
+        if (!RangeError.IsEmpty())
+        {
+            Error = RangeError;
+            KeyframeJsonParser::ResizeTo(Output, OriginalNum);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename SinkType>
+bool FKeyframeJsonParser::ParseFrameObjectImpl(SinkType&& Sink)
+{
+    if (!Expect('{'))
+    {
+        return false;
+    }
+
+    SkipWhitespace();
+    if (Cursor < End && *Cursor == '}')
+    {
+        ++Cursor;
+        return true;
+    }
+
+    FParsedFrame Frame;
+    while (Cursor < End)
+    {
+        if (!ParseFrameEntry(Frame))
+        {
+            return false;
+        }
+        Sink(Frame);
+
+        SkipWhitespace();
+        if (Cursor < End && *Cursor == ',')
+        {
+            ++Cursor;
+            continue;
+        }
+
+        return Expect('}');
+    }
+
+    return Fail(TEXT("Unexpected end of frame object"));
+}
+
+bool FKeyframeJsonParser::ParseFrameEntry(FKeyframes& OutKeyframe)
+{
+    FParsedFrame Frame;
+    if (!ParseFrameEntry(Frame))
+    {
+        return false;
+    }
+
+    OutKeyframe.Frame = Frame.Frame;
+    OutKeyframe.Coordinates = Frame.ToTransform();
+
+    return true;
+}
+
+bool FKeyframeJsonParser::FTrackBlockWriter::Add(const FParsedFrame& Frame)
+{
+    Frames[Num] = Frame.Frame;
+    for (int Axis = 0; Axis < 3; ++Axis)
+    {
+        Channels[Axis][Num] = Frame.Translation[Axis];
+        Channels[3 + Axis][Num] = Frame.Rotation[Axis];
+        Channels[6 + Axis][Num] = Frame.Scale[Axis];
+    }
+
+    return ++Num == BlockSize;
+}
+
+void FKeyframeJsonParser::FTrackBlockWriter::Flush(FKeyframeTrackSoA& OutTrack)
+{
+    if (Num == 0)
+    {
+        return;
+    }
+
+    const int32 Offset{ OutTrack.Num() };
+    OutTrack.SetNumUninitialized(Offset + Num);
+    FlushTo(OutTrack, Offset);
+}
+
+void FKeyframeJsonParser::FTrackBlockWriter::FlushTo(FKeyframeTrackSoA& OutTrack, const int32 Offset)
+{
+    if (Num == 0)
+    {
+        return;
+    }
+
+    //Narrowing stays in the caller's Tokenize scope, Convert only counts the channel key build.
+    check(Offset + Num <= OutTrack.Num());
+    FMemory::Memcpy(OutTrack.Frames.GetData() + Offset, Frames, Num * sizeof(int32));
+
+    int32 NumReplaced{ 0 };
+    for (int ChannelIndex = 0; ChannelIndex < FKeyframeTrackSoA::NumChannels; ++ChannelIndex)
+    {
+        NumReplaced += FKeyframeVectorMath::NarrowToFloat(Channels[ChannelIndex], OutTrack.GetChannel(ChannelIndex).GetData() + Offset, Num);
+    }
+
+    if (NumReplaced > 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Invalid value encountered during conversion to float: %d values replaced with 0."), NumReplaced);
+    }
+
+    Num = 0;
+}
+
+FTransform FKeyframeJsonParser::FParsedFrame::ToTransform() const
+{
+    return FTransform
+    {
+        FRotator(NarrowToFloat(Rotation[1]), NarrowToFloat(Rotation[2]), NarrowToFloat(Rotation[0])).Quaternion(),
+        FVector(NarrowToFloat(Translation[0]), NarrowToFloat(Translation[1]), NarrowToFloat(Translation[2])),
+        FVector(NarrowToFloat(Scale[0]), NarrowToFloat(Scale[1]), NarrowToFloat(Scale[2]))
+    };
+}
+
+bool FKeyframeJsonParser::ParseFrameEntry(FParsedFrame& OutFrame)
+{
+    FAnsiStringView Key;
+    if (!ParseString(Key) || !ParseFrameNumber(Key, OutFrame.Frame) || !Expect(':') || !Expect('{'))
+    {
+        return false;
+    }
+
+    //Json rotation is x = roll, y = pitch, z = yaw, which is already the parsed frame's order.
+    double (&Rotation)[3]{ OutFrame.Rotation };
+    double (&Translation)[3]{ OutFrame.Translation };
+    double (&Scale)[3]{ OutFrame.Scale };
+    for (int Axis = 0; Axis < 3; ++Axis)
+    {
+        Rotation[Axis] = 0.0;
+        Translation[Axis] = 0.0;
+        Scale[Axis] = 1.0;
+    }
+
+    SkipWhitespace();
+    if (Cursor < End && *Cursor == '}')
+    {
+        ++Cursor;
+    }
+    else
+    {
+        while (true)
+        {
+            FAnsiStringView Field;
+            if (!ParseString(Field) || !Expect(':'))
+            {
+                return false;
+            }
+
+            //Dispatch on length first, then compare the bytes.
+            //Names match case-insensitively like FJsonObject fields did.
+            bool bParsed{ false };
+            switch (Field.Len())
+            {
+            case 8:
+                bParsed = Field == ANSITEXTVIEW("rotation") ? ParseVector(Rotation) : SkipValue();
+                break;
+            case 11:
+                bParsed = Field == ANSITEXTVIEW("translation") ? ParseVector(Translation) : SkipValue();
+                break;
+            case 5:
+                bParsed = Field == ANSITEXTVIEW("scale") ? ParseVector(Scale) : SkipValue();
+                break;
+            default:
+                bParsed = SkipValue();
+                break;
+            }
+
+            if (!bParsed)
+            {
+                return false;
+            }
+
+            SkipWhitespace();
+            if (Cursor < End && *Cursor == ',')
+            {
+                ++Cursor;
+                continue;
+            }
+
+            if (!Expect('}'))
+            {
+                return false;
+            }
+            break;
+        }
+    }
+
+    return true;
+}
+
+void FKeyframeJsonParser::SkipWhitespace()
+{
+    while (Cursor < End && KeyframeJsonParser::IsWhitespace(*Cursor))
+    {
+        ++Cursor;
+    }
+}
+
+bool FKeyframeJsonParser::Expect(const ANSICHAR Character)
+{
+    SkipWhitespace();
+    if (Cursor >= End || *Cursor != Character)
+    {
+        return Fail(*FString::Printf(TEXT("Expected '%c'"), Character));
+    }
+
+    ++Cursor;
+    return true;
+}
+
+bool FKeyframeJsonParser::ParseString(FAnsiStringView& OutString)
+{
+    if (!Expect('"'))
+    {
+        return false;
+    }
+
+    //Keys are compared raw, escape sequences are skipped but not decoded.
+    const ANSICHAR* StringBegin{ Cursor };
+    while (Cursor < End && *Cursor != '"')
+    {
+        Cursor += *Cursor == '\\' ? 2 : 1;
+    }
+
+    if (Cursor >= End)
+    {
+        return Fail(TEXT("Unterminated string"));
+    }
+
+    OutString = FAnsiStringView(StringBegin, static_cast<int32>(Cursor - StringBegin));
+    ++Cursor;
+
+    return true;
+}
+
+bool FKeyframeJsonParser::IsValidNumber(const FAnsiStringView Number)
+{
+    int32 Index{ 0 };
+    if (Index < Number.Len() && Number[Index] == '-')
+    {
+        ++Index;
+    }
+
+    if (Index == Number.Len() || !KeyframeJsonParser::IsDigit(Number[Index]))
+    {
+        return false;
+    }
+    if (Number[Index++] != '0')
+    {
+        while (Index < Number.Len() && KeyframeJsonParser::IsDigit(Number[Index]))
+        {
+            ++Index;
+        }
+    }
+
+    if (Index < Number.Len() && Number[Index] == '.')
+    {
+        const int32 FractionStart{ ++Index };
+        while (Index < Number.Len() && KeyframeJsonParser::IsDigit(Number[Index]))
+        {
+            ++Index;
+        }
+        if (Index == FractionStart)
+        {
+            return false;
+        }
+    }
+
+    if (Index < Number.Len() && (Number[Index] == 'e' || Number[Index] == 'E'))
+    {
+        ++Index;
+        if (Index < Number.Len() && (Number[Index] == '+' || Number[Index] == '-'))
+        {
+            ++Index;
+        }
+        const int32 ExponentStart{ Index };
+        while (Index < Number.Len() && KeyframeJsonParser::IsDigit(Number[Index]))
+        {
+            ++Index;
+        }
+        if (Index == ExponentStart)
+        {
+            return false;
+        }
+    }
+
+    return Index == Number.Len();
+}
+
+bool FKeyframeJsonParser::ParseNumber(double& OutValue)
+{
+    SkipWhitespace();
+
+    ANSICHAR Buffer[KeyframeJsonParser::MaxNumberLength + 1];
+    int32 Length{ 0 };
+    while (Cursor < End && KeyframeJsonParser::IsNumberCharacter(*Cursor))
+    {
+        if (Length == KeyframeJsonParser::MaxNumberLength)
+        {
+            return Fail(TEXT("Number is too long"));
+        }
+        Buffer[Length++] = *Cursor++;
+    }
+
+    if (Length == 0)
+    {
+        return Fail(TEXT("Expected a number"));
+    }
+    if (!IsValidNumber(FAnsiStringView(Buffer, Length)))
+    {
+        return Fail(TEXT("Malformed number"));
+    }
+
+    Buffer[Length] = '\0';
+    OutValue = FCStringAnsi::Atod(Buffer);
+
+    return true;
+}
+
+bool FKeyframeJsonParser::ParseFrameNumber(const FAnsiStringView Key, int32& OutFrame)
+{
+    int64 Frame{ 0 };
+    bool bNegative{ false };
+    int32 Index{ 0 };
+    if (Key.Len() > 0 && Key[0] == '-')
+    {
+        bNegative = true;
+        Index = 1;
+    }
+
+    if (Index >= Key.Len())
+    {
+        return Fail(TEXT("Frame key is not a number"));
+    }
+
+    for (; Index < Key.Len(); ++Index)
+    {
+        const ANSICHAR Digit{ Key[Index] };
+        if (Digit < '0' || Digit > '9')
+        {
+            return Fail(TEXT("Frame key is not a number"));
+        }
+
+        Frame = Frame * 10 + (Digit - '0');
+        if (Frame > MAX_int32)
+        {
+            return Fail(TEXT("Frame key is out of range"));
+        }
+    }
+
+    OutFrame = static_cast<int32>(bNegative ? -Frame : Frame);
+
+    return true;
+}
+
+bool FKeyframeJsonParser::ParseVector(double (&OutComponents)[3])
+{
+    if (!Expect('{'))
+    {
+        return false;
+    }
+
+    SkipWhitespace();
+    if (Cursor < End && *Cursor == '}')
+    {
+        ++Cursor;
+        return true;
+    }
+
+    while (true)
+    {
+        FAnsiStringView Component;
+        if (!ParseString(Component) || !Expect(':'))
+        {
+            return false;
+        }
+
+        const int32 ComponentIndex{ Component.Len() == 1 ? FCharAnsi::ToLower(Component[0]) - 'x' : INDEX_NONE };
+        if (ComponentIndex >= 0 && ComponentIndex < 3)
+        {
+            if (!ParseNumber(OutComponents[ComponentIndex]))
+            {
+                return false;
+            }
+        }
+        else if (!SkipValue())
+        {
+            return false;
+        }
+
+        SkipWhitespace();
+        if (Cursor < End && *Cursor == ',')
+        {
+            ++Cursor;
+            continue;
+        }
+
+        return Expect('}');
+    }
+}
+
+bool FKeyframeJsonParser::SkipValue()
+{
+    SkipWhitespace();
+    if (Cursor >= End)
+    {
+        return Fail(TEXT("Unexpected end of input"));
+    }
+
+    if (*Cursor == '"')
+    {
+        FAnsiStringView Ignored;
+        return ParseString(Ignored);
+    }
+
+    if (*Cursor == '{' || *Cursor == '[')
+    {
+        int32 Depth{ 0 };
+        for (; Cursor < End; ++Cursor)
+        {
+            const ANSICHAR Character{ *Cursor };
+            if (Character == '"')
+            {
+                FAnsiStringView Ignored;
+                if (!ParseString(Ignored))
+                {
+                    return false;
+                }
+                --Cursor;
+            }
+            else if (Character == '{' || Character == '[')
+            {
+                ++Depth;
+            }
+            else if ((Character == '}' || Character == ']') && --Depth == 0)
+            {
+                ++Cursor;
+                return true;
+            }
+        }
+
+        return Fail(TEXT("Unterminated object"));
+    }
+
+    //Number, true, false or null
+    const ANSICHAR* ValueBegin{ Cursor };
+    while (Cursor < End && *Cursor != ',' && *Cursor != '}' && *Cursor != ']' && !KeyframeJsonParser::IsWhitespace(*Cursor))
+    {
+        ++Cursor;
+    }
+
+    return Cursor > ValueBegin || Fail(TEXT("Expected a value"));
+}
+
+bool FKeyframeJsonParser::Fail(const TCHAR* Message)
+{
+    if (Error.IsEmpty())
+    {
+        Error = FString::Printf(TEXT("%s at byte %lld"), Message, static_cast<long long>(GetOffset()));
+    }
+
+    return false;
+}
+
+float FKeyframeJsonParser::NarrowToFloat(const double Value)
+{
+    //Same rule as the batch kernel: anything that does not narrow to a finite float becomes 0.
+    const float Narrowed{ static_cast<float>(Value) };
+    if (FMath::Abs(Narrowed) <= FLT_MAX)
+    {
+        return Narrowed;
+    }
+
+    UE_LOG(LogTemp, Error, TEXT("Invalid value encountered during conversion to float."));
+    return 0.0f;
+}
@@ -0,0 +1,151 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Math/KeyframeVectorMath.h"
+
+
+namespace KeyframeVectorMath
+{
+    constexpr int32 NumLanes{ 4 };
+    constexpr float SingularityThreshold{ 0.4999995f };
+
+    //Wraps degrees into (-180, 180] like FRotator::NormalizeAxis.
+    VectorRegister4Float NormalizeAxis(const VectorRegister4Float& Degrees)
+    {
+        const VectorRegister4Float FullTurn{ VectorSetFloat1(360.0f) };
+        const VectorRegister4Float Wrapped{ VectorSubtract(Degrees, VectorMultiply(VectorFloor(VectorDivide(Degrees, FullTurn)), FullTurn)) };
+
+        return VectorSelect(VectorCompareGT(Wrapped, VectorSetFloat1(180.0f)), VectorSubtract(Wrapped, FullTurn), Wrapped);
+    }
+}
+
+int32 FKeyframeVectorMath::NarrowToFloat(const double* Source, float* Out, const int32 Num)
+{
+    const VectorRegister4Float MaxFloat{ VectorSetFloat1(FLT_MAX) };
+    const VectorRegister4Float Zero{ VectorZeroFloat() };
+
+    int32 NumReplaced{ 0 };
+    int32 Index{ 0 };
+    for (; Index + KeyframeVectorMath::NumLanes <= Num; Index += KeyframeVectorMath::NumLanes)
+    {
+        //Overflow narrows to inf, so a single magnitude test catches NaN, inf and out of range values.
+        const VectorRegister4Float Narrowed{ MakeVectorRegisterFloatFromDouble(VectorLoad(Source + Index)) };
+        const VectorRegister4Float ValidMask{ VectorCompareLE(VectorAbs(Narrowed), MaxFloat) };
+
+        VectorStore(VectorSelect(ValidMask, Narrowed, Zero), Out + Index);
+        NumReplaced += KeyframeVectorMath::NumLanes - FMath::CountBits(VectorMaskBits(ValidMask));
+    }
+
+    for (; Index < Num; ++Index)
+    {
+        const float Narrowed{ static_cast<float>(Source[Index]) };
+        const bool bValid{ FMath::Abs(Narrowed) <= FLT_MAX };
+
+        Out[Index] = bValid ? Narrowed : 0.0f;
+        NumReplaced += bValid ? 0 : 1;
+    }
+
+    return NumReplaced;
+}
+
+void FKeyframeVectorMath::EulerToQuat(const float* Roll, const float* Pitch, const float* Yaw, float* OutX, float* OutY, float* OutZ, float* OutW, const int32 Num)
+{
+    const VectorRegister4Float FullTurn{ VectorSetFloat1(360.0f) };
+    const VectorRegister4Float HalfDegreesToRadians{ VectorSetFloat1(UE_PI / 360.0f) };
+
+    int32 Index{ 0 };
+    for (; Index + KeyframeVectorMath::NumLanes <= Num; Index += KeyframeVectorMath::NumLanes)
+    {
+        //Same winding removal as FRotator::Quaternion before the half angles are taken.
+        const VectorRegister4Float HalfRoll{ VectorMultiply(VectorMod(VectorLoad(Roll + Index), FullTurn), HalfDegreesToRadians) };
+        const VectorRegister4Float HalfPitch{ VectorMultiply(VectorMod(VectorLoad(Pitch + Index), FullTurn), HalfDegreesToRadians) };
+        const VectorRegister4Float HalfYaw{ VectorMultiply(VectorMod(VectorLoad(Yaw + Index), FullTurn), HalfDegreesToRadians) };
+
+        VectorRegister4Float SR, CR, SP, CP, SY, CY;
+        VectorSinCos(&SR, &CR, &HalfRoll);
+        VectorSinCos(&SP, &CP, &HalfPitch);
+        VectorSinCos(&SY, &CY, &HalfYaw);
+
+        const VectorRegister4Float CRCP{ VectorMultiply(CR, CP) };
+        const VectorRegister4Float SRSP{ VectorMultiply(SR, SP) };
+        const VectorRegister4Float CRSP{ VectorMultiply(CR, SP) };
+        const VectorRegister4Float SRCP{ VectorMultiply(SR, CP) };
+
+        VectorStore(VectorSubtract(VectorMultiply(CRSP, SY), VectorMultiply(SRCP, CY)), OutX + Index);
+        VectorStore(VectorNegate(VectorMultiplyAdd(CRSP, CY, VectorMultiply(SRCP, SY))), OutY + Index);
+        VectorStore(VectorSubtract(VectorMultiply(CRCP, SY), VectorMultiply(SRSP, CY)), OutZ + Index);
+        VectorStore(VectorMultiplyAdd(CRCP, CY, VectorMultiply(SRSP, SY)), OutW + Index);
+    }
+
+    for (; Index < Num; ++Index)
+    {
+        const FQuat4f Quat{ FRotator3f(Pitch[Index], Yaw[Index], Roll[Index]).Quaternion() };
+        OutX[Index] = Quat.X;
+        OutY[Index] = Quat.Y;
+        OutZ[Index] = Quat.Z;
+        OutW[Index] = Quat.W;
+    }
+}
+
+void FKeyframeVectorMath::QuatToEuler(const float* X, const float* Y, const float* Z, const float* W, float* OutRoll, float* OutPitch, float* OutYaw, const int32 Num)
+{
+    const VectorRegister4Float One{ VectorOneFloat() };
+    const VectorRegister4Float Two{ VectorSetFloat1(2.0f) };
+    const VectorRegister4Float RadiansToDegrees{ VectorSetFloat1(180.0f / UE_PI) };
+    const VectorRegister4Float Threshold{ VectorSetFloat1(KeyframeVectorMath::SingularityThreshold) };
+    const VectorRegister4Float QuarterTurn{ VectorSetFloat1(90.0f) };
+
+    int32 Index{ 0 };
+    for (; Index + KeyframeVectorMath::NumLanes <= Num; Index += KeyframeVectorMath::NumLanes)
+    {
+        const VectorRegister4Float QX{ VectorLoad(X + Index) };
+        const VectorRegister4Float QY{ VectorLoad(Y + Index) };
+        const VectorRegister4Float QZ{ VectorLoad(Z + Index) };
+        const VectorRegister4Float QW{ VectorLoad(W + Index) };
+
+        const VectorRegister4Float SingularityTest{ VectorSubtract(VectorMultiply(QZ, QX), VectorMultiply(QW, QY)) };
+        const VectorRegister4Float YawY{ VectorMultiply(Two, VectorMultiplyAdd(QW, QZ, VectorMultiply(QX, QY))) };
+        const VectorRegister4Float YawX{ VectorSubtract(One, VectorMultiply(Two, VectorMultiplyAdd(QY, QY, VectorMultiply(QZ, QZ)))) };
+        const VectorRegister4Float Yaw{ VectorMultiply(VectorATan2(YawY, YawX), RadiansToDegrees) };
+
+        //Regular case, the asin input is clamped so lanes headed for the singular branches stay finite.
+        const VectorRegister4Float SinPitch{ VectorMin(VectorMax(VectorMultiply(Two, SingularityTest), VectorNegate(One)), One) };
+        const VectorRegister4Float Pitch{ VectorMultiply(VectorASin(SinPitch), RadiansToDegrees) };
+        const VectorRegister4Float RollY{ VectorNegate(VectorMultiply(Two, VectorMultiplyAdd(QW, QX, VectorMultiply(QY, QZ)))) };
+        const VectorRegister4Float RollX{ VectorSubtract(One, VectorMultiply(Two, VectorMultiplyAdd(QX, QX, VectorMultiply(QY, QY)))) };
+        const VectorRegister4Float Roll{ VectorMultiply(VectorATan2(RollY, RollX), RadiansToDegrees) };
+
+        //Gimbal lock: pitch snaps to +-90 and roll is derived from yaw.
+        const VectorRegister4Float TwistDegrees{ VectorMultiply(VectorMultiply(Two, VectorATan2(QX, QW)), RadiansToDegrees) };
+        const VectorRegister4Float SouthMask{ VectorCompareLT(SingularityTest, VectorNegate(Threshold)) };
+        const VectorRegister4Float NorthMask{ VectorCompareGT(SingularityTest, Threshold) };
+        const VectorRegister4Float SouthRoll{ KeyframeVectorMath::NormalizeAxis(VectorSubtract(VectorNegate(Yaw), TwistDegrees)) };
+        const VectorRegister4Float NorthRoll{ KeyframeVectorMath::NormalizeAxis(VectorSubtract(Yaw, TwistDegrees)) };
+
+        VectorStore(VectorSelect(SouthMask, SouthRoll, VectorSelect(NorthMask, NorthRoll, Roll)), OutRoll + Index);
+        VectorStore(VectorSelect(SouthMask, VectorNegate(QuarterTurn), VectorSelect(NorthMask, QuarterTurn, Pitch)), OutPitch + Index);
+        VectorStore(Yaw, OutYaw + Index);
+    }
+
+    for (; Index < Num; ++Index)
+    {
+        const FRotator3f Rotation{ FQuat4f(X[Index], Y[Index], Z[Index], W[Index]).Rotator() };
+        OutRoll[Index] = Rotation.Roll;
+        OutPitch[Index] = Rotation.Pitch;
+        OutYaw[Index] = Rotation.Yaw;
+    }
+}
+
+void FKeyframeVectorMath::UnwindDegrees(float* Values, const int32 Num)
+{
+    //Every wrap shifts all later values, so this is a running offset rather than a per-lane operation.
+    float Offset{ 0.0f };
+    float PreviousRaw{ Num > 0 ? Values[0] : 0.0f };
+    for (int32 Index = 1; Index < Num; ++Index)
+    {
+        const float Raw{ Values[Index] };
+        Offset -= 360.0f * FMath::RoundToFloat((Raw - PreviousRaw) / 360.0f);
+        PreviousRaw = Raw;
+        Values[Index] = Raw + Offset;
+    }
+}
@@ -0,0 +1,237 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Playback/KeyframePlaybackComponent.h"
+
+#include "Format/KeyframeSource.h"
+#include "Components/SceneComponent.h"
+#include "GameFramework/Actor.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "AnimationStreaming.h"
+
+
+UKeyframePlaybackComponent::UKeyframePlaybackComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+    PrimaryComponentTick.bStartWithTickEnabled = true;
+}
+
+void UKeyframePlaybackComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    if (bAutoPlay)
+    {
+        Play();
+    }
+}
+
+UKeyframePlaybackComponent::FPlaybackTarget* UKeyframePlaybackComponent::FindOrAddTarget(AActor* Actor)
+{
+    if (!IsValid(Actor) || !IsValid(Actor->GetRootComponent()))
+    {
+        return nullptr;
+    }
+
+    USceneComponent* Component{ Actor->GetRootComponent() };
+    FPlaybackTarget* Target{ Targets.FindByPredicate([Component](const FPlaybackTarget& Each) { return Each.Component.Get() == Component; }) };
+    if (Target == nullptr)
+    {
+        Target = &Targets.AddDefaulted_GetRef();
+        Target->Component = Component;
+    }
+
+    Target->Hint = 0;
+
+    return Target;
+}
+
+void UKeyframePlaybackComponent::SetActorTrack(AActor* Actor, const TArray<FKeyframes>& Keyframes, bool& bOutSuccess)
+{
+    FPlaybackTarget* Target{ FindOrAddTarget(Actor) };
+    if (Target == nullptr)
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("SetActorTrack is failed: Actor or its root component is not valid"));
+
+        return;
+    }
+
+    Target->Track.Build(Keyframes);
+    UpdateRange();
+    bOutSuccess = true;
+}
+
+void UKeyframePlaybackComponent::SetActorTrackFromFile(AActor* Actor, const FString& FilePath, const FString& ControlName, bool& bOutSuccess, FString& OutInfoMessage)
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *FilePath))
+    {
+        bOutSuccess = false;
+        OutInfoMessage = FString::Printf(TEXT("SetActorTrackFromFile is failed: Can't read '%s'"), *FilePath);
+
+        return;
+    }
+
+    FKeyframeTrackSoA Track;
+    if (!FKeyframeSourceRegistry::Get().LoadControl(FilePath, Bytes, ControlName, Track, OutInfoMessage))
+    {
+        bOutSuccess = false;
+
+        return;
+    }
+
+    FPlaybackTarget* Target{ FindOrAddTarget(Actor) };
+    if (Target == nullptr)
+    {
+        bOutSuccess = false;
+        OutInfoMessage = TEXT("SetActorTrackFromFile is failed: Actor or its root component is not valid");
+
+        return;
+    }
+
+    Target->Track.Build(Track);
+    UpdateRange();
+    bOutSuccess = true;
+    OutInfoMessage = FString::Printf(TEXT("SetActorTrackFromFile is succeeded: %d keys of '%s'"), Target->Track.Num(), *ControlName);
+}
+
+void UKeyframePlaybackComponent::RemoveActor(AActor* Actor)
+{
+    const USceneComponent* Component{ IsValid(Actor) ? Actor->GetRootComponent() : nullptr };
+    Targets.RemoveAll([Component](const FPlaybackTarget& Each) { return !Each.Component.IsValid() || Each.Component.Get() == Component; });
+    UpdateRange();
+}
+
+void UKeyframePlaybackComponent::ClearActors()
+{
+    Targets.Reset();
+    Pose.Reset();
+    UpdateRange();
+}
+
+void UKeyframePlaybackComponent::Play()
+{
+    PlaybackFrame = FMath::Clamp(PlaybackFrame, static_cast<double>(FirstFrame), static_cast<double>(LastFrame));
+
+    //A finished one-shot restarts from the end it plays away from.
+    if (!bPlaying && !bLoop)
+    {
+        if (PlayRate >= 0.0f && PlaybackFrame >= LastFrame)
+        {
+            PlaybackFrame = FirstFrame;
+        }
+        else if (PlayRate < 0.0f && PlaybackFrame <= FirstFrame)
+        {
+            PlaybackFrame = LastFrame;
+        }
+    }
+
+    bPlaying = true;
+}
+
+void UKeyframePlaybackComponent::Stop()
+{
+    bPlaying = false;
+}
+
+void UKeyframePlaybackComponent::SetPlaybackFrame(double Frame)
+{
+    PlaybackFrame = Frame;
+    ApplyPose();
+}
+
+void UKeyframePlaybackComponent::UpdateRange()
+{
+    FirstFrame = MAX_int32;
+    LastFrame = MIN_int32;
+    for (const FPlaybackTarget& Target : Targets)
+    {
+        if (!Target.Track.IsEmpty())
+        {
+            FirstFrame = FMath::Min(FirstFrame, Target.Track.GetFirstFrame());
+            LastFrame = FMath::Max(LastFrame, Target.Track.GetLastFrame());
+        }
+    }
+
+    if (FirstFrame > LastFrame)
+    {
+        FirstFrame = 0;
+        LastFrame = 0;
+    }
+
+    //Tracks may start anywhere, the playhead follows them into range.
+    PlaybackFrame = FMath::Clamp(PlaybackFrame, static_cast<double>(FirstFrame), static_cast<double>(LastFrame));
+}
+
+void UKeyframePlaybackComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    if (!bPlaying || Targets.Num() == 0)
+    {
+        return;
+    }
+
+    PlaybackFrame += DeltaTime * PlayRate * FrameRate.AsDecimal();
+
+    const double Length{ static_cast<double>(LastFrame - FirstFrame) };
+    if (bLoop && Length > 0.0)
+    {
+        double Offset{ FMath::Fmod(PlaybackFrame - FirstFrame, Length) };
+        if (Offset < 0.0)
+        {
+            Offset += Length;
+        }
+        PlaybackFrame = FirstFrame + Offset;
+    }
+    else if ((PlayRate > 0.0f && PlaybackFrame >= LastFrame) || (PlayRate < 0.0f && PlaybackFrame <= FirstFrame))
+    {
+        PlaybackFrame = FMath::Clamp(PlaybackFrame, static_cast<double>(FirstFrame), static_cast<double>(LastFrame));
+        bPlaying = false;
+    }
+
+    ApplyPose();
+}
+
+void UKeyframePlaybackComponent::ApplyPose()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(UKeyframePlaybackComponent::ApplyPose);
+    SCOPE_CYCLE_COUNTER(STAT_AnimationStreaming_Playback);
+
+    Pose.SetNumUninitialized(Targets.Num());
+    {
+        //Tracks and hints are per target, the workers share nothing but the playhead.
+        const double Frame{ PlaybackFrame };
+        const int Interpolation{ KeyInterpolation };
+        ParallelFor(TEXT("KeyframePlayback.Evaluate"), Targets.Num(), FMath::Max(MinActorsPerTask, 1), [this, Frame, Interpolation](const int32 Index)
+        {
+            FPlaybackTarget& Target{ Targets[Index] };
+            Pose[Index] = Target.Track.Evaluate(Frame, Interpolation, Target.Hint);
+        });
+    }
+
+    //Scene components update bounds, overlaps and render state when moved, which is game thread work.
+    bool bHasStaleTargets{ false };
+    for (int32 Index = 0; Index < Targets.Num(); ++Index)
+    {
+        USceneComponent* Component{ Targets[Index].Component.Get() };
+        if (Component == nullptr)
+        {
+            bHasStaleTargets = true;
+            continue;
+        }
+
+        if (!Targets[Index].Track.IsEmpty())
+        {
+            Component->SetRelativeTransform(Pose[Index], false, nullptr, ETeleportType::TeleportPhysics);
+        }
+    }
+
+    if (bHasStaleTargets)
+    {
+        Targets.RemoveAll([](const FPlaybackTarget& Each) { return !Each.Component.IsValid(); });
+        UpdateRange();
+    }
+}
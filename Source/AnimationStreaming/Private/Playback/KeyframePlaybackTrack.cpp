@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Playback/KeyframePlaybackTrack.h"
+
+#include "Sequencer/KeyframeFrameIndex.h"
+#include "Algo/BinarySearch.h"
+
+
+namespace KeyframePlaybackTrack
+{
+    FTransform ToTransform(const FKeyframePlaybackKey& Key)
+    {
+        return FTransform{ FQuat(Key.Rotation), FVector(Key.Translation), FVector(Key.Scale) };
+    }
+}
+
+void FKeyframePlaybackTrack::Build(const FKeyframeTrackSoA& Track)
+{
+    const FKeyframeFrameIndex Index{ Track.Frames };
+
+    Frames.Reset(Index.Num());
+    Keys.Reset(Index.Num());
+    for (const int32 Source : Index.Order)
+    {
+        AddKey(Track.Frames[Source], Track.GetTransform(Source));
+    }
+}
+
+void FKeyframePlaybackTrack::Build(const TArray<FKeyframes>& Keyframes)
+{
+    TArray<int32> SourceFrames;
+    SourceFrames.SetNumUninitialized(Keyframes.Num());
+    for (int32 Index = 0; Index < Keyframes.Num(); ++Index)
+    {
+        SourceFrames[Index] = Keyframes[Index].Frame;
+    }
+
+    const FKeyframeFrameIndex Index{ SourceFrames };
+
+    Frames.Reset(Index.Num());
+    Keys.Reset(Index.Num());
+    for (const int32 Source : Index.Order)
+    {
+        AddKey(Keyframes[Source].Frame, Keyframes[Source].Coordinates);
+    }
+}
+
+void FKeyframePlaybackTrack::AddKey(const int32 Frame, const FTransform& Transform)
+{
+    FQuat4f Rotation{ Transform.GetRotation().GetNormalized() };
+    //Neighbouring keys on the same hemisphere, so slerp and squad take the short way.
+    if (Keys.Num() > 0 && (Keys.Last().Rotation | Rotation) < 0.0f)
+    {
+        Rotation = -Rotation;
+    }
+
+    Frames.Add(Frame);
+    Keys.Add({ FVector3f(Transform.GetLocation()), Rotation, FVector3f(Transform.GetScale3D()) });
+}
+
+int32 FKeyframePlaybackTrack::FindKey(const double Frame, int32& InOutHint) const
+{
+    const int32 Last{ Frames.Num() - 1 };
+    const auto Brackets = [this, Last, Frame](const int32 Key)
+    {
+        return Frames[Key] <= Frame && (Key == Last || Frame < Frames[Key + 1]);
+    };
+
+    //Playback moves forward by less than a key per tick most of the time.
+    const int32 Hint{ FMath::Clamp(InOutHint, 0, Last) };
+    if (Brackets(Hint))
+    {
+        InOutHint = Hint;
+    }
+    else if (Hint < Last && Brackets(Hint + 1))
+    {
+        InOutHint = Hint + 1;
+    }
+    else
+    {
+        InOutHint = FMath::Max(Algo::UpperBound(Frames, Frame) - 1, 0);
+    }
+
+    return InOutHint;
+}
+
+FTransform FKeyframePlaybackTrack::Evaluate(const double Frame, const int KeyInterpolation, int32& InOutHint) const
+{
+    if (Frames.Num() == 0)
+    {
+        return FTransform::Identity;
+    }
+
+    const int32 Last{ Frames.Num() - 1 };
+    const int32 Key{ FindKey(Frame, InOutHint) };
+    const FKeyframePlaybackKey& A{ Keys[Key] };
+    if (Key == Last || Frame <= Frames[Key] || (KeyInterpolation != 0 && KeyInterpolation != 1))
+    {
+        return KeyframePlaybackTrack::ToTransform(A);
+    }
+
+    const FKeyframePlaybackKey& B{ Keys[Key + 1] };
+    const float Duration{ static_cast<float>(Frames[Key + 1] - Frames[Key]) };
+    const float Alpha{ FMath::Clamp(static_cast<float>(Frame - Frames[Key]) / Duration, 0.0f, 1.0f) };
+
+    FKeyframePlaybackKey Result;
+    if (KeyInterpolation == 1)
+    {
+        Result.Translation = FMath::Lerp(A.Translation, B.Translation, Alpha);
+        Result.Rotation = FQuat4f::Slerp(A.Rotation, B.Rotation, Alpha);
+        Result.Scale = FMath::Lerp(A.Scale, B.Scale, Alpha);
+
+        return KeyframePlaybackTrack::ToTransform(Result);
+    }
+
+    //Catmull-Rom tangents over the uneven key spacing, scaled to this segment, end keys use one-sided differences.
+    const int32 Previous{ FMath::Max(Key - 1, 0) };
+    const int32 Next{ FMath::Min(Key + 2, Last) };
+    const auto Tangent = [this, Duration](const int32 Before, const int32 After, FVector3f FKeyframePlaybackKey::* Member)
+    {
+        return (Keys[After].*Member - Keys[Before].*Member) * (Duration / static_cast<float>(Frames[After] - Frames[Before]));
+    };
+
+    Result.Translation = FMath::CubicInterp(A.Translation, Tangent(Previous, Key + 1, &FKeyframePlaybackKey::Translation),
+        B.Translation, Tangent(Key, Next, &FKeyframePlaybackKey::Translation), Alpha);
+    Result.Scale = FMath::CubicInterp(A.Scale, Tangent(Previous, Key + 1, &FKeyframePlaybackKey::Scale),
+        B.Scale, Tangent(Key, Next, &FKeyframePlaybackKey::Scale), Alpha);
+
+    FQuat4f TangentA;
+    FQuat4f TangentB;
+    FQuat4f::CalcTangents(Keys[Previous].Rotation, A.Rotation, B.Rotation, 0.0f, TangentA);
+    FQuat4f::CalcTangents(A.Rotation, B.Rotation, Keys[Next].Rotation, 0.0f, TangentB);
+    Result.Rotation = FQuat4f::Squad(A.Rotation, TangentA, B.Rotation, TangentB, Alpha);
+
+    return KeyframePlaybackTrack::ToTransform(Result);
+}
@@ -0,0 +1,301 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Sequencer/KeyframeDeltaImport.h"
+
+#include "Runtime/LevelSequence/Public/LevelSequence.h"
+#include "Sections/MovieScene3DTransformSection.h"
+#include "Channels/MovieSceneDoubleChannel.h"
+
+#include "Algo/BinarySearch.h"
+#include "Hash/xxhash.h"
+#include "ProfilingDebugging/ScopedTimers.h"
+#include "AnimationStreaming.h"
+
+
+namespace KeyframeDeltaImport
+{
+    int32 FloorDivide(const int32 Value, const int32 Divisor)
+    {
+        return Value >= 0 ? Value / Divisor : (Value - Divisor + 1) / Divisor;
+    }
+}
+
+FKeyframeSectionHashes* UKeyframeSectionHashData::Find(const FGuid& BindingID, const FName SectionName)
+{
+    return Sections.FindByPredicate([&BindingID, SectionName](const FKeyframeSectionHashes& Hashes)
+    {
+        return Hashes.BindingID == BindingID && Hashes.SectionName == SectionName;
+    });
+}
+
+FKeyframeSectionHashes& UKeyframeSectionHashData::FindOrAdd(const FGuid& BindingID, const FName SectionName)
+{
+    if (FKeyframeSectionHashes* Hashes{ Find(BindingID, SectionName) })
+    {
+        return *Hashes;
+    }
+
+    FKeyframeSectionHashes& Hashes{ Sections.AddDefaulted_GetRef() };
+    Hashes.BindingID = BindingID;
+    Hashes.SectionName = SectionName;
+
+    return Hashes;
+}
+
+bool UKeyframeSectionHashData::Remove(const FGuid& BindingID, const FName SectionName)
+{
+    return Sections.RemoveAll([&BindingID, SectionName](const FKeyframeSectionHashes& Hashes)
+    {
+        return Hashes.BindingID == BindingID && Hashes.SectionName == SectionName;
+    }) > 0;
+}
+
+void FKeyframeDeltaImporter::HashBlocks(const FTransformChannelKeys& Keys, const int32 BlockTicks, TMap<int32, uint64>& OutBlocks)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FKeyframeDeltaImporter::HashBlocks);
+    check(!Keys.bReduced && BlockTicks > 0);
+
+    OutBlocks.Reset();
+    int32 Block{ INDEX_NONE };
+    FXxHash64Builder Builder;
+    for (int32 Index = 0; Index < Keys.Times.Num(); ++Index)
+    {
+        const int32 Tick{ Keys.Times[Index].Value };
+        const int32 KeyBlock{ KeyframeDeltaImport::FloorDivide(Tick, BlockTicks) };
+        if (Index == 0 || KeyBlock != Block)
+        {
+            if (Index > 0)
+            {
+                OutBlocks.Add(Block, Builder.Finalize().Hash);
+            }
+            Builder = FXxHash64Builder();
+            Block = KeyBlock;
+        }
+
+        Builder.Update(&Tick, sizeof(Tick));
+        for (const TArray<FMovieSceneDoubleValue>& ChannelValues : Keys.Values)
+        {
+            Builder.Update(&ChannelValues[Index].Value, sizeof(double));
+        }
+    }
+
+    if (Keys.Times.Num() > 0)
+    {
+        OutBlocks.Add(Block, Builder.Finalize().Hash);
+    }
+}
+
+void FKeyframeDeltaImporter::Reimport(FSequencerImportSession& Session, FTransformChannelKeys& Keys, bool& bOutSuccess, FKeyframeImportReport& Report, const int32 BlockFrames)
+{
+    check(IsInGameThread());
+    TRACE_CPUPROFILER_EVENT_SCOPE(FKeyframeDeltaImporter::Reimport);
+
+    ULevelSequence* LevelSequence{ Session.GetLevelSequence() };
+    UMovieScene3DTransformSection* Section{ Session.GetTransformSection() };
+    if (!Session.IsValid() || !IsValid(LevelSequence) || !IsValid(Section))
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("Reimport is failed: Section is not valid"));
+
+        return;
+    }
+
+    if (Keys.bReduced)
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("Reimport is failed: Reduced keys can not be hashed per block"));
+
+        return;
+    }
+
+    const int32 BlockTicks{ FMath::Max(Session.GetTimeMapping().ToTick(FMath::Max(BlockFrames, 1)).Value, 1) };
+    TMap<int32, uint64> NewBlocks;
+    {
+        FScopedDurationTimer ConvertTimer{ Report.ConvertSeconds };
+        HashBlocks(Keys, BlockTicks, NewBlocks);
+    }
+
+    UKeyframeSectionHashData* HashData{ LevelSequence->GetAssetUserData<UKeyframeSectionHashData>() };
+    const FKeyframeSectionHashes* StoredHashes{ HashData != nullptr ? HashData->Find(Session.GetBindingID(), Section->GetFName()) : nullptr };
+    bool bRewriteAll{ StoredHashes == nullptr || StoredHashes->BlockTicks != BlockTicks || StoredHashes->KeyInterpolation != Keys.KeyInterpolation };
+    for (int ChannelIndex = 0; !bRewriteAll && ChannelIndex < FSequencerImportSession::NumTransformChannels; ++ChannelIndex)
+    {
+        bRewriteAll = Session.GetChannel(ChannelIndex)->GetNumKeys() != StoredHashes->NumKeys;
+    }
+
+    //A block changed if its hash differs, or it exists in only one of the two imports.
+    TArray<int32> ChangedBlocks;
+    for (const TPair<int32, uint64>& NewBlock : NewBlocks)
+    {
+        const uint64* StoredHash{ StoredHashes != nullptr ? StoredHashes->Blocks.Find(NewBlock.Key) : nullptr };
+        if (bRewriteAll || StoredHash == nullptr || *StoredHash != NewBlock.Value)
+        {
+            ChangedBlocks.Add(NewBlock.Key);
+        }
+    }
+
+    if (StoredHashes != nullptr)
+    {
+        for (const TPair<int32, uint64>& StoredBlock : StoredHashes->Blocks)
+        {
+            if (!NewBlocks.Contains(StoredBlock.Key))
+            {
+                ChangedBlocks.Add(StoredBlock.Key);
+            }
+        }
+    }
+    ChangedBlocks.Sort();
+    Report.ChangedBlocks = ChangedBlocks.Num();
+
+    bOutSuccess = true;
+    if (ChangedBlocks.Num() == 0)
+    {
+        return;
+    }
+
+    //Neighbouring blocks collapse into one range.
+    TArray<TRange<FFrameNumber>> Ranges;
+    for (int32 Index = 0; Index < ChangedBlocks.Num(); ++Index)
+    {
+        const FFrameNumber Start{ ChangedBlocks[Index] * BlockTicks };
+        const FFrameNumber End{ (ChangedBlocks[Index] + 1) * BlockTicks };
+        if (Index > 0 && ChangedBlocks[Index - 1] + 1 == ChangedBlocks[Index])
+        {
+            Ranges.Last().SetUpperBoundValue(End);
+        }
+        else
+        {
+            Ranges.Add(TRange<FFrameNumber>(Start, End));
+        }
+    }
+
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(FKeyframeDeltaImporter::Modify);
+        SCOPE_CYCLE_COUNTER(STAT_AnimationStreaming_Modify);
+        FScopedDurationTimer ModifyTimer{ Report.ModifySeconds };
+
+        Section->Modify();
+    }
+
+    {
+        SCOPE_CYCLE_COUNTER(STAT_AnimationStreaming_ChannelWrite);
+        FScopedDurationTimer WriteTimer{ Report.ChannelWriteSeconds };
+        for (int ChannelIndex = 0; ChannelIndex < FSequencerImportSession::NumTransformChannels; ++ChannelIndex)
+        {
+            FMovieSceneDoubleChannel& Channel{ *Session.GetChannel(ChannelIndex) };
+            Report.KeysWritten += SpliceRanges(Channel, Ranges, Keys.Times, Keys.Values[ChannelIndex]);
+
+            if (Keys.KeyInterpolation == 0)
+            {
+                for (const TRange<FFrameNumber>& Range : Ranges)
+                {
+                    FSequencerImportSession::AutoSetTangents(Channel, Range.GetLowerBoundValue(), Range.GetUpperBoundValue() - 1);
+                }
+            }
+        }
+    }
+
+    if (HashData == nullptr)
+    {
+        HashData = NewObject<UKeyframeSectionHashData>(LevelSequence, NAME_None, RF_Transactional);
+        LevelSequence->AddAssetUserData(HashData);
+    }
+    HashData->Modify();
+
+    FKeyframeSectionHashes& Hashes{ HashData->FindOrAdd(Session.GetBindingID(), Section->GetFName()) };
+    Hashes.BlockTicks = BlockTicks;
+    Hashes.KeyInterpolation = Keys.KeyInterpolation;
+    Hashes.NumKeys = Session.GetChannel(0)->GetNumKeys();
+    Hashes.Blocks = MoveTemp(NewBlocks);
+}
+
+void FKeyframeDeltaImporter::InvalidateHashes(ULevelSequence* LevelSequence, const FGuid& BindingID, const UMovieSceneSection* Section)
+{
+    if (!IsValid(LevelSequence) || Section == nullptr)
+    {
+        return;
+    }
+
+    UKeyframeSectionHashData* HashData{ LevelSequence->GetAssetUserData<UKeyframeSectionHashData>() };
+    if (HashData == nullptr || HashData->Find(BindingID, Section->GetFName()) == nullptr)
+    {
+        return;
+    }
+
+    //Undoing the write brings the hashes back with the keys.
+    HashData->Modify();
+    HashData->Remove(BindingID, Section->GetFName());
+}
+
+int32 FKeyframeDeltaImporter::SpliceRanges(FMovieSceneDoubleChannel& Channel, TConstArrayView<TRange<FFrameNumber>> Ranges, const TArray<FFrameNumber>& Times, const TArray<FMovieSceneDoubleValue>& Values)
+{
+    check(Times.Num() == Values.Num());
+
+    TMovieSceneChannelData<FMovieSceneDoubleValue> ChannelData{ Channel.GetData() };
+    TArrayView<const FFrameNumber> ExistingTimes{ ChannelData.GetTimes() };
+    TArrayView<FMovieSceneDoubleValue> ExistingValues{ ChannelData.GetValues() };
+
+    //Value edits keep every key time, then only the keys inside the ranges are touched.
+    bool bSameTimes{ true };
+    for (int32 Index = 0; bSameTimes && Index < Ranges.Num(); ++Index)
+    {
+        const FFrameNumber Start{ Ranges[Index].GetLowerBoundValue() };
+        const FFrameNumber End{ Ranges[Index].GetUpperBoundValue() };
+        const int32 ExistingStart{ static_cast<int32>(Algo::LowerBound(ExistingTimes, Start)) };
+        const int32 NewStart{ static_cast<int32>(Algo::LowerBound(Times, Start)) };
+        const int32 Num{ static_cast<int32>(Algo::LowerBound(Times, End)) - NewStart };
+
+        bSameTimes = static_cast<int32>(Algo::LowerBound(ExistingTimes, End)) - ExistingStart == Num
+            && CompareItems(ExistingTimes.GetData() + ExistingStart, Times.GetData() + NewStart, Num);
+    }
+
+    int32 KeysWritten{ 0 };
+    if (bSameTimes)
+    {
+        for (const TRange<FFrameNumber>& Range : Ranges)
+        {
+            const int32 ExistingStart{ static_cast<int32>(Algo::LowerBound(ExistingTimes, Range.GetLowerBoundValue())) };
+            const int32 NewStart{ static_cast<int32>(Algo::LowerBound(Times, Range.GetLowerBoundValue())) };
+            const int32 Num{ static_cast<int32>(Algo::LowerBound(Times, Range.GetUpperBoundValue())) - NewStart };
+            for (int32 Index = 0; Index < Num; ++Index)
+            {
+                ExistingValues[ExistingStart + Index] = Values[NewStart + Index];
+            }
+            KeysWritten += Num;
+        }
+
+        return KeysWritten;
+    }
+
+    //Keys were added or removed, every later key moves anyway.
+    TArray<FFrameNumber> SplicedTimes;
+    TArray<FMovieSceneDoubleValue> SplicedValues;
+    SplicedTimes.Reserve(ExistingTimes.Num() + Times.Num());
+    SplicedValues.Reserve(ExistingTimes.Num() + Times.Num());
+
+    //Existing keys outside the ranges are copied in runs, keys inside are replaced by the new ones.
+    int32 ExistingIndex{ 0 };
+    for (const TRange<FFrameNumber>& Range : Ranges)
+    {
+        const FFrameNumber Start{ Range.GetLowerBoundValue() };
+        const FFrameNumber End{ Range.GetUpperBoundValue() };
+
+        const int32 KeptEnd{ static_cast<int32>(Algo::LowerBound(ExistingTimes, Start)) };
+        SplicedTimes.Append(ExistingTimes.GetData() + ExistingIndex, KeptEnd - ExistingIndex);
+        SplicedValues.Append(ExistingValues.GetData() + ExistingIndex, KeptEnd - ExistingIndex);
+        ExistingIndex = FMath::Max(ExistingIndex, static_cast<int32>(Algo::LowerBound(ExistingTimes, End)));
+
+        const int32 NewStart{ static_cast<int32>(Algo::LowerBound(Times, Start)) };
+        const int32 NewEnd{ static_cast<int32>(Algo::LowerBound(Times, End)) };
+        SplicedTimes.Append(Times.GetData() + NewStart, NewEnd - NewStart);
+        SplicedValues.Append(Values.GetData() + NewStart, NewEnd - NewStart);
+        KeysWritten += NewEnd - NewStart;
+    }
+    SplicedTimes.Append(ExistingTimes.GetData() + ExistingIndex, ExistingTimes.Num() - ExistingIndex);
+    SplicedValues.Append(ExistingValues.GetData() + ExistingIndex, ExistingValues.Num() - ExistingIndex);
+
+    Channel.Set(MoveTemp(SplicedTimes), MoveTemp(SplicedValues));
+
+    return KeysWritten;
+}
@@ -0,0 +1,210 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Sequencer/KeyframeFrameIndex.h"
+
+#include "Math/KeyframeVectorMath.h"
+
+
+namespace KeyframeFrameIndex
+{
+    constexpr int32 RadixBits{ 11 };
+    constexpr int32 RadixSize{ 1 << RadixBits };
+}
+
+FKeyframeTimeMapping::FKeyframeTimeMapping(const FFrameRate& InSourceRate, const FFrameRate& InTickResolution)
+    : SourceRate(InSourceRate)
+    , TickResolution(InTickResolution)
+{
+}
+
+FFrameNumber FKeyframeTimeMapping::ToTick(const int32 Frame) const
+{
+    return ToTickTime(FFrameTime(Frame)).RoundToFrame();
+}
+
+FFrameTime FKeyframeTimeMapping::ToTickTime(const FFrameTime& Frame) const
+{
+    return FFrameRate::TransformTime(Frame, SourceRate, TickResolution);
+}
+
+void FKeyframeFrameIndex::Build(TConstArrayView<int32> Frames)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FKeyframeFrameIndex::Build);
+
+    Order.Reset(Frames.Num());
+    Gaps.Reset();
+    NumDuplicates = 0;
+    FirstFrame = 0;
+    LastFrame = 0;
+    if (Frames.Num() == 0)
+    {
+        return;
+    }
+
+    int32 MinFrame{ Frames[0] };
+    int32 MaxFrame{ Frames[0] };
+    bool bSorted{ true };
+    for (int32 Index = 1; Index < Frames.Num(); ++Index)
+    {
+        MinFrame = FMath::Min(MinFrame, Frames[Index]);
+        MaxFrame = FMath::Max(MaxFrame, Frames[Index]);
+        bSorted &= Frames[Index - 1] <= Frames[Index];
+    }
+
+    //Sort scratch is released in one go when the mark goes out of scope.
+    FMemMark Mark{ FMemStack::Get() };
+    TArray<int32, TMemStackAllocator<>> Sorted;
+    if (bSorted)
+    {
+        Sorted.SetNumUninitialized(Frames.Num());
+        for (int32 Index = 0; Index < Frames.Num(); ++Index)
+        {
+            Sorted[Index] = Index;
+        }
+    }
+    else
+    {
+        RadixSort(Frames, MinFrame, MaxFrame, Sorted);
+    }
+
+    //The sort is stable, so the last of a run of equal frames is the last one parsed.
+    for (const int32 Index : Sorted)
+    {
+        if (Order.Num() > 0)
+        {
+            const int32 PreviousFrame{ Frames[Order.Last()] };
+            if (PreviousFrame == Frames[Index])
+            {
+                Order.Last() = Index;
+                ++NumDuplicates;
+                continue;
+            }
+
+            if (Frames[Index] > PreviousFrame + 1)
+            {
+                Gaps.Add({ PreviousFrame, Frames[Index] });
+            }
+        }
+        Order.Add(Index);
+    }
+
+    FirstFrame = MinFrame;
+    LastFrame = MaxFrame;
+}
+
+int32 FKeyframeFrameIndex::GetNumMissingFrames() const
+{
+    int32 NumMissing{ 0 };
+    for (const FGap& Gap : Gaps)
+    {
+        NumMissing += Gap.Before - Gap.After - 1;
+    }
+
+    return NumMissing;
+}
+
+void FKeyframeFrameIndex::Resample(const FKeyframeTrackSoA& Track, const FFrameRate& SourceRate, const FFrameRate& TargetRate, FKeyframeTrackSoA& OutTrack) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FKeyframeFrameIndex::Resample);
+    check(Track.IsConsistent());
+
+    OutTrack.Reset();
+    if (Order.Num() == 0)
+    {
+        return;
+    }
+
+    //Sorted channel copies, rotations unwound so interpolation never takes the long way round.
+    FMemMark Mark{ FMemStack::Get() };
+    TStaticArray<TArray<float, TMemStackAllocator<>>, FKeyframeTrackSoA::NumChannels> Sorted;
+    for (int ChannelIndex = 0; ChannelIndex < FKeyframeTrackSoA::NumChannels; ++ChannelIndex)
+    {
+        const TArray<float>& Source{ Track.GetChannel(ChannelIndex) };
+        Sorted[ChannelIndex].SetNumUninitialized(Order.Num());
+        for (int32 Index = 0; Index < Order.Num(); ++Index)
+        {
+            Sorted[ChannelIndex][Index] = Source[Order[Index]];
+        }
+
+        if (ChannelIndex >= 3 && ChannelIndex < 6)
+        {
+            FKeyframeVectorMath::UnwindDegrees(Sorted[ChannelIndex].GetData(), Order.Num());
+        }
+    }
+
+    const FFrameNumber FirstTarget{ FFrameRate::TransformTime(FFrameTime(FirstFrame), SourceRate, TargetRate).CeilToFrame() };
+    const FFrameNumber LastTarget{ FFrameRate::TransformTime(FFrameTime(LastFrame), SourceRate, TargetRate).FloorToFrame() };
+    const int32 NumTargets{ FMath::Max(LastTarget.Value - FirstTarget.Value + 1, 0) };
+    OutTrack.SetNumUninitialized(NumTargets);
+
+    //Target times only move forward, so the bracketing source pair is found with a cursor.
+    int32 Cursor{ 0 };
+    for (int32 Target = 0; Target < NumTargets; ++Target)
+    {
+        const FFrameNumber TargetFrame{ FirstTarget.Value + Target };
+        const FFrameTime SourceTime{ FFrameRate::TransformTime(FFrameTime(TargetFrame), TargetRate, SourceRate) };
+        const double SourceFrame{ SourceTime.AsDecimal() };
+        while (Cursor + 1 < Order.Num() && Track.Frames[Order[Cursor + 1]] <= SourceFrame)
+        {
+            ++Cursor;
+        }
+
+        const int32 Next{ FMath::Min(Cursor + 1, Order.Num() - 1) };
+        const int32 CursorFrame{ Track.Frames[Order[Cursor]] };
+        const int32 NextFrame{ Track.Frames[Order[Next]] };
+        const float Alpha{ NextFrame > CursorFrame ? static_cast<float>(FMath::Clamp((SourceFrame - CursorFrame) / (NextFrame - CursorFrame), 0.0, 1.0)) : 0.0f };
+
+        OutTrack.Frames[Target] = TargetFrame.Value;
+        for (int ChannelIndex = 0; ChannelIndex < FKeyframeTrackSoA::NumChannels; ++ChannelIndex)
+        {
+            OutTrack.GetChannel(ChannelIndex)[Target] = FMath::Lerp(Sorted[ChannelIndex][Cursor], Sorted[ChannelIndex][Next], Alpha);
+        }
+    }
+}
+
+void FKeyframeFrameIndex::RadixSort(TConstArrayView<int32> Frames, const int32 MinFrame, const int32 MaxFrame, TArray<int32, TMemStackAllocator<>>& OutOrder)
+{
+    const int32 Num{ Frames.Num() };
+    TArray<uint32, TMemStackAllocator<>> Keys;
+    TArray<uint32, TMemStackAllocator<>> ScratchKeys;
+    TArray<int32, TMemStackAllocator<>> ScratchOrder;
+    Keys.SetNumUninitialized(Num);
+    ScratchKeys.SetNumUninitialized(Num);
+    ScratchOrder.SetNumUninitialized(Num);
+    OutOrder.SetNumUninitialized(Num);
+    for (int32 Index = 0; Index < Num; ++Index)
+    {
+        Keys[Index] = static_cast<uint32>(static_cast<int64>(Frames[Index]) - MinFrame);
+        OutOrder[Index] = Index;
+    }
+
+    //Takes of up to 2048 frames sort in one pass, up to four million in two.
+    const uint32 Range{ static_cast<uint32>(static_cast<int64>(MaxFrame) - MinFrame) };
+    for (int32 Shift = 0; Shift < 32 && (Range >> Shift) != 0; Shift += KeyframeFrameIndex::RadixBits)
+    {
+        int32 Counts[KeyframeFrameIndex::RadixSize]{};
+        for (const uint32 Key : Keys)
+        {
+            ++Counts[(Key >> Shift) & (KeyframeFrameIndex::RadixSize - 1)];
+        }
+
+        int32 Offset{ 0 };
+        for (int32& Count : Counts)
+        {
+            const int32 BucketSize{ Count };
+            Count = Offset;
+            Offset += BucketSize;
+        }
+
+        for (int32 Index = 0; Index < Num; ++Index)
+        {
+            const int32 Destination{ Counts[(Keys[Index] >> Shift) & (KeyframeFrameIndex::RadixSize - 1)]++ };
+            ScratchKeys[Destination] = Keys[Index];
+            ScratchOrder[Destination] = OutOrder[Index];
+        }
+
+        Swap(Keys, ScratchKeys);
+        Swap(OutOrder, ScratchOrder);
+    }
+}
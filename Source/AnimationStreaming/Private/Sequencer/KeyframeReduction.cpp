@@ -0,0 +1,208 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Sequencer/KeyframeReduction.h"
+
+#include "Sequencer/SequencerImportSession.h"
+#include "Async/ParallelFor.h"
+#include "Misc/MemStack.h"
+
+
+void FKeyframeReducer::ReduceChannelKeys(FTransformChannelKeys& Keys, const FKeyframeReductionSettings& Settings)
+{
+    if (Keys.bReduced || Keys.Times.Num() < 2)
+    {
+        return;
+    }
+
+    //Channels are independent, reduce them side by side.
+    ParallelFor(FSequencerImportSession::NumTransformChannels, [&Keys, &Settings](const int32 ChannelIndex)
+    {
+        const double Tolerance{ ChannelIndex < 3 ? Settings.TranslationTolerance : ChannelIndex < 6 ? Settings.RotationTolerance : Settings.ScaleTolerance };
+
+        //Each worker has its own stack, the raw copy is gone when the channel is done.
+        FMemMark Mark{ FMemStack::Get() };
+        TArray<FMovieSceneDoubleValue>& ChannelValues{ Keys.Values[ChannelIndex] };
+        TArray<double, TMemStackAllocator<>> RawValues;
+        RawValues.SetNumUninitialized(ChannelValues.Num());
+        for (int32 Index = 0; Index < ChannelValues.Num(); ++Index)
+        {
+            RawValues[Index] = ChannelValues[Index].Value;
+        }
+
+        TArray<int32> KeptIndices;
+        ReduceChannel(Keys.Times, RawValues, Tolerance, Keys.KeyInterpolation, Settings.bCollapseConstantChannels, KeptIndices);
+
+        TArray<FFrameNumber>& ReducedTimes{ Keys.ReducedTimes[ChannelIndex] };
+        TArray<FMovieSceneDoubleValue> ReducedValues;
+        ReducedTimes.Reset(KeptIndices.Num());
+        ReducedValues.Reserve(KeptIndices.Num());
+        for (const int32 Index : KeptIndices)
+        {
+            ReducedTimes.Add(Keys.Times[Index]);
+            ReducedValues.Add(ChannelValues[Index]);
+        }
+        ChannelValues = MoveTemp(ReducedValues);
+    });
+
+    Keys.bReduced = true;
+}
+
+void FKeyframeReducer::ReduceChannel(TArrayView<const FFrameNumber> Times, TArrayView<const double> Values, const double Tolerance, const int KeyInterpolation, const bool bCollapseConstant, TArray<int32>& OutKeptIndices)
+{
+    const bool bStepped{ KeyInterpolation != 0 && KeyInterpolation != 1 };
+    OutKeptIndices.Reset();
+    const int32 NumKeys{ Values.Num() };
+    if (NumKeys <= 2)
+    {
+        for (int32 Index = 0; Index < NumKeys; ++Index)
+        {
+            OutKeptIndices.Add(Index);
+        }
+        return;
+    }
+
+    if (bCollapseConstant)
+    {
+        double MinValue{ Values[0] };
+        double MaxValue{ Values[0] };
+        for (const double Value : Values)
+        {
+            MinValue = FMath::Min(MinValue, Value);
+            MaxValue = FMath::Max(MaxValue, Value);
+        }
+
+        if (MaxValue - MinValue <= Tolerance)
+        {
+            OutKeptIndices.Add(0);
+            return;
+        }
+    }
+
+    if (bStepped)
+    {
+        //A held value only needs a key where it changes.
+        OutKeptIndices.Add(0);
+        for (int32 Index = 1; Index < NumKeys; ++Index)
+        {
+            if (FMath::Abs(Values[Index] - Values[OutKeptIndices.Last()]) > Tolerance)
+            {
+                OutKeptIndices.Add(Index);
+            }
+        }
+        return;
+    }
+
+    //Iterative Ramer-Douglas-Peucker over [First, Last] spans.
+    TBitArray<> Keep(false, NumKeys);
+    Keep[0] = true;
+    Keep[NumKeys - 1] = true;
+
+    TArray<TPair<int32, int32>> Spans;
+    Spans.Emplace(0, NumKeys - 1);
+    while (Spans.Num() > 0)
+    {
+        const TPair<int32, int32> Span{ Spans.Pop(false) };
+        const int32 First{ Span.Key };
+        const int32 Last{ Span.Value };
+        if (Last - First < 2)
+        {
+            continue;
+        }
+
+        const double FirstTime{ static_cast<double>(Times[First].Value) };
+        const double TimeRange{ static_cast<double>(Times[Last].Value) - FirstTime };
+        const double ValueRange{ Values[Last] - Values[First] };
+
+        double MaxError{ 0.0 };
+        int32 MaxErrorIndex{ INDEX_NONE };
+        for (int32 Index = First + 1; Index < Last; ++Index)
+        {
+            const double Alpha{ TimeRange > 0.0 ? (Times[Index].Value - FirstTime) / TimeRange : 0.0 };
+            const double Error{ FMath::Abs(Values[Index] - (Values[First] + ValueRange * Alpha)) };
+            if (Error > MaxError)
+            {
+                MaxError = Error;
+                MaxErrorIndex = Index;
+            }
+        }
+
+        if (MaxError > Tolerance)
+        {
+            Keep[MaxErrorIndex] = true;
+            Spans.Emplace(First, MaxErrorIndex);
+            Spans.Emplace(MaxErrorIndex, Last);
+        }
+    }
+
+    //Auto tangents can overshoot the chord, the cubic channel is checked as it will be evaluated.
+    if (KeyInterpolation == 0)
+    {
+        RefineCubic(Times, Values, Tolerance, Keep);
+    }
+
+    for (TConstSetBitIterator<> It(Keep); It; ++It)
+    {
+        OutKeptIndices.Add(It.GetIndex());
+    }
+}
+
+void FKeyframeReducer::RefineCubic(TArrayView<const FFrameNumber> Times, TArrayView<const double> Values, const double Tolerance, TBitArray<>& InOutKeep)
+{
+    FMemMark Mark{ FMemStack::Get() };
+    TArray<int32, TMemStackAllocator<>> Kept;
+    TArray<int32, TMemStackAllocator<>> Inserted;
+    TArray<FFrameNumber> KeptTimes;
+    TArray<FMovieSceneDoubleValue> KeptValues;
+    FMovieSceneDoubleChannel Curve;
+
+    bool bChanged{ true };
+    while (bChanged)
+    {
+        Kept.Reset();
+        KeptTimes.Reset();
+        KeptValues.Reset();
+        for (TConstSetBitIterator<> It(InOutKeep); It; ++It)
+        {
+            Kept.Add(It.GetIndex());
+            KeptTimes.Add(Times[It.GetIndex()]);
+            FMovieSceneDoubleValue& Key{ KeptValues.Emplace_GetRef(Values[It.GetIndex()]) };
+            Key.InterpMode = RCIM_Cubic;
+            Key.TangentMode = RCTM_Auto;
+        }
+
+        //The curve the section will show, tangents and evaluation are the engine's own.
+        Curve.Set(KeptTimes, KeptValues);
+        Curve.AutoSetTangents();
+
+        //Every span is checked against the same tangents, the worst sample of each failing span goes back in.
+        Inserted.Reset();
+        for (int32 KeptIndex = 0; KeptIndex + 1 < Kept.Num(); ++KeptIndex)
+        {
+            double MaxError{ Tolerance };
+            int32 MaxErrorIndex{ INDEX_NONE };
+            for (int32 Index = Kept[KeptIndex] + 1; Index < Kept[KeptIndex + 1]; ++Index)
+            {
+                double Value{ 0.0 };
+                Curve.Evaluate(FFrameTime(Times[Index]), Value);
+                const double Error{ FMath::Abs(Values[Index] - Value) };
+                if (Error > MaxError)
+                {
+                    MaxError = Error;
+                    MaxErrorIndex = Index;
+                }
+            }
+
+            if (MaxErrorIndex != INDEX_NONE)
+            {
+                Inserted.Add(MaxErrorIndex);
+            }
+        }
+
+        for (const int32 Index : Inserted)
+        {
+            InOutKeep[Index] = true;
+        }
+        bChanged = Inserted.Num() > 0;
+    }
+}
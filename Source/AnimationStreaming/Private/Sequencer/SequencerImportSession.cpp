@@ -0,0 +1,697 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Sequencer/SequencerImportSession.h"
+
+#include "Sequencer/SequencerManager.h"
+#include "Sequencer/KeyframeDeltaImport.h"
+#include "Sequencer/KeyframeFrameIndex.h"
+#include "Sequencer/SequencerLookupCache.h"
+#include "Math/KeyframeVectorMath.h"
+
+#include "Runtime/LevelSequence/Public/LevelSequence.h"
+#include "MovieScene.h"
+#include "Tracks/MovieScene3DTransformTrack.h"
+
+#include "Sections/MovieScene3DTransformSection.h"
+#include "Channels/MovieSceneChannelProxy.h"
+#include "Channels/MovieSceneDoubleChannel.h"
+
+#include "Engine/Engine.h"
+#include "Algo/AllOf.h"
+#include "Algo/BinarySearch.h"
+#include "Async/ParallelFor.h"
+#include "ProfilingDebugging/ScopedTimers.h"
+#include "AnimationStreaming.h"
+
+
+namespace SequencerImportSession
+{
+    void ResetChannelKeys(FTransformChannelKeys& OutKeys, const int32 Num, const int KeyInterpolation)
+    {
+        OutKeys.KeyInterpolation = KeyInterpolation;
+        OutKeys.bReduced = false;
+        OutKeys.Times.Reset(Num);
+        for (TArray<FMovieSceneDoubleValue>& ChannelValues : OutKeys.Values)
+        {
+            ChannelValues.Reset(Num);
+        }
+    }
+
+    //Moves Degrees by whole turns to within 180 degrees of the key before Time, or of the key after it when none is before.
+    //Keys written in frame order end up where UnwindDegrees puts them in a batch.
+    double UnwindToNeighbour(const FMovieSceneDoubleChannel& Channel, const FFrameNumber Time, const double Degrees)
+    {
+        const TArrayView<const FFrameNumber> Times{ Channel.GetTimes() };
+        if (Times.Num() == 0)
+        {
+            return Degrees;
+        }
+
+        const int32 Next{ Algo::LowerBound(Times, Time) };
+        const double Neighbour{ Channel.GetValues()[Next > 0 ? Next - 1 : Next].Value };
+
+        return Degrees - 360.0 * FMath::RoundToDouble((Degrees - Neighbour) / 360.0);
+    }
+
+    bool HasSameTimeMapping(const FKeyframeTimeMapping& A, const FKeyframeTimeMapping& B)
+    {
+        return A.SourceRate == B.SourceRate && A.TickResolution == B.TickResolution;
+    }
+}
+
+FSequencerImportSession::FSequencerImportSession(AActor* Actor, const FString& SequencerPath, const int SectionIndex, bool& bOutSuccess)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FSequencerImportSession::Lookup);
+    SCOPE_CYCLE_COUNTER(STAT_AnimationStreaming_SequenceLookup);
+
+    if (!::IsValid(Actor))
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("FSequencerImportSession is failed: Actor is not valid"));
+
+        return;
+    }
+
+    ULevelSequence* InLevelSequence{ USequencerManager::GetLevelSequencer(SequencerPath, bOutSuccess) };
+    if (!::IsValid(InLevelSequence))
+    {
+        bOutSuccess = false;
+
+        return;
+    }
+
+    LevelSequence = InLevelSequence;
+    BindingID = USequencerLookupCache::ResolveBinding(InLevelSequence, Actor);
+
+    Resolve(SectionIndex, bOutSuccess);
+}
+
+FSequencerImportSession::FSequencerImportSession(ULevelSequence* InLevelSequence, const FGuid& InBindingID, const int SectionIndex, bool& bOutSuccess)
+    : LevelSequence(InLevelSequence)
+    , BindingID(InBindingID)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FSequencerImportSession::Lookup);
+    SCOPE_CYCLE_COUNTER(STAT_AnimationStreaming_SequenceLookup);
+
+    Resolve(SectionIndex, bOutSuccess);
+}
+
+void FSequencerImportSession::Resolve(const int SectionIndex, bool& bOutSuccess)
+{
+    ULevelSequence* InLevelSequence{ LevelSequence.Get() };
+    if (!::IsValid(InLevelSequence) || !::IsValid(InLevelSequence->MovieScene))
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("FSequencerImportSession is failed: Level sequence is not valid"));
+
+        return;
+    }
+
+    if (!BindingID.IsValid())
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("FSequencerImportSession is failed: Guid is not valid"));
+
+        return;
+    }
+
+    UMovieScene* MovieScene{ InLevelSequence->MovieScene };
+    UMovieScene3DTransformTrack* InTransformTrack{ USequencerLookupCache::ResolveTransformTrack(InLevelSequence, BindingID) };
+    if (!::IsValid(InTransformTrack))
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("FSequencerImportSession is failed: TransformTrack is not valid"));
+
+        return;
+    }
+
+    const TArray<UMovieSceneSection*>& AllSections = InTransformTrack->GetAllSections();
+    if (SectionIndex < 0 || SectionIndex >= AllSections.Num())
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("FSequencerImportSession is failed: Section index is out of range"));
+
+        return;
+    }
+
+    UMovieScene3DTransformSection* InTransformSection{ Cast<UMovieScene3DTransformSection>(AllSections[SectionIndex]) };
+    if (!::IsValid(InTransformSection))
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("FSequencerImportSession is failed: TransformSection is not valid"));
+
+        return;
+    }
+
+    TArrayView<FMovieSceneDoubleChannel* const> DoubleChannels{ InTransformSection->GetChannelProxy().GetChannels<FMovieSceneDoubleChannel>() };
+    if (DoubleChannels.Num() < NumTransformChannels)
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("FSequencerImportSession is failed: Section has %i double channels, expected %i"), DoubleChannels.Num(), NumTransformChannels);
+
+        return;
+    }
+
+    for (int ChannelIndex = 0; ChannelIndex < NumTransformChannels; ++ChannelIndex)
+    {
+        Channels[ChannelIndex] = DoubleChannels[ChannelIndex];
+    }
+
+    TimeMapping = FKeyframeTimeMapping(MovieScene->GetDisplayRate(), MovieScene->GetTickResolution());
+    TransformTrack = InTransformTrack;
+    TransformSection = InTransformSection;
+
+    bOutSuccess = true;
+}
+
+bool FSequencerImportSession::IsValid() const
+{
+    return TransformSection.IsValid() && LevelSequence.IsValid();
+}
+
+FMovieSceneDoubleChannel* FSequencerImportSession::GetChannel(const int ChannelIndex) const
+{
+    if (ChannelIndex < 0 || ChannelIndex >= NumTransformChannels)
+    {
+        return nullptr;
+    }
+
+    return Channels[ChannelIndex];
+}
+
+void FSequencerImportSession::AddTransformKeyframe(const int Frame, const FTransform& Transform, int KeyInterpolation, bool& bOutSuccess)
+{
+    UMovieScene3DTransformSection* Section{ TransformSection.Get() };
+    if (!::IsValid(Section))
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("AddTransformKeyframe is failed: Section is not valid"));
+
+        return;
+    }
+
+    Section->Modify();
+    FKeyframeDeltaImporter::InvalidateHashes(LevelSequence.Get(), BindingID, Section);
+
+    const FFrameNumber FrameNumber{ TimeMapping.ToTick(Frame) };
+    const FVector Location{ Transform.GetLocation() };
+    const FRotator Rotation{ Transform.Rotator() };
+    const FVector Scale{ Transform.GetScale3D() };
+
+    //Location
+    AddKeyToChannel(*Channels[0], FrameNumber, Location.X, KeyInterpolation);
+    AddKeyToChannel(*Channels[1], FrameNumber, Location.Y, KeyInterpolation);
+    AddKeyToChannel(*Channels[2], FrameNumber, Location.Z, KeyInterpolation);
+
+    //Rotation, unwound against the neighbouring key like the batch builders unwind along the take
+    AddKeyToChannel(*Channels[3], FrameNumber, SequencerImportSession::UnwindToNeighbour(*Channels[3], FrameNumber, Rotation.Roll), KeyInterpolation);
+    AddKeyToChannel(*Channels[4], FrameNumber, SequencerImportSession::UnwindToNeighbour(*Channels[4], FrameNumber, Rotation.Pitch), KeyInterpolation);
+    AddKeyToChannel(*Channels[5], FrameNumber, SequencerImportSession::UnwindToNeighbour(*Channels[5], FrameNumber, Rotation.Yaw), KeyInterpolation);
+
+    //Scale
+    AddKeyToChannel(*Channels[6], FrameNumber, Scale.X, KeyInterpolation);
+    AddKeyToChannel(*Channels[7], FrameNumber, Scale.Y, KeyInterpolation);
+    AddKeyToChannel(*Channels[8], FrameNumber, Scale.Z, KeyInterpolation);
+
+    bOutSuccess = true;
+}
+
+void FSequencerImportSession::AddKeyframeToChannel(const int ChannelIndex, const int Frame, double Value, int KeyInterpolation, bool& bOutSuccess)
+{
+    UMovieScene3DTransformSection* Section{ TransformSection.Get() };
+    FMovieSceneDoubleChannel* Channel{ GetChannel(ChannelIndex) };
+    if (!::IsValid(Section) || Channel == nullptr)
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("AddKeyframeToChannel is failed: Channel is not valid"));
+
+        return;
+    }
+
+    Section->Modify();
+    FKeyframeDeltaImporter::InvalidateHashes(LevelSequence.Get(), BindingID, Section);
+    AddKeyToChannel(*Channel, TimeMapping.ToTick(Frame), Value, KeyInterpolation);
+
+    bOutSuccess = true;
+}
+
+void FSequencerImportSession::AddKeyToChannel(FMovieSceneDoubleChannel& Channel, const FFrameNumber FrameNumber, double Value, int KeyInterpolation) const
+{
+    if (KeyInterpolation == 0)
+    {
+        Channel.AddCubicKey(FrameNumber, Value);
+    }
+    else if (KeyInterpolation == 1)
+    {
+        Channel.AddLinearKey(FrameNumber, Value);
+    }
+    else
+    {
+        Channel.AddConstantKey(FrameNumber, Value);
+    }
+}
+
+void FSequencerImportSession::AddTransformKeyframes(const TArray<FKeyframes>& Keyframes, int KeyInterpolation, bool& bOutSuccess)
+{
+    FTransformChannelKeys Keys;
+    BuildChannelKeys(Keyframes, TimeMapping, KeyInterpolation, Keys);
+    CommitChannelKeys(Keys, bOutSuccess);
+}
+
+void FSequencerImportSession::AddTransformKeyframes(const FKeyframeTrackSoA& Track, int KeyInterpolation, bool& bOutSuccess)
+{
+    FTransformChannelKeys Keys;
+    BuildChannelKeys(Track, TimeMapping, KeyInterpolation, Keys);
+    CommitChannelKeys(Keys, bOutSuccess);
+}
+
+void FSequencerImportSession::AddTransformKeyframes(const TArray<FKeyframes>& Keyframes, int KeyInterpolation, const FKeyframeReductionSettings& ReductionSettings, bool& bOutSuccess)
+{
+    FTransformChannelKeys Keys;
+    BuildChannelKeys(Keyframes, TimeMapping, KeyInterpolation, Keys);
+    FKeyframeReducer::ReduceChannelKeys(Keys, ReductionSettings);
+    CommitChannelKeys(Keys, bOutSuccess);
+}
+
+void FSequencerImportSession::BuildChannelKeys(const TArray<FKeyframes>& Keyframes, const FKeyframeTimeMapping& TimeMapping, int KeyInterpolation, FTransformChannelKeys& OutKeys)
+{
+    FMemMark Mark{ FMemStack::Get() };
+    TArray<int32, TMemStackAllocator<>> Frames;
+    Frames.SetNumUninitialized(Keyframes.Num());
+    for (int32 Index = 0; Index < Keyframes.Num(); ++Index)
+    {
+        Frames[Index] = Keyframes[Index].Frame;
+    }
+    const FKeyframeFrameIndex FrameIndex{ Frames };
+
+    //One batch quat to Euler conversion, the track builder below unwinds the rotation like any other source.
+    const FKeyframeTrackSoA Track{ FKeyframeTrackSoA::FromKeyframes(Keyframes, FrameIndex.Order, false) };
+    BuildChannelKeys(Track, TimeMapping, KeyInterpolation, OutKeys);
+}
+
+void FSequencerImportSession::BuildChannelKeys(const FKeyframeTrackSoA& Track, const FKeyframeTimeMapping& TimeMapping, int KeyInterpolation, FTransformChannelKeys& OutKeys)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FSequencerImportSession::BuildChannelKeys);
+    SCOPE_CYCLE_COUNTER(STAT_AnimationStreaming_Convert);
+
+    check(Track.IsConsistent());
+
+    //Strictly increasing frames, so every channel is a plain append.
+    const FKeyframeFrameIndex FrameIndex{ Track.Frames };
+    if (FrameIndex.NumDuplicates > 0 || FrameIndex.Gaps.Num() > 0)
+    {
+        UE_LOG(LogAnimationStreaming, Verbose, TEXT("BuildChannelKeys: %d duplicated frames replaced, %d gaps with %d missing frames between %d and %d"),
+            FrameIndex.NumDuplicates, FrameIndex.Gaps.Num(), FrameIndex.GetNumMissingFrames(), FrameIndex.FirstFrame, FrameIndex.LastFrame);
+    }
+
+    SequencerImportSession::ResetChannelKeys(OutKeys, FrameIndex.Num(), KeyInterpolation);
+    for (const int32 Index : FrameIndex.Order)
+    {
+        OutKeys.Times.Add(TimeMapping.ToTick(Track.Frames[Index]));
+    }
+
+    //Euler values go straight into the channels, one contiguous array at a time.
+    //Every import path unwinds the rotation along the timeline, a rotation crossing 180 degrees keeps turning the short way.
+    FMemMark Mark{ FMemStack::Get() };
+    TArray<float, TMemStackAllocator<>> Rotation;
+    for (int ChannelIndex = 0; ChannelIndex < NumTransformChannels; ++ChannelIndex)
+    {
+        const TArray<float>& Source{ Track.GetChannel(ChannelIndex) };
+        TArray<FMovieSceneDoubleValue>& ChannelValues{ OutKeys.Values[ChannelIndex] };
+        if (ChannelIndex < 3 || ChannelIndex > 5)
+        {
+            for (const int32 Index : FrameIndex.Order)
+            {
+                ChannelValues.Add(MakeKeyValue(Source[Index], KeyInterpolation));
+            }
+            continue;
+        }
+
+        Rotation.Reset();
+        for (const int32 Index : FrameIndex.Order)
+        {
+            Rotation.Add(Source[Index]);
+        }
+        FKeyframeVectorMath::UnwindDegrees(Rotation.GetData(), Rotation.Num());
+        for (const float Value : Rotation)
+        {
+            ChannelValues.Add(MakeKeyValue(Value, KeyInterpolation));
+        }
+    }
+}
+
+void FSequencerImportSession::CommitChannelKeys(FTransformChannelKeys& Keys, bool& bOutSuccess)
+{
+    FKeyframeImportReport Report;
+    CommitChannelKeys(Keys, bOutSuccess, Report);
+}
+
+void FSequencerImportSession::CommitChannelKeys(FTransformChannelKeys& Keys, bool& bOutSuccess, FKeyframeImportReport& Report)
+{
+    check(IsInGameThread());
+    TRACE_CPUPROFILER_EVENT_SCOPE(FSequencerImportSession::CommitChannelKeys);
+
+    UMovieScene3DTransformSection* Section{ TransformSection.Get() };
+    if (!::IsValid(Section))
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("CommitChannelKeys is failed: Section is not valid"));
+
+        return;
+    }
+
+    if (Keys.Times.Num() == 0)
+    {
+        bOutSuccess = true;
+
+        return;
+    }
+
+    //One transaction snapshot for the whole batch.
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(FSequencerImportSession::Modify);
+        SCOPE_CYCLE_COUNTER(STAT_AnimationStreaming_Modify);
+        FScopedDurationTimer ModifyTimer{ Report.ModifySeconds };
+
+        Section->Modify();
+    }
+    //The delta importer's block hashes no longer describe the channels.
+    FKeyframeDeltaImporter::InvalidateHashes(LevelSequence.Get(), BindingID, Section);
+
+    SCOPE_CYCLE_COUNTER(STAT_AnimationStreaming_ChannelWrite);
+    FScopedDurationTimer WriteTimer{ Report.ChannelWriteSeconds };
+    //A reduced batch owns its whole frame span, the samples it dropped must not survive as older keys.
+    const TRange<FFrameNumber> ReplacedRange{ Keys.bReduced ? TRange<FFrameNumber>::Inclusive(Keys.Times[0], Keys.Times.Last()) : TRange<FFrameNumber>::Empty() };
+    for (int ChannelIndex = 0; ChannelIndex < NumTransformChannels; ++ChannelIndex)
+    {
+        FMovieSceneDoubleChannel& Channel{ *Channels[ChannelIndex] };
+        Report.KeysWritten += Keys.GetTimes(ChannelIndex).Num();
+
+        //Batches are unwound on their own, chunks and spliced blocks are turned as a whole to continue the keys around them.
+        if (ChannelIndex >= 3 && ChannelIndex <= 5 && Keys.Values[ChannelIndex].Num() > 0)
+        {
+            TArray<FMovieSceneDoubleValue>& Values{ Keys.Values[ChannelIndex] };
+            const double Turns{ SequencerImportSession::UnwindToNeighbour(Channel, Keys.GetTimes(ChannelIndex)[0], Values[0].Value) - Values[0].Value };
+            if (Turns != 0.0)
+            {
+                for (FMovieSceneDoubleValue& Value : Values)
+                {
+                    Value.Value += Turns;
+                }
+            }
+        }
+        MergeKeysIntoChannel(Channel, Keys.GetTimes(ChannelIndex), Keys.Values[ChannelIndex], ReplacedRange);
+
+        if (Keys.KeyInterpolation == 0 && !Keys.bDeferAutoTangents)
+        {
+            Channel.AutoSetTangents();
+        }
+    }
+
+    bOutSuccess = true;
+}
+
+void FSequencerImportSession::AutoSetTangents()
+{
+    check(IsInGameThread());
+
+    if (!IsValid())
+    {
+        return;
+    }
+
+    for (FMovieSceneDoubleChannel* Channel : Channels)
+    {
+        Channel->AutoSetTangents();
+    }
+}
+
+void FSequencerImportSession::AutoSetTangents(const FFrameNumber First, const FFrameNumber Last)
+{
+    check(IsInGameThread());
+
+    if (!IsValid())
+    {
+        return;
+    }
+
+    for (FMovieSceneDoubleChannel* Channel : Channels)
+    {
+        AutoSetTangents(*Channel, First, Last);
+    }
+}
+
+void FSequencerImportSession::AutoSetTangents(FMovieSceneDoubleChannel& Channel, const FFrameNumber First, const FFrameNumber Last)
+{
+    TMovieSceneChannelData<FMovieSceneDoubleValue> ChannelData{ Channel.GetData() };
+    TArrayView<const FFrameNumber> Times{ ChannelData.GetTimes() };
+    TArrayView<FMovieSceneDoubleValue> Values{ ChannelData.GetValues() };
+    if (Times.Num() < 2)
+    {
+        return;
+    }
+
+    //A key's tangent depends on its neighbours, so the keys next to the range change too.
+    const int32 Begin{ FMath::Max(Algo::LowerBound(Times, First) - 1, 0) };
+    const int32 End{ FMath::Min(Algo::UpperBound(Times, Last) + 1, Times.Num()) };
+    if (Begin >= End)
+    {
+        return;
+    }
+
+    //The engine pass runs on a copy of the keys to update plus one neighbour on each side,
+    //so every interpolation and tangent mode gets exactly the tangents a full AutoSetTangents() gives it.
+    const int32 WindowBegin{ FMath::Max(Begin - 1, 0) };
+    const int32 WindowEnd{ FMath::Min(End + 1, Times.Num()) };
+    FMovieSceneDoubleChannel Window;
+    Window.Set(TArray<FFrameNumber>(Times.GetData() + WindowBegin, WindowEnd - WindowBegin), TArray<FMovieSceneDoubleValue>(Values.GetData() + WindowBegin, WindowEnd - WindowBegin));
+    Window.AutoSetTangents();
+
+    const TArrayView<const FMovieSceneDoubleValue> WindowValues{ Window.GetValues() };
+    for (int32 Index = Begin; Index < End; ++Index)
+    {
+        Values[Index] = WindowValues[Index - WindowBegin];
+    }
+}
+
+void FSequencerImportSession::CommitSessions(TArray<FSequencerImportSession>& Sessions, TArray<FTransformChannelKeys>& ChannelKeys, const FText& Description, bool& bOutSuccess, FKeyframeImportReport& Report)
+{
+    check(IsInGameThread());
+    check(Sessions.Num() == ChannelKeys.Num());
+    TRACE_CPUPROFILER_EVENT_SCOPE(FSequencerImportSession::CommitSessions);
+
+    //Modify() of every section is recorded into the one transaction.
+    const int32 TransactionIndex{ GEngine != nullptr ? GEngine->BeginTransaction(TEXT("AnimationStreaming"), Description, nullptr) : INDEX_NONE };
+
+    bOutSuccess = true;
+    for (int32 Index = 0; Index < Sessions.Num() && bOutSuccess; ++Index)
+    {
+        Sessions[Index].CommitChannelKeys(ChannelKeys[Index], bOutSuccess, Report);
+    }
+
+    //Each package is dirtied once, after every target took its keys.
+    if (bOutSuccess)
+    {
+        TSet<UPackage*> TouchedPackages;
+        for (int32 Index = 0; Index < Sessions.Num(); ++Index)
+        {
+            if (ChannelKeys[Index].Times.Num() > 0)
+            {
+                TouchedPackages.Add(Sessions[Index].GetLevelSequence()->GetPackage());
+            }
+        }
+
+        for (UPackage* Package : TouchedPackages)
+        {
+            Package->MarkPackageDirty();
+        }
+    }
+
+    if (TransactionIndex == INDEX_NONE)
+    {
+        return;
+    }
+
+    if (bOutSuccess)
+    {
+        GEngine->EndTransaction();
+    }
+    else
+    {
+        GEngine->CancelTransaction(TransactionIndex);
+    }
+}
+
+void FSequencerImportSession::CommitTrackToSessions(TArray<FSequencerImportSession>& Sessions, const FKeyframeTrackSoA& Track, int KeyInterpolation, bool& bOutSuccess, FKeyframeImportReport& Report)
+{
+    check(IsInGameThread());
+    TRACE_CPUPROFILER_EVENT_SCOPE(FSequencerImportSession::CommitTrackToSessions);
+
+    for (const FSequencerImportSession& Session : Sessions)
+    {
+        if (!Session.IsValid())
+        {
+            bOutSuccess = false;
+            UE_LOG(LogTemp, Error, TEXT("CommitTrackToSessions is failed: Section is not valid"));
+
+            return;
+        }
+    }
+
+    //Keys only depend on the time mapping, targets with the same rates share one build.
+    TArray<int32> BuildSessions;
+    TArray<int32> KeySource;
+    KeySource.SetNumUninitialized(Sessions.Num());
+    for (int32 Index = 0; Index < Sessions.Num(); ++Index)
+    {
+        KeySource[Index] = Index;
+        for (const int32 BuildIndex : BuildSessions)
+        {
+            if (SequencerImportSession::HasSameTimeMapping(Sessions[BuildIndex].GetTimeMapping(), Sessions[Index].GetTimeMapping()))
+            {
+                KeySource[Index] = BuildIndex;
+                break;
+            }
+        }
+
+        if (KeySource[Index] == Index)
+        {
+            BuildSessions.Add(Index);
+        }
+    }
+
+    //Shot variants are usually fresh sections. Their merge is a plain move of the built keys, so the
+    //tangents of a build are computed once off the game thread and every empty target skips its own pass.
+    TArray<bool> EmptyTargets;
+    TArray<bool> SharedTangents;
+    EmptyTargets.SetNumZeroed(Sessions.Num());
+    SharedTangents.SetNumZeroed(Sessions.Num());
+    for (int32 Index = 0; Index < Sessions.Num(); ++Index)
+    {
+        EmptyTargets[Index] = KeyInterpolation == 0
+            && Algo::AllOf(Sessions[Index].Channels, [](const FMovieSceneDoubleChannel* Channel) { return Channel->GetNumKeys() == 0; });
+        SharedTangents[KeySource[Index]] |= EmptyTargets[Index];
+    }
+
+    TArray<FTransformChannelKeys> ChannelKeys;
+    ChannelKeys.SetNum(Sessions.Num());
+    {
+        FScopedDurationTimer ConvertTimer{ Report.ConvertSeconds };
+        ParallelFor(BuildSessions.Num(), [&Sessions, &Track, &BuildSessions, &ChannelKeys, KeyInterpolation](const int32 Index)
+        {
+            const int32 SessionIndex{ BuildSessions[Index] };
+            BuildChannelKeys(Track, Sessions[SessionIndex].GetTimeMapping(), KeyInterpolation, ChannelKeys[SessionIndex]);
+        });
+
+        //The scratch channels hold no UObject, one task per channel of every build.
+        ParallelFor(BuildSessions.Num() * NumTransformChannels, [&BuildSessions, &SharedTangents, &ChannelKeys](const int32 Index)
+        {
+            const int32 SessionIndex{ BuildSessions[Index / NumTransformChannels] };
+            if (!SharedTangents[SessionIndex])
+            {
+                return;
+            }
+
+            FTransformChannelKeys& Keys{ ChannelKeys[SessionIndex] };
+            TArray<FMovieSceneDoubleValue>& Values{ Keys.Values[Index % NumTransformChannels] };
+            FMovieSceneDoubleChannel Scratch;
+            Scratch.Set(Keys.Times, MoveTemp(Values));
+            Scratch.AutoSetTangents();
+            Values = TArray<FMovieSceneDoubleValue>(Scratch.GetValues());
+        });
+
+        //A commit moves the values into its channels, so every sharing target takes its own copy.
+        ParallelFor(Sessions.Num(), [&KeySource, &EmptyTargets, &ChannelKeys](const int32 Index)
+        {
+            if (KeySource[Index] != Index)
+            {
+                ChannelKeys[Index] = ChannelKeys[KeySource[Index]];
+            }
+            ChannelKeys[Index].bDeferAutoTangents = EmptyTargets[Index];
+        });
+    }
+    Report.SampleMemory();
+
+    CommitSessions(Sessions, ChannelKeys, FText::FromString(TEXT("Import Take To Sequences")), bOutSuccess, Report);
+}
+
+void FSequencerImportSession::MergeKeysIntoChannel(FMovieSceneDoubleChannel& Channel, const TArray<FFrameNumber>& Times, TArray<FMovieSceneDoubleValue>& Values, const TRange<FFrameNumber>& ReplacedRange)
+{
+    check(Times.Num() == Values.Num());
+    if (Times.Num() == 0)
+    {
+        return;
+    }
+
+    TMovieSceneChannelData<FMovieSceneDoubleValue> ChannelData{ Channel.GetData() };
+    TArrayView<const FFrameNumber> ExistingTimes{ ChannelData.GetTimes() };
+    TArrayView<const FMovieSceneDoubleValue> ExistingValues{ ChannelData.GetValues() };
+
+    //Empty channel, or every new key lands after the existing ones: no sorted insert needed.
+    if (ExistingTimes.Num() == 0)
+    {
+        Channel.Set(Times, MoveTemp(Values));
+        return;
+    }
+
+    if (ExistingTimes.Last() < Times[0])
+    {
+        Channel.AddKeys(Times, Values);
+        return;
+    }
+
+    //Linear merge of two sorted ranges, new keys replace existing keys on the same frame.
+    TArray<FFrameNumber> MergedTimes;
+    TArray<FMovieSceneDoubleValue> MergedValues;
+    MergedTimes.Reserve(ExistingTimes.Num() + Times.Num());
+    MergedValues.Reserve(ExistingTimes.Num() + Times.Num());
+
+    int32 ExistingIndex{ 0 };
+    int32 NewIndex{ 0 };
+    while (ExistingIndex < ExistingTimes.Num() || NewIndex < Times.Num())
+    {
+        const bool bTakeNew = ExistingIndex >= ExistingTimes.Num() || (NewIndex < Times.Num() && Times[NewIndex] <= ExistingTimes[ExistingIndex]);
+        if (bTakeNew)
+        {
+            if (ExistingIndex < ExistingTimes.Num() && Times[NewIndex] == ExistingTimes[ExistingIndex])
+            {
+                ++ExistingIndex;
+            }
+            MergedTimes.Add(Times[NewIndex]);
+            MergedValues.Add(Values[NewIndex]);
+            ++NewIndex;
+        }
+        else
+        {
+            if (!ReplacedRange.Contains(ExistingTimes[ExistingIndex]))
+            {
+                MergedTimes.Add(ExistingTimes[ExistingIndex]);
+                MergedValues.Add(ExistingValues[ExistingIndex]);
+            }
+            ++ExistingIndex;
+        }
+    }
+
+    Channel.Set(MoveTemp(MergedTimes), MoveTemp(MergedValues));
+}
+
+FMovieSceneDoubleValue FSequencerImportSession::MakeKeyValue(double Value, int KeyInterpolation)
+{
+    FMovieSceneDoubleValue KeyValue{ Value };
+    if (KeyInterpolation == 0)
+    {
+        KeyValue.InterpMode = RCIM_Cubic;
+        KeyValue.TangentMode = RCTM_Auto;
+    }
+    else if (KeyInterpolation == 1)
+    {
+        KeyValue.InterpMode = RCIM_Linear;
+    }
+    else
+    {
+        KeyValue.InterpMode = RCIM_Constant;
+    }
+
+    return KeyValue;
+}
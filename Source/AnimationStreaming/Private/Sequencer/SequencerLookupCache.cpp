@@ -0,0 +1,242 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Sequencer/SequencerLookupCache.h"
+
+#include "Runtime/LevelSequence/Public/LevelSequence.h"
+#include "MovieScene.h"
+#include "Tracks/MovieScene3DTransformTrack.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
+
+
+USequencerLookupCache* USequencerLookupCache::Get()
+{
+    if (!IsInGameThread() || GEngine == nullptr)
+    {
+        return nullptr;
+    }
+
+    return GEngine->GetEngineSubsystem<USequencerLookupCache>();
+}
+
+ULevelSequence* USequencerLookupCache::LoadSequence(const FString& Path)
+{
+    USequencerLookupCache* Cache{ Get() };
+    if (Cache != nullptr)
+    {
+        if (const TWeakObjectPtr<ULevelSequence>* Cached = Cache->Sequences.Find(Path))
+        {
+            if (ULevelSequence* LevelSequence = Cached->Get())
+            {
+                return LevelSequence;
+            }
+        }
+    }
+
+    ULevelSequence* LevelSequence{ Cast<ULevelSequence>(StaticLoadObject(ULevelSequence::StaticClass(), nullptr, *Path)) };
+    if (Cache != nullptr && ::IsValid(LevelSequence))
+    {
+        Cache->Sequences.Add(Path, LevelSequence);
+    }
+
+    return LevelSequence;
+}
+
+FGuid USequencerLookupCache::ResolveBinding(ULevelSequence* LevelSequence, AActor* Actor)
+{
+    if (!::IsValid(LevelSequence) || !::IsValid(Actor) || !::IsValid(LevelSequence->MovieScene))
+    {
+        return FGuid();
+    }
+
+    USequencerLookupCache* Cache{ Get() };
+    const TPair<FObjectKey, FObjectKey> Key{ LevelSequence, Actor };
+    if (Cache != nullptr)
+    {
+        if (FBindingEntry* Entry = Cache->Bindings.Find(Key))
+        {
+            //Keys, sections and tracks leave the stamp alone, so per-key loops stay on this path.
+            const FBindingStamp Stamp{ MakeStamp(LevelSequence) };
+            if (Entry->Stamp == Stamp && (!Entry->BindingID.IsValid() || HasBinding(LevelSequence, Entry->BindingID)))
+            {
+                return Entry->BindingID;
+            }
+
+            //Other bindings changed, the cached one is kept when it still resolves to the actor.
+            if (Entry->BindingID.IsValid() && HasBinding(LevelSequence, Entry->BindingID) && IsBoundTo(LevelSequence, Entry->BindingID, Actor))
+            {
+                Entry->Stamp = Stamp;
+                return Entry->BindingID;
+            }
+        }
+    }
+
+    const FGuid BindingID{ LevelSequence->FindBindingFromObject(Actor, Actor->GetWorld()) };
+    if (Cache != nullptr)
+    {
+        Cache->Bindings.Add(Key, { BindingID, MakeStamp(LevelSequence) });
+    }
+
+    return BindingID;
+}
+
+UMovieScene3DTransformTrack* USequencerLookupCache::ResolveTransformTrack(ULevelSequence* LevelSequence, const FGuid& BindingID)
+{
+    if (!::IsValid(LevelSequence) || !::IsValid(LevelSequence->MovieScene) || !BindingID.IsValid())
+    {
+        return nullptr;
+    }
+
+    USequencerLookupCache* Cache{ Get() };
+    const TPair<FObjectKey, FGuid> Key{ LevelSequence, BindingID };
+    if (Cache != nullptr)
+    {
+        //A cached track is used while the binding still holds it. Bindings without one are looked up again,
+        //the lookup costs the same as the check.
+        if (const FTrackEntry* Entry = Cache->TransformTracks.Find(Key))
+        {
+            UMovieScene3DTransformTrack* TransformTrack{ Entry->TransformTrack.Get() };
+            if (::IsValid(TransformTrack) && HasTrack(LevelSequence, BindingID, TransformTrack))
+            {
+                return TransformTrack;
+            }
+        }
+    }
+
+    UMovieScene3DTransformTrack* TransformTrack{ LevelSequence->MovieScene->FindTrack<UMovieScene3DTransformTrack>(BindingID) };
+    if (Cache != nullptr && TransformTrack != nullptr)
+    {
+        Cache->TransformTracks.Add(Key, { TransformTrack });
+    }
+
+    return TransformTrack;
+}
+
+void USequencerLookupCache::NotifyBindingAdded(ULevelSequence* LevelSequence, AActor* Actor, const FGuid& BindingID)
+{
+    USequencerLookupCache* Cache{ Get() };
+    if (Cache != nullptr && ::IsValid(LevelSequence) && ::IsValid(Actor))
+    {
+        Cache->Bindings.Add({ LevelSequence, Actor }, { BindingID, MakeStamp(LevelSequence) });
+    }
+}
+
+void USequencerLookupCache::NotifyTransformTrackAdded(ULevelSequence* LevelSequence, const FGuid& BindingID, UMovieScene3DTransformTrack* TransformTrack)
+{
+    USequencerLookupCache* Cache{ Get() };
+    if (Cache != nullptr && ::IsValid(LevelSequence) && TransformTrack != nullptr)
+    {
+        Cache->TransformTracks.Add({ LevelSequence, BindingID }, { TransformTrack });
+    }
+}
+
+void USequencerLookupCache::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddUObject(this, &USequencerLookupCache::OnWorldCleanup);
+#if WITH_EDITOR
+    ObjectsReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddUObject(this, &USequencerLookupCache::OnObjectsReplaced);
+    PackageReloadedHandle = FCoreUObjectDelegates::OnPackageReloaded.AddUObject(this, &USequencerLookupCache::OnPackageReloaded);
+#endif
+}
+
+void USequencerLookupCache::Deinitialize()
+{
+    FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+#if WITH_EDITOR
+    FCoreUObjectDelegates::OnObjectsReplaced.Remove(ObjectsReplacedHandle);
+    FCoreUObjectDelegates::OnPackageReloaded.Remove(PackageReloadedHandle);
+#endif
+    InvalidateAll();
+
+    Super::Deinitialize();
+}
+
+void USequencerLookupCache::InvalidateSequence(ULevelSequence* LevelSequence)
+{
+    const FObjectKey SequenceKey{ LevelSequence };
+    for (auto It = Sequences.CreateIterator(); It; ++It)
+    {
+        if (FObjectKey(It.Value().Get()) == SequenceKey)
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    for (auto It = Bindings.CreateIterator(); It; ++It)
+    {
+        if (It.Key().Key == SequenceKey)
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    for (auto It = TransformTracks.CreateIterator(); It; ++It)
+    {
+        if (It.Key().Key == SequenceKey)
+        {
+            It.RemoveCurrent();
+        }
+    }
+}
+
+void USequencerLookupCache::InvalidateAll()
+{
+    Sequences.Reset();
+    Bindings.Reset();
+    TransformTracks.Reset();
+}
+
+USequencerLookupCache::FBindingStamp USequencerLookupCache::MakeStamp(const ULevelSequence* LevelSequence)
+{
+    const UMovieScene* MovieScene{ LevelSequence->MovieScene };
+
+    return { MovieScene->GetPossessableCount(), MovieScene->GetSpawnableCount(), MovieScene->GetBindings().Num() };
+}
+
+bool USequencerLookupCache::HasBinding(const ULevelSequence* LevelSequence, const FGuid& BindingID)
+{
+    const UMovieScene* MovieScene{ LevelSequence->MovieScene };
+
+    return MovieScene->FindPossessable(BindingID) != nullptr || MovieScene->FindSpawnable(BindingID) != nullptr;
+}
+
+bool USequencerLookupCache::HasTrack(const ULevelSequence* LevelSequence, const FGuid& BindingID, const UMovieScene3DTransformTrack* TransformTrack)
+{
+    const FMovieSceneBinding* Binding{ LevelSequence->MovieScene->FindBinding(BindingID) };
+
+    return Binding != nullptr && Binding->GetTracks().Contains(TransformTrack);
+}
+
+bool USequencerLookupCache::IsBoundTo(const ULevelSequence* LevelSequence, const FGuid& BindingID, AActor* Actor)
+{
+    TArray<UObject*, TInlineAllocator<1>> BoundObjects;
+    LevelSequence->LocateBoundObjects(BindingID, Actor->GetWorld(), BoundObjects);
+
+    return BoundObjects.Contains(Actor);
+}
+
+void USequencerLookupCache::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+    //Actors of the world go away, bindings are keyed by them.
+    Bindings.Reset();
+}
+
+#if WITH_EDITOR
+void USequencerLookupCache::OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap)
+{
+    InvalidateAll();
+}
+
+void USequencerLookupCache::OnPackageReloaded(const EPackageReloadPhase Phase, FPackageReloadedEvent* Event)
+{
+    if (Phase == EPackageReloadPhase::PostPackageFixup)
+    {
+        InvalidateAll();
+    }
+}
+#endif
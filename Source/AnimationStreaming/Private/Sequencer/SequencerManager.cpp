@@ -2,6 +2,15 @@
 
 
 #include "Sequencer/SequencerManager.h"
+#include "Sequencer/SequencerImportSession.h"
+#include "Sequencer/KeyframeDeltaImport.h"
+#include "Sequencer/SequencerLookupCache.h"
+#include "Json/JsonManager.h"
+#include "Json/KeyframeJsonParser.h"
+#include "Json/KeyframeCache.h"
+#include "Format/KeyframeSource.h"
+#include "Format/KeyframeSourceFile.h"
+#include "AnimationStreaming.h"
 
 #include "Runtime/LevelSequence/Public/LevelSequence.h"
 #include "MovieScene.h"
@@ -9,15 +18,71 @@
 #include "Tracks/MovieSceneSkeletalAnimationTrack.h"
 
 #include "Sections/MovieScene3DTransformSection.h"
+#include "Sections/MovieSceneSkeletalAnimationSection.h"
 #include "Channels/MovieSceneChannelProxy.h"
 #include "Channels/MovieSceneDoubleChannel.h"
 
 #include "GameFramework/Character.h"
+#include "Animation/AnimSequence.h"
+#include "Async/ParallelFor.h"
+#include "ProfilingDebugging/ScopedTimers.h"
 
 
+namespace SequencerManager
+{
+    //Cached sidecar first, the json capture otherwise. A parsed control is merged into the cache.
+    bool LoadControlTrack(const FString& FilePath, const FString& ControlName, FKeyframeTrackSoA& OutTrack, FKeyframeImportReport& Report, FString& OutInfoMessage)
+    {
+        {
+            FScopedDurationTimer ReadTimer{ Report.ReadSeconds };
+            Report.bFromCache = FKeyframeCache::Load(FilePath, ControlName, OutTrack);
+        }
+
+        if (Report.bFromCache)
+        {
+            return true;
+        }
+
+        FKeyframeSourceFile SourceFile;
+        bool bLoaded{ false };
+        {
+            TRACE_CPUPROFILER_EVENT_SCOPE(USequencerManager::ReadFile);
+            FScopedDurationTimer ReadTimer{ Report.ReadSeconds };
+
+            bLoaded = SourceFile.Open(FilePath);
+        }
+
+        if (!bLoaded)
+        {
+            OutInfoMessage = FString::Printf(TEXT("Load Json failed: - '%s'"), *FilePath);
+            return false;
+        }
+        const TArrayView<const uint8> JsonBytes{ SourceFile.GetBytes() };
+        Report.BytesRead = JsonBytes.Num();
+        Report.SampleMemory();
+
+        bool bParsed{ false };
+        {
+            FScopedDurationTimer TokenizeTimer{ Report.TokenizeSeconds };
+            bParsed = FKeyframeSourceRegistry::Get().LoadControl(FilePath, JsonBytes, ControlName, OutTrack, OutInfoMessage);
+        }
+
+        if (!bParsed)
+        {
+            return false;
+        }
+
+        TMap<FString, FKeyframeTrackSoA> CachedControls;
+        CachedControls.Add(ControlName, OutTrack);
+        FKeyframeCache::Merge(FilePath, JsonBytes, CachedControls);
+
+        return true;
+    }
+}
+
 ULevelSequence* USequencerManager::GetLevelSequencer(const FString& Path, bool& bOutSuccess)
 {
-    ULevelSequence* LevelSequence = Cast<ULevelSequence>(StaticLoadObject(ULevelSequence::StaticClass(), nullptr, *Path));
+    ULevelSequence* LevelSequence{ USequencerLookupCache::LoadSequence(Path) };
     if (!IsValid(LevelSequence))
     {
         bOutSuccess = false;
@@ -47,7 +112,7 @@ FGuid USequencerManager::GetActorGuidFromLevelSequence(AActor* Actor, const FStr
         return FGuid();
     }
 
-    FGuid Result{ LevelSequence->FindBindingFromObject(Actor, Actor->GetWorld()) };
+    FGuid Result{ USequencerLookupCache::ResolveBinding(LevelSequence, Actor) };
 
     if (!Result.IsValid())
     {
@@ -97,6 +162,8 @@ FGuid USequencerManager::AddActorToLevelSequence(AActor* Actor, const FString& S
         return FGuid();
     }
 
+    USequencerLookupCache::NotifyBindingAdded(LevelSequence, Actor, ActorID);
+
     return ActorID;
 }
 
@@ -119,7 +186,7 @@ UMovieScene3DTransformTrack* USequencerManager::GetTransformTrackFromActor(AActo
         return nullptr;
     }
 
-    UMovieScene3DTransformTrack* TransformTrack{ LevelSequence->MovieScene->FindTrack<UMovieScene3DTransformTrack>(ActorID) };
+    UMovieScene3DTransformTrack* TransformTrack{ USequencerLookupCache::ResolveTransformTrack(LevelSequence, ActorID) };
 
     if (!IsValid(TransformTrack))
     {
@@ -160,6 +227,7 @@ UMovieScene3DTransformTrack* USequencerManager::AddTransformTrackToActor(AActor*
     }
 
     UMovieScene3DTransformTrack* TransformTrack = LevelSequence->MovieScene->AddTrack<UMovieScene3DTransformTrack>(ActorID);
+    USequencerLookupCache::NotifyTransformTrackAdded(LevelSequence, ActorID, TransformTrack);
     bOutSuccess = true;
 
     return TransformTrack;
@@ -219,9 +287,9 @@ UMovieScene3DTransformSection* USequencerManager::AddTransformSectionToActor(AAc
 
         return nullptr;
     }
-    const int TickPerFrame = LevelSequence->MovieScene->GetTickResolution().AsDecimal() / LevelSequence->MovieScene->GetDisplayRate().AsDecimal();
+    const FKeyframeTimeMapping TimeMapping{ LevelSequence->MovieScene->GetDisplayRate(), LevelSequence->MovieScene->GetTickResolution() };
 
-    TransformSection->SetRange(TRange<FFrameNumber>(FFrameNumber(StartFrame * TickPerFrame), FFrameNumber(EndFrame * TickPerFrame)));
+    TransformSection->SetRange(TRange<FFrameNumber>(TimeMapping.ToTick(StartFrame), TimeMapping.ToTick(EndFrame)));
 
     TransformSection->SetBlendType(BlendType);
     int RowIndex{ -1 };
@@ -240,31 +308,408 @@ UMovieScene3DTransformSection* USequencerManager::AddTransformSectionToActor(AAc
 
 void USequencerManager::AddTransformKeyframe(AActor* Actor, const FString& SequencerPath, const int SectionIndex, const int Frame, const FTransform& Transform, int KeyInterpolation, bool& bOutSuccess)
 {
-    UMovieScene3DTransformSection* Section{ GetTransformSectionFromActor(Actor, SequencerPath, SectionIndex, bOutSuccess) };
+    //For repeated writes keep one FSequencerImportSession
+    //alive instead, it resolves everything below only once.
+    FSequencerImportSession Session{ Actor, SequencerPath, SectionIndex, bOutSuccess };
 
-    if (!IsValid(Section))
+    if (!Session.IsValid())
     {
         bOutSuccess = false;
         UE_LOG(LogTemp, Error, TEXT("AddTransformKeyframe is failed: Section is not valid"));
         return;
     }
 
-    //Location
-    AddKeyframeToDoubleChannel(Section, 0, Frame, Transform.GetLocation().X, KeyInterpolation, bOutSuccess);
-    AddKeyframeToDoubleChannel(Section, 1, Frame, Transform.GetLocation().Y, KeyInterpolation, bOutSuccess);
-    AddKeyframeToDoubleChannel(Section, 2, Frame, Transform.GetLocation().Z, KeyInterpolation, bOutSuccess);
+    Session.AddTransformKeyframe(Frame, Transform, KeyInterpolation, bOutSuccess);
+}
 
-    //Rotation
-    AddKeyframeToDoubleChannel(Section, 3, Frame, Transform.Rotator().Roll, KeyInterpolation, bOutSuccess);
-    AddKeyframeToDoubleChannel(Section, 4, Frame, Transform.Rotator().Pitch, KeyInterpolation, bOutSuccess);
-    AddKeyframeToDoubleChannel(Section, 5, Frame, Transform.Rotator().Yaw, KeyInterpolation, bOutSuccess);
+void USequencerManager::AddTransformKeyframes(AActor* Actor, const FString& SequencerPath, const int SectionIndex, const TArray<FKeyframes>& Keyframes, int KeyInterpolation, bool& bOutSuccess)
+{
+    FSequencerImportSession Session{ Actor, SequencerPath, SectionIndex, bOutSuccess };
 
-    //Scale
-    AddKeyframeToDoubleChannel(Section, 6, Frame, Transform.GetScale3D().X, KeyInterpolation, bOutSuccess);
-    AddKeyframeToDoubleChannel(Section, 7, Frame, Transform.GetScale3D().Y, KeyInterpolation, bOutSuccess);
-    AddKeyframeToDoubleChannel(Section, 8, Frame, Transform.GetScale3D().Z, KeyInterpolation, bOutSuccess);
+    if (!Session.IsValid())
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("AddTransformKeyframes is failed: Section is not valid"));
+        return;
+    }
 
-    bOutSuccess = true;
+    Session.AddTransformKeyframes(Keyframes, KeyInterpolation, bOutSuccess);
+}
+
+void USequencerManager::AddTransformTrack(AActor* Actor, const FString& SequencerPath, const int SectionIndex, const FKeyframeTrackSoA& Track, int KeyInterpolation, bool& bOutSuccess)
+{
+    if (!Track.IsConsistent())
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("AddTransformTrack is failed: Track channels have different lengths"));
+        return;
+    }
+
+    FSequencerImportSession Session{ Actor, SequencerPath, SectionIndex, bOutSuccess };
+
+    if (!Session.IsValid())
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("AddTransformTrack is failed: Section is not valid"));
+        return;
+    }
+
+    Session.AddTransformKeyframes(Track, KeyInterpolation, bOutSuccess);
+}
+
+void USequencerManager::AddResampledTransformTrack(AActor* Actor, const FString& SequencerPath, const int SectionIndex, const FKeyframeTrackSoA& Track, const FFrameRate& CaptureRate, int KeyInterpolation, bool& bOutSuccess)
+{
+    if (!Track.IsConsistent() || !CaptureRate.IsValid())
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("AddResampledTransformTrack is failed: Track or capture rate is not valid"));
+        return;
+    }
+
+    FSequencerImportSession Session{ Actor, SequencerPath, SectionIndex, bOutSuccess };
+
+    if (!Session.IsValid())
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("AddResampledTransformTrack is failed: Section is not valid"));
+        return;
+    }
+
+    FKeyframeTrackSoA Resampled;
+    FKeyframeFrameIndex(Track.Frames).Resample(Track, CaptureRate, Session.GetTimeMapping().SourceRate, Resampled);
+    Session.AddTransformKeyframes(Resampled, KeyInterpolation, bOutSuccess);
+}
+
+void USequencerManager::AddReducedTransformKeyframes(AActor* Actor, const FString& SequencerPath, const int SectionIndex, const TArray<FKeyframes>& Keyframes, int KeyInterpolation, const FKeyframeReductionSettings& ReductionSettings, bool& bOutSuccess)
+{
+    FSequencerImportSession Session{ Actor, SequencerPath, SectionIndex, bOutSuccess };
+
+    if (!Session.IsValid())
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("AddReducedTransformKeyframes is failed: Section is not valid"));
+        return;
+    }
+
+    Session.AddTransformKeyframes(Keyframes, KeyInterpolation, ReductionSettings, bOutSuccess);
+}
+
+void USequencerManager::ImportTakeForActors(const TArray<AActor*>& Actors, const TArray<FKeyframeTrack>& Tracks, const FString& SequencerPath, const int SectionIndex, int KeyInterpolation, bool& bOutSuccess)
+{
+    if (Actors.Num() != Tracks.Num())
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("ImportTakeForActors is failed: %i actors but %i tracks"), Actors.Num(), Tracks.Num());
+
+        return;
+    }
+
+    ULevelSequence* LevelSequence{ GetLevelSequencer(SequencerPath, bOutSuccess) };
+    if (!IsValid(LevelSequence))
+    {
+        bOutSuccess = false;
+
+        return;
+    }
+
+    //Resolve every binding up front so a bad actor fails the import before anything is written.
+    TArray<FSequencerImportSession> Sessions;
+    TArray<int32> TrackIndices;
+    Sessions.Reserve(Actors.Num());
+    TrackIndices.Reserve(Actors.Num());
+    TSet<UMovieScene3DTransformSection*> Sections;
+    for (int32 ActorIndex = 0; ActorIndex < Actors.Num(); ++ActorIndex)
+    {
+        AActor* Actor{ Actors[ActorIndex] };
+        if (!IsValid(Actor))
+        {
+            bOutSuccess = false;
+            UE_LOG(LogTemp, Error, TEXT("ImportTakeForActors is failed: Actor is not valid"));
+
+            return;
+        }
+
+        const FGuid ActorID{ USequencerLookupCache::ResolveBinding(LevelSequence, Actor) };
+        FSequencerImportSession Session{ LevelSequence, ActorID, SectionIndex, bOutSuccess };
+        if (!Session.IsValid())
+        {
+            bOutSuccess = false;
+            UE_LOG(LogTemp, Error, TEXT("ImportTakeForActors is failed: Section is not valid for '%s'"), *Actor->GetName());
+
+            return;
+        }
+
+        //An actor listed twice resolves to the same section, only its first track is written.
+        bool bAlreadyAdded{ false };
+        Sections.Add(Session.GetTransformSection(), &bAlreadyAdded);
+        if (bAlreadyAdded)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ImportTakeForActors: '%s' is listed more than once, track %i is skipped"), *Actor->GetName(), ActorIndex);
+            continue;
+        }
+        Sessions.Add(MoveTemp(Session));
+        TrackIndices.Add(ActorIndex);
+    }
+
+    //Sorting, Euler conversion and key array building touch no UObject.
+    TArray<FTransformChannelKeys> ChannelKeys;
+    ChannelKeys.SetNum(Sessions.Num());
+    ParallelFor(Sessions.Num(), [&Sessions, &Tracks, &TrackIndices, &ChannelKeys, KeyInterpolation](const int32 Index)
+    {
+        FSequencerImportSession::BuildChannelKeys(Tracks[TrackIndices[Index]].Keyframes, Sessions[Index].GetTimeMapping(), KeyInterpolation, ChannelKeys[Index]);
+    });
+
+    //One undo entry for the whole take, a failed actor rolls back the ones written before it.
+    FKeyframeImportReport Report;
+    FSequencerImportSession::CommitSessions(Sessions, ChannelKeys, FText::FromString(TEXT("Import Take For Actors")), bOutSuccess, Report);
+}
+
+void USequencerManager::ImportTakeToSequences(AActor* Actor, const FKeyframeTrackSoA& Track, const TArray<FString>& SequencerPaths, const int SectionIndex, int KeyInterpolation, bool& bOutSuccess, FKeyframeImportReport& OutReport)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(USequencerManager::ImportTakeToSequences);
+    const double StartSeconds{ FPlatformTime::Seconds() };
+    OutReport = FKeyframeImportReport();
+    OutReport.Frames = Track.Num();
+    OutReport.SampleMemory();
+
+    if (!IsValid(Actor))
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("ImportTakeToSequences is failed: Actor is not valid"));
+
+        return;
+    }
+
+    //Resolve every target up front so a bad sequence fails the batch before anything is written.
+    TArray<FSequencerImportSession> Sessions;
+    Sessions.Reserve(SequencerPaths.Num());
+    {
+        FScopedDurationTimer LookupTimer{ OutReport.SequenceLookupSeconds };
+        TSet<UMovieScene3DTransformSection*> Sections;
+        for (const FString& SequencerPath : SequencerPaths)
+        {
+            FSequencerImportSession Session{ Actor, SequencerPath, SectionIndex, bOutSuccess };
+            if (!Session.IsValid())
+            {
+                bOutSuccess = false;
+                UE_LOG(LogTemp, Error, TEXT("ImportTakeToSequences is failed: Section is not valid in '%s'"), *SequencerPath);
+
+                return;
+            }
+
+            //The same sequence listed twice is written once.
+            bool bAlreadyAdded{ false };
+            Sections.Add(Session.GetTransformSection(), &bAlreadyAdded);
+            if (!bAlreadyAdded)
+            {
+                Sessions.Add(MoveTemp(Session));
+            }
+        }
+    }
+
+    FSequencerImportSession::CommitTrackToSessions(Sessions, Track, KeyInterpolation, bOutSuccess, OutReport);
+
+    OutReport.TotalSeconds = FPlatformTime::Seconds() - StartSeconds;
+    OutReport.Log(TEXT("ImportTakeToSequences"));
+}
+
+void USequencerManager::ImportJsonToSequencer(AActor* Actor, const FString& FilePath, const FString& ControlName, const FString& SequencerPath, const int SectionIndex, int KeyInterpolation, bool& bOutSuccess, FKeyframeImportReport& OutReport)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(USequencerManager::ImportJsonToSequencer);
+    const double StartSeconds{ FPlatformTime::Seconds() };
+    OutReport = FKeyframeImportReport();
+    OutReport.SampleMemory();
+
+    FSequencerImportSession Session;
+    {
+        FScopedDurationTimer LookupTimer{ OutReport.SequenceLookupSeconds };
+        Session = FSequencerImportSession(Actor, SequencerPath, SectionIndex, bOutSuccess);
+    }
+
+    if (!Session.IsValid())
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("ImportJsonToSequencer is failed: Section is not valid"));
+        return;
+    }
+
+    FKeyframeTrackSoA Track;
+    FString InfoMessage;
+    bOutSuccess = SequencerManager::LoadControlTrack(FilePath, ControlName, Track, OutReport, InfoMessage);
+    if (!bOutSuccess)
+    {
+        UE_LOG(LogTemp, Error, TEXT("ImportJsonToSequencer is failed: %s"), *InfoMessage);
+        return;
+    }
+    OutReport.Frames = Track.Num();
+
+    FTransformChannelKeys Keys;
+    {
+        FScopedDurationTimer ConvertTimer{ OutReport.ConvertSeconds };
+        FSequencerImportSession::BuildChannelKeys(Track, Session.GetTimeMapping(), KeyInterpolation, Keys);
+    }
+    OutReport.SampleMemory();
+
+    Session.CommitChannelKeys(Keys, bOutSuccess, OutReport);
+
+    OutReport.TotalSeconds = FPlatformTime::Seconds() - StartSeconds;
+    OutReport.Log(TEXT("ImportJsonToSequencer"));
+}
+
+void USequencerManager::ReimportJsonToSequencer(AActor* Actor, const FString& FilePath, const FString& ControlName, const FString& SequencerPath, const int SectionIndex, int KeyInterpolation, bool& bOutSuccess, FKeyframeImportReport& OutReport)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(USequencerManager::ReimportJsonToSequencer);
+    const double StartSeconds{ FPlatformTime::Seconds() };
+    OutReport = FKeyframeImportReport();
+
+    FSequencerImportSession Session;
+    {
+        FScopedDurationTimer LookupTimer{ OutReport.SequenceLookupSeconds };
+        Session = FSequencerImportSession(Actor, SequencerPath, SectionIndex, bOutSuccess);
+    }
+
+    if (!Session.IsValid())
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("ReimportJsonToSequencer is failed: Section is not valid"));
+        return;
+    }
+
+    FKeyframeTrackSoA Track;
+    FString InfoMessage;
+    bOutSuccess = SequencerManager::LoadControlTrack(FilePath, ControlName, Track, OutReport, InfoMessage);
+    if (!bOutSuccess)
+    {
+        UE_LOG(LogTemp, Error, TEXT("ReimportJsonToSequencer is failed: %s"), *InfoMessage);
+        return;
+    }
+    OutReport.Frames = Track.Num();
+
+    FTransformChannelKeys Keys;
+    {
+        FScopedDurationTimer ConvertTimer{ OutReport.ConvertSeconds };
+        FSequencerImportSession::BuildChannelKeys(Track, Session.GetTimeMapping(), KeyInterpolation, Keys);
+    }
+
+    FKeyframeDeltaImporter::Reimport(Session, Keys, bOutSuccess, OutReport);
+
+    OutReport.TotalSeconds = FPlatformTime::Seconds() - StartSeconds;
+    OutReport.Log(TEXT("ReimportJsonToSequencer"));
+}
+
+void USequencerManager::ImportJsonChunked(AActor* Actor, const FString& FilePath, const FString& ControlName, const FString& SequencerPath, const int SectionIndex, int KeyInterpolation, const FChunkedImportSettings& Settings, bool& bOutSuccess, FKeyframeImportReport& OutReport)
+{
+    OutReport = FKeyframeImportReport();
+
+    FSequencerImportSession Session;
+    {
+        FScopedDurationTimer LookupTimer{ OutReport.SequenceLookupSeconds };
+        Session = FSequencerImportSession(Actor, SequencerPath, SectionIndex, bOutSuccess);
+    }
+
+    if (!Session.IsValid())
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("ImportJsonChunked is failed: Section is not valid"));
+        return;
+    }
+
+    FString InfoMessage;
+    FChunkedKeyframeImporter::Import(Session, FilePath, ControlName, KeyInterpolation, Settings, bOutSuccess, InfoMessage, OutReport);
+    if (!bOutSuccess)
+    {
+        UE_LOG(LogTemp, Error, TEXT("ImportJsonChunked is failed: %s"), *InfoMessage);
+        return;
+    }
+
+    OutReport.TotalSeconds += OutReport.SequenceLookupSeconds;
+    OutReport.Log(TEXT("ImportJsonChunked"));
+}
+
+UAnimSequence* USequencerManager::BakeJsonToAnimSequence(const FString& FilePath, USkeleton* Skeleton, const FString& AnimSequencePath, const FString& SequencerPath, const FAnimBakeSettings& Settings, bool& bOutSuccess)
+{
+    ULevelSequence* LevelSequence{ GetLevelSequencer(SequencerPath, bOutSuccess) };
+    if (!IsValid(LevelSequence))
+    {
+        bOutSuccess = false;
+
+        return nullptr;
+    }
+
+    FString InfoMessage;
+    const TMap<FString, FKeyframeTrack> Controls{ UJsonManager::LoadAllControls(FilePath, bOutSuccess, InfoMessage) };
+    if (!bOutSuccess)
+    {
+        UE_LOG(LogTemp, Error, TEXT("BakeJsonToAnimSequence is failed: %s"), *InfoMessage);
+
+        return nullptr;
+    }
+
+    UAnimSequence* AnimSequence{ FAnimSequenceBaker::Bake(Controls, Skeleton, AnimSequencePath, LevelSequence->MovieScene->GetDisplayRate(), Settings, bOutSuccess, InfoMessage) };
+    if (!bOutSuccess)
+    {
+        UE_LOG(LogTemp, Error, TEXT("BakeJsonToAnimSequence is failed: %s"), *InfoMessage);
+
+        return nullptr;
+    }
+
+    return AnimSequence;
+}
+
+UMovieSceneSection* USequencerManager::AddSkeletalAnimationToActor(AActor* Actor, const FString& SequencerPath, UAnimSequence* AnimSequence, const int StartFrame, bool& bOutSuccess)
+{
+    if (!IsValid(AnimSequence))
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("AddSkeletalAnimationToActor is failed: AnimSequence is not valid"));
+
+        return nullptr;
+    }
+
+    FGuid ActorID{ GetActorGuidFromLevelSequence(Actor, SequencerPath, bOutSuccess) };
+    if (!ActorID.IsValid())
+    {
+        bOutSuccess = false;
+
+        return nullptr;
+    }
+
+    ULevelSequence* LevelSequence{ GetLevelSequencer(SequencerPath, bOutSuccess) };
+    if (!IsValid(LevelSequence))
+    {
+        bOutSuccess = false;
+
+        return nullptr;
+    }
+
+    UMovieScene* MovieScene{ LevelSequence->MovieScene };
+    UMovieSceneSkeletalAnimationTrack* AnimationTrack{ MovieScene->FindTrack<UMovieSceneSkeletalAnimationTrack>(ActorID) };
+    if (!IsValid(AnimationTrack))
+    {
+        MovieScene->Modify();
+        AnimationTrack = MovieScene->AddTrack<UMovieSceneSkeletalAnimationTrack>(ActorID);
+    }
+
+    int RowIndex{ -1 };
+    for (UMovieSceneSection* ExistingSection : AnimationTrack->GetAllSections())
+    {
+        RowIndex = FMath::Max(RowIndex, ExistingSection->GetRowIndex());
+    }
+
+    const FKeyframeTimeMapping TimeMapping{ MovieScene->GetDisplayRate(), MovieScene->GetTickResolution() };
+
+    AnimationTrack->Modify();
+    UMovieSceneSection* AnimationSection{ AnimationTrack->AddNewAnimationOnRow(TimeMapping.ToTick(StartFrame), AnimSequence, RowIndex + 1) };
+
+    bOutSuccess = IsValid(AnimationSection);
+    if (!bOutSuccess)
+    {
+        UE_LOG(LogTemp, Error, TEXT("AddSkeletalAnimationToActor is failed: AnimationSection is not valid"));
+
+        return nullptr;
+    }
+
+    return AnimationSection;
 }
 
 void USequencerManager::AddKeyframeToDoubleChannel(UMovieSceneSection* Section, const int ChannelIndex, const int Frame, double Value, int KeyInterpolation, bool& bOutSuccess)
@@ -295,9 +740,9 @@ void USequencerManager::AddKeyframeToDoubleChannel(UMovieSceneSection* Section,
         return;
     }
 
-    const int TickPerFrame = LevelSequence->MovieScene->GetTickResolution().AsDecimal() / LevelSequence->MovieScene->GetDisplayRate().AsDecimal();
+    const FKeyframeTimeMapping TimeMapping{ LevelSequence->MovieScene->GetDisplayRate(), LevelSequence->MovieScene->GetTickResolution() };
 
-    FFrameNumber FrameNumber{ FFrameNumber(Frame * TickPerFrame) };
+    FFrameNumber FrameNumber{ TimeMapping.ToTick(Frame) };
 
     if (KeyInterpolation == 0)
     {
@@ -314,6 +759,13 @@ void USequencerManager::AddKeyframeToDoubleChannel(UMovieSceneSection* Section,
 
     Section->Modify();
 
+    FGuid BindingID;
+    const UMovieSceneTrack* Track{ Section->GetTypedOuter<UMovieSceneTrack>() };
+    if (Track != nullptr && LevelSequence->MovieScene->FindTrackBinding(*Track, BindingID))
+    {
+        FKeyframeDeltaImporter::InvalidateHashes(LevelSequence, BindingID, Section);
+    }
+
     bOutSuccess = true;
 }
 
@@ -334,7 +786,7 @@ bool USequencerManager::IsActorInSequence(AActor* Actor, const FString& Sequence
         return false;
     }
 
-    FGuid Result{ LevelSequence->FindBindingFromObject(Actor, Actor->GetWorld()) };
+    FGuid Result{ USequencerLookupCache::ResolveBinding(LevelSequence, Actor) };
 
     return Result.IsValid();
 }
@@ -358,7 +810,7 @@ bool USequencerManager::IsTransformTrackInSequence(AActor* Actor, const FString&
         return false;
     }
 
-    UMovieScene3DTransformTrack* TransformTrack{ LevelSequence->MovieScene->FindTrack<UMovieScene3DTransformTrack>(ActorID) };
+    UMovieScene3DTransformTrack* TransformTrack{ USequencerLookupCache::ResolveTransformTrack(LevelSequence, ActorID) };
     bOutSuccess = true;
 
     return IsValid(TransformTrack);
@@ -0,0 +1,306 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Streaming/KeyframeStreamReceiver.h"
+
+#include "Common/UdpSocketBuilder.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+#include <atomic>
+
+
+namespace KeyframeStreamReceiver
+{
+    //Must be a power of two, holds one element less.
+    constexpr uint32 RingBufferSize{ 1 << 16 };
+    constexpr int32 MaxDatagramSize{ 65507 };
+    constexpr int32 SocketBufferSize{ 4 * 1024 * 1024 };
+}
+
+/**
+ * Network thread: reads datagrams and pushes frames into the ring buffer.
+ * A full buffer drops frames instead of waiting for the game thread.
+ */
+class FKeyframeStreamWorker : public FRunnable
+{
+public:
+    FKeyframeStreamWorker(FSocket* InSocket, TCircularQueue<FStreamedKeyframe>& InRingBuffer)
+        : Socket(InSocket)
+        , RingBuffer(InRingBuffer)
+    {
+    }
+
+    virtual ~FKeyframeStreamWorker() override
+    {
+        if (Thread != nullptr)
+        {
+            Thread->Kill(true);
+            delete Thread;
+        }
+
+        if (Socket != nullptr)
+        {
+            Socket->Close();
+            ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+        }
+    }
+
+    bool Start()
+    {
+        Thread = FRunnableThread::Create(this, TEXT("KeyframeStreamReceiver"), 0, TPri_AboveNormal);
+        return Thread != nullptr;
+    }
+
+    virtual uint32 Run() override
+    {
+        TArray<uint8> Datagram;
+        Datagram.SetNumUninitialized(KeyframeStreamReceiver::MaxDatagramSize);
+
+        while (!bStopping)
+        {
+            if (!Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromMilliseconds(50)))
+            {
+                continue;
+            }
+
+            int32 BytesRead{ 0 };
+            while (!bStopping && Socket->Recv(Datagram.GetData(), Datagram.Num(), BytesRead) && BytesRead > 0)
+            {
+                ReadDatagram(Datagram.GetData(), BytesRead, FPlatformTime::Cycles64());
+            }
+        }
+
+        return 0;
+    }
+
+    virtual void Stop() override
+    {
+        bStopping = true;
+    }
+
+    int64 GetFramesReceived() const { return FramesReceived; }
+    int64 GetFramesDropped() const { return FramesDropped; }
+
+private:
+    void ReadDatagram(const uint8* Data, const int32 Size, const uint64 ReceiveCycles)
+    {
+        FKeyframePacketHeader Header;
+        if (Size < static_cast<int32>(sizeof(Header)))
+        {
+            return;
+        }
+
+        FMemory::Memcpy(&Header, Data, sizeof(Header));
+        const int32 ExpectedSize{ static_cast<int32>(sizeof(Header) + sizeof(FKeyframePacketRecord) * Header.NumRecords) };
+        if (Header.Magic != FKeyframePacketHeader::ExpectedMagic || Header.Version != FKeyframePacketHeader::CurrentVersion || Size < ExpectedSize)
+        {
+            FramesDropped += Header.NumRecords;
+            return;
+        }
+
+        for (int32 RecordIndex = 0; RecordIndex < Header.NumRecords; ++RecordIndex)
+        {
+            FKeyframePacketRecord Record;
+            FMemory::Memcpy(&Record, Data + sizeof(Header) + sizeof(Record) * RecordIndex, sizeof(Record));
+
+            FStreamedKeyframe Entry;
+            Entry.Keyframe = Record.ToKeyframe();
+            Entry.ReceiveCycles = ReceiveCycles;
+
+            if (RingBuffer.Enqueue(MoveTemp(Entry)))
+            {
+                ++FramesReceived;
+            }
+            else
+            {
+                ++FramesDropped;
+            }
+        }
+    }
+
+    FSocket* Socket;
+    TCircularQueue<FStreamedKeyframe>& RingBuffer;
+    FRunnableThread* Thread{ nullptr };
+    std::atomic<bool> bStopping{ false };
+    std::atomic<int64> FramesReceived{ 0 };
+    std::atomic<int64> FramesDropped{ 0 };
+};
+
+UKeyframeStreamReceiver::UKeyframeStreamReceiver() = default;
+
+UKeyframeStreamReceiver::~UKeyframeStreamReceiver() = default;
+
+void UKeyframeStreamReceiver::StartStreaming(AActor* Actor, const FString& SequencerPath, const int SectionIndex, const int Port, int InKeyInterpolation, bool& bOutSuccess)
+{
+    StopStreaming();
+
+    Session = FSequencerImportSession{ Actor, SequencerPath, SectionIndex, bOutSuccess };
+    if (!Session.IsValid())
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("StartStreaming is failed: Section is not valid"));
+
+        return;
+    }
+
+    FSocket* Socket{ FUdpSocketBuilder(TEXT("KeyframeStreamReceiver"))
+        .AsNonBlocking()
+        .BoundToAddress(FIPv4Address::InternalLoopback)
+        .BoundToPort(Port)
+        .WithReceiveBufferSize(KeyframeStreamReceiver::SocketBufferSize)
+        .Build() };
+    if (Socket == nullptr)
+    {
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("StartStreaming is failed: Can't bind port %i"), Port);
+
+        return;
+    }
+
+    KeyInterpolation = InKeyInterpolation;
+    Stats = FKeyframeStreamStats();
+    TotalLatencyMs = 0.0;
+    Batch.Reserve(MaxFramesPerTick);
+    BatchReceiveCycles.Reserve(MaxFramesPerTick);
+
+    RingBuffer = MakeUnique<TCircularQueue<FStreamedKeyframe>>(KeyframeStreamReceiver::RingBufferSize);
+    Worker = MakeUnique<FKeyframeStreamWorker>(Socket, *RingBuffer);
+    if (!Worker->Start())
+    {
+        Worker.Reset();
+        RingBuffer.Reset();
+        bOutSuccess = false;
+        UE_LOG(LogTemp, Error, TEXT("StartStreaming is failed: Can't start the receive thread"));
+
+        return;
+    }
+
+    TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UKeyframeStreamReceiver::DrainRingBuffer));
+    StreamedWorld = Actor->GetWorld();
+    WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddUObject(this, &UKeyframeStreamReceiver::OnWorldCleanup);
+
+    bOutSuccess = true;
+}
+
+void UKeyframeStreamReceiver::StopStreaming()
+{
+    if (!Worker)
+    {
+        return;
+    }
+
+    //Stop the producer first, then key whatever is still buffered.
+    Stats.FramesReceived = Worker->GetFramesReceived();
+    Stats.FramesDropped = Worker->GetFramesDropped();
+    StopReceiving();
+
+    while (!RingBuffer->IsEmpty() && DrainRingBuffer(0.0f))
+    {
+    }
+    RingBuffer.Reset();
+
+    //Ticks only fixed the tangents around their own keys, one full pass settles the whole take.
+    if (KeyInterpolation == 0)
+    {
+        Session.AutoSetTangents();
+    }
+}
+
+void UKeyframeStreamReceiver::StopReceiving()
+{
+    Worker.Reset();
+
+    FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+    TickerHandle.Reset();
+
+    FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+    WorldCleanupHandle.Reset();
+    StreamedWorld.Reset();
+}
+
+void UKeyframeStreamReceiver::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+    if (World == StreamedWorld.Get())
+    {
+        StopStreaming();
+    }
+}
+
+bool UKeyframeStreamReceiver::IsStreaming() const
+{
+    return Worker.IsValid();
+}
+
+FKeyframeStreamStats UKeyframeStreamReceiver::GetStreamStats() const
+{
+    FKeyframeStreamStats Result{ Stats };
+    if (Worker)
+    {
+        Result.FramesReceived = Worker->GetFramesReceived();
+        Result.FramesDropped = Worker->GetFramesDropped();
+    }
+
+    return Result;
+}
+
+bool UKeyframeStreamReceiver::DrainRingBuffer(float DeltaTime)
+{
+    Batch.Reset();
+    BatchReceiveCycles.Reset();
+    FStreamedKeyframe Entry;
+    while (Batch.Num() < MaxFramesPerTick && RingBuffer->Dequeue(Entry))
+    {
+        Batch.Add(MoveTemp(Entry.Keyframe));
+        BatchReceiveCycles.Add(Entry.ReceiveCycles);
+    }
+
+    if (Batch.Num() == 0)
+    {
+        return true;
+    }
+
+    //A whole channel tangent pass per tick would grow with the take, only the appended range is fixed up.
+    bool bSuccess{ false };
+    FSequencerImportSession::BuildChannelKeys(Batch, Session.GetTimeMapping(), KeyInterpolation, BatchKeys);
+    BatchKeys.bDeferAutoTangents = true;
+    const FFrameNumber FirstTime{ BatchKeys.Times[0] };
+    const FFrameNumber LastTime{ BatchKeys.Times.Last() };
+    Session.CommitChannelKeys(BatchKeys, bSuccess);
+    if (!bSuccess)
+    {
+        UE_LOG(LogTemp, Error, TEXT("DrainRingBuffer is failed: Section is no longer valid, streaming stopped"));
+        StopReceiving();
+
+        return false;
+    }
+
+    if (KeyInterpolation == 0)
+    {
+        Session.AutoSetTangents(FirstTime, LastTime);
+    }
+
+    //Latency is measured once the keys are in the sequence.
+    const uint64 NowCycles{ FPlatformTime::Cycles64() };
+    for (const uint64 ReceiveCycles : BatchReceiveCycles)
+    {
+        TotalLatencyMs += FPlatformTime::ToMilliseconds64(NowCycles - ReceiveCycles);
+    }
+    Stats.FramesWritten += Batch.Num();
+    Stats.AverageLatencyMs = TotalLatencyMs / Stats.FramesWritten;
+    //The ring buffer is FIFO, the first entry waited longest.
+    Stats.MaxLatencyMs = FMath::Max(Stats.MaxLatencyMs, FPlatformTime::ToMilliseconds64(NowCycles - BatchReceiveCycles[0]));
+
+    return true;
+}
+
+void UKeyframeStreamReceiver::BeginDestroy()
+{
+    StopReceiving();
+
+    Super::BeginDestroy();
+}
@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Streaming/KeyframeStreamSender.h"
+
+#include "Streaming/KeyframeStreamTypes.h"
+#include "Common/UdpSocketBuilder.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+
+FKeyframeStreamSender::~FKeyframeStreamSender()
+{
+    Disconnect();
+}
+
+bool FKeyframeStreamSender::Connect(const int Port)
+{
+    Disconnect();
+
+    ISocketSubsystem* SocketSubsystem{ ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM) };
+    if (SocketSubsystem == nullptr)
+    {
+        UE_LOG(LogTemp, Error, TEXT("FKeyframeStreamSender::Connect is failed: No socket subsystem"));
+        return false;
+    }
+
+    Socket = FUdpSocketBuilder(TEXT("KeyframeStreamSender")).AsNonBlocking().Build();
+    if (Socket == nullptr)
+    {
+        UE_LOG(LogTemp, Error, TEXT("FKeyframeStreamSender::Connect is failed: Can't create socket"));
+        return false;
+    }
+
+    Destination = SocketSubsystem->CreateInternetAddr();
+    Destination->SetIp(FIPv4Address::InternalLoopback.Value);
+    Destination->SetPort(Port);
+
+    return true;
+}
+
+void FKeyframeStreamSender::Disconnect()
+{
+    if (Socket != nullptr)
+    {
+        Socket->Close();
+        ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+        Socket = nullptr;
+    }
+    Destination.Reset();
+}
+
+int32 FKeyframeStreamSender::Send(TArrayView<const FKeyframes> Keyframes)
+{
+    if (Socket == nullptr || !Destination.IsValid())
+    {
+        return 0;
+    }
+
+    TArray<uint8, TInlineAllocator<FKeyframePacketHeader::MaxDatagramSize>> Datagram;
+    int32 NumSent{ 0 };
+    for (int32 First = 0; First < Keyframes.Num(); First += FKeyframePacketHeader::MaxRecordsPerPacket)
+    {
+        const int32 NumRecords{ FMath::Min(FKeyframePacketHeader::MaxRecordsPerPacket, Keyframes.Num() - First) };
+
+        FKeyframePacketHeader Header;
+        Header.NumRecords = static_cast<uint16>(NumRecords);
+
+        Datagram.Reset();
+        Datagram.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+        for (int32 Index = First; Index < First + NumRecords; ++Index)
+        {
+            const FKeyframePacketRecord Record{ FKeyframePacketRecord::FromKeyframe(Keyframes[Index]) };
+            Datagram.Append(reinterpret_cast<const uint8*>(&Record), sizeof(Record));
+        }
+
+        int32 BytesSent{ 0 };
+        if (!Socket->SendTo(Datagram.GetData(), Datagram.Num(), BytesSent, *Destination) || BytesSent != Datagram.Num())
+        {
+            break;
+        }
+        NumSent += NumRecords;
+    }
+
+    return NumSent;
+}
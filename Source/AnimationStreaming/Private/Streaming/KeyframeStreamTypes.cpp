@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Streaming/KeyframeStreamTypes.h"
+
+
+FKeyframePacketRecord FKeyframePacketRecord::FromKeyframe(const FKeyframes& Keyframe)
+{
+    const FVector Location{ Keyframe.Coordinates.GetLocation() };
+    const FRotator Rotator{ Keyframe.Coordinates.Rotator() };
+    const FVector Scale3D{ Keyframe.Coordinates.GetScale3D() };
+
+    FKeyframePacketRecord Record;
+    Record.Frame = Keyframe.Frame;
+    Record.Translation[0] = Location.X;
+    Record.Translation[1] = Location.Y;
+    Record.Translation[2] = Location.Z;
+    Record.Rotation[0] = Rotator.Roll;
+    Record.Rotation[1] = Rotator.Pitch;
+    Record.Rotation[2] = Rotator.Yaw;
+    Record.Scale[0] = Scale3D.X;
+    Record.Scale[1] = Scale3D.Y;
+    Record.Scale[2] = Scale3D.Z;
+
+    return Record;
+}
+
+FKeyframes FKeyframePacketRecord::ToKeyframe() const
+{
+    FKeyframes Keyframe;
+    Keyframe.Frame = Frame;
+    Keyframe.Coordinates = FTransform
+    {
+        FRotator(Rotation[1], Rotation[2], Rotation[0]).Quaternion(),
+        FVector(Translation[0], Translation[1], Translation[2]),
+        FVector(Scale[0], Scale[1], Scale[2])
+    };
+
+    return Keyframe;
+}
@@ -0,0 +1,309 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Struct/KeyframeCompressedTrack.h"
+
+#include "Math/KeyframeVectorMath.h"
+#include "Sequencer/KeyframeFrameIndex.h"
+#include "Async/ParallelFor.h"
+#include "Misc/MemStack.h"
+
+
+namespace KeyframeCompressedTrack
+{
+    //Track channels of the vector channels: translation, then scale.
+    constexpr int SourceChannels[FKeyframeCompressedTrack::NumVectorChannels]{ 0, 1, 2, 6, 7, 8 };
+    constexpr int32 MaxChannelBits{ 24 };
+    constexpr int32 MaxRotationBits{ 20 };
+    constexpr int32 RotationIndexBits{ 2 };
+
+    void WriteBits(uint8* Data, const uint64 BitOffset, const uint32 Value)
+    {
+        uint64 Word;
+        FMemory::Memcpy(&Word, Data + (BitOffset >> 3), sizeof(Word));
+        Word |= static_cast<uint64>(Value) << (BitOffset & 7);
+        FMemory::Memcpy(Data + (BitOffset >> 3), &Word, sizeof(Word));
+    }
+
+    uint32 ReadBits(const uint8* Data, const uint64 BitOffset, const int32 NumBits)
+    {
+        uint64 Word;
+        FMemory::Memcpy(&Word, Data + (BitOffset >> 3), sizeof(Word));
+
+        return static_cast<uint32>((Word >> (BitOffset & 7)) & ((uint64{ 1 } << NumBits) - 1));
+    }
+
+    uint32 Quantize(const float Value, const float Min, const float Step, const int32 Bits)
+    {
+        const uint32 MaxValue{ (1u << Bits) - 1 };
+
+        return static_cast<uint32>(FMath::Clamp(FMath::RoundToInt64((static_cast<double>(Value) - Min) / Step), int64{ 0 }, static_cast<int64>(MaxValue)));
+    }
+
+    //Smallest-three components lie in [-1/sqrt(2), 1/sqrt(2)].
+    uint32 QuantizeUnit(const float Value, const int32 Bits)
+    {
+        const uint32 MaxValue{ (1u << Bits) - 1 };
+        const double Normalized{ (static_cast<double>(Value) + UE_INV_SQRT_2) / (2.0 * UE_INV_SQRT_2) };
+
+        return static_cast<uint32>(FMath::Clamp(FMath::RoundToInt64(Normalized * MaxValue), int64{ 0 }, static_cast<int64>(MaxValue)));
+    }
+
+    float DequantizeUnit(const uint32 Value, const int32 Bits)
+    {
+        const uint32 MaxValue{ (1u << Bits) - 1 };
+
+        return static_cast<float>(static_cast<double>(Value) / MaxValue * (2.0 * UE_INV_SQRT_2) - UE_INV_SQRT_2);
+    }
+}
+
+void FKeyframeCompressedTrack::Compress(const TArray<FKeyframes>& Keyframes, const FKeyframeCompressionSettings& Settings)
+{
+    Compress(FKeyframeTrackSoA::FromKeyframes(Keyframes), Settings);
+}
+
+void FKeyframeCompressedTrack::Compress(const FKeyframeTrackSoA& Track, const FKeyframeCompressionSettings& Settings)
+{
+    using namespace KeyframeCompressedTrack;
+
+    const FKeyframeFrameIndex Index{ Track.Frames };
+    NumFrames = Index.Num();
+    FirstFrame = Index.FirstFrame;
+    BlockFrames = FMath::Max(Settings.BlockFrames, 1);
+    Frames.Reset();
+    if (Index.Gaps.Num() > 0)
+    {
+        Frames.SetNumUninitialized(NumFrames);
+        for (int32 Key = 0; Key < NumFrames; ++Key)
+        {
+            Frames[Key] = Track.Frames[Index.Order[Key]];
+        }
+    }
+
+    //Channels with just enough bits that half a step stays within the tolerance.
+    uint16 Offset{ 0 };
+    for (int ChannelIndex = 0; ChannelIndex < NumVectorChannels; ++ChannelIndex)
+    {
+        const TArray<float>& Values{ Track.GetChannel(SourceChannels[ChannelIndex]) };
+        const float Tolerance{ FMath::Max(ChannelIndex < 3 ? Settings.TranslationTolerance : Settings.ScaleTolerance, UE_KINDA_SMALL_NUMBER) };
+
+        float Min{ MAX_flt };
+        float Max{ -MAX_flt };
+        for (const int32 Source : Index.Order)
+        {
+            Min = FMath::Min(Min, Values[Source]);
+            Max = FMath::Max(Max, Values[Source]);
+        }
+
+        FChannel& Channel{ Channels[ChannelIndex] };
+        Channel = FChannel();
+        if (NumFrames == 0 || Max - Min <= 2.0f * Tolerance)
+        {
+            Channel.Min = NumFrames > 0 ? 0.5f * (Min + Max) : 0.0f;
+            continue;
+        }
+
+        const double Range{ static_cast<double>(Max) - Min };
+        int32 Bits{ 1 };
+        while (Bits < MaxChannelBits && Range / ((1u << Bits) - 1) > 2.0 * Tolerance)
+        {
+            ++Bits;
+        }
+
+        Channel.Min = Min;
+        Channel.Step = static_cast<float>(Range / ((1u << Bits) - 1));
+        Channel.Bits = static_cast<uint8>(Bits);
+        Channel.Offset = Offset;
+        Offset += static_cast<uint16>(Bits);
+    }
+
+    //Euler degrees to quaternions in one batch.
+    FMemMark Mark{ FMemStack::Get() };
+    TArray<float, TMemStackAllocator<>> Euler[3];
+    TArray<float, TMemStackAllocator<>> Quat[4];
+    for (int Axis = 0; Axis < 3; ++Axis)
+    {
+        Euler[Axis].SetNumUninitialized(NumFrames);
+        for (int32 Key = 0; Key < NumFrames; ++Key)
+        {
+            Euler[Axis][Key] = Track.GetChannel(3 + Axis)[Index.Order[Key]];
+        }
+    }
+    for (int Component = 0; Component < 4; ++Component)
+    {
+        Quat[Component].SetNumUninitialized(NumFrames);
+    }
+    FKeyframeVectorMath::EulerToQuat(Euler[0].GetData(), Euler[1].GetData(), Euler[2].GetData(), Quat[0].GetData(), Quat[1].GetData(), Quat[2].GetData(), Quat[3].GetData(), NumFrames);
+
+    const auto GetRotation = [&Quat](const int32 Key)
+    {
+        return FQuat4f(Quat[0][Key], Quat[1][Key], Quat[2][Key], Quat[3][Key]).GetNormalized();
+    };
+
+    const float RotationTolerance{ FMath::DegreesToRadians(FMath::Max(Settings.RotationTolerance, UE_KINDA_SMALL_NUMBER)) };
+    ConstantRotation = NumFrames > 0 ? GetRotation(0) : FQuat4f::Identity;
+    RotationBits = 0;
+    RotationOffset = Offset;
+    for (int32 Key = 1; Key < NumFrames; ++Key)
+    {
+        if (GetRotation(Key).AngularDistance(ConstantRotation) > RotationTolerance)
+        {
+            //The angle error stays under about eight times the per-component error.
+            int32 Bits{ 4 };
+            while (Bits < MaxRotationBits && UE_INV_SQRT_2 / ((1u << Bits) - 1) > RotationTolerance / 8.0f)
+            {
+                ++Bits;
+            }
+
+            RotationBits = static_cast<uint8>(Bits);
+            Offset += static_cast<uint16>(RotationIndexBits + 3 * Bits);
+            break;
+        }
+    }
+
+    BitsPerFrame = Offset;
+    Data.Reset();
+    Data.SetNumZeroed((static_cast<int64>(NumFrames) * BitsPerFrame + 7) / 8 + sizeof(uint64));
+    if (BitsPerFrame == 0)
+    {
+        return;
+    }
+
+    for (int32 Key = 0; Key < NumFrames; ++Key)
+    {
+        const uint64 FrameOffset{ static_cast<uint64>(Key) * BitsPerFrame };
+        const int32 Source{ Index.Order[Key] };
+        for (int ChannelIndex = 0; ChannelIndex < NumVectorChannels; ++ChannelIndex)
+        {
+            const FChannel& Channel{ Channels[ChannelIndex] };
+            if (Channel.Bits > 0)
+            {
+                const float Value{ Track.GetChannel(SourceChannels[ChannelIndex])[Source] };
+                WriteBits(Data.GetData(), FrameOffset + Channel.Offset, Quantize(Value, Channel.Min, Channel.Step, Channel.Bits));
+            }
+        }
+
+        if (RotationBits > 0)
+        {
+            //Drops the largest component and makes it positive, it is rebuilt from the unit length.
+            const FQuat4f Rotation{ GetRotation(Key) };
+            float Components[4]{ Rotation.X, Rotation.Y, Rotation.Z, Rotation.W };
+            int32 Largest{ 0 };
+            for (int32 Component = 1; Component < 4; ++Component)
+            {
+                if (FMath::Abs(Components[Component]) > FMath::Abs(Components[Largest]))
+                {
+                    Largest = Component;
+                }
+            }
+            const float Sign{ Components[Largest] < 0.0f ? -1.0f : 1.0f };
+
+            uint64 BitOffset{ FrameOffset + RotationOffset };
+            WriteBits(Data.GetData(), BitOffset, static_cast<uint32>(Largest));
+            BitOffset += RotationIndexBits;
+            for (int32 Component = 0; Component < 4; ++Component)
+            {
+                if (Component != Largest)
+                {
+                    WriteBits(Data.GetData(), BitOffset, QuantizeUnit(Sign * Components[Component], RotationBits));
+                    BitOffset += RotationBits;
+                }
+            }
+        }
+    }
+}
+
+void FKeyframeCompressedTrack::CompressControls(const TMap<FString, FKeyframeTrack>& Controls, const FKeyframeCompressionSettings& Settings, TMap<FString, FKeyframeCompressedTrack>& OutTracks)
+{
+    TArray<const TPair<FString, FKeyframeTrack>*> Sources;
+    Sources.Reserve(Controls.Num());
+    for (const TPair<FString, FKeyframeTrack>& Control : Controls)
+    {
+        Sources.Add(&Control);
+    }
+
+    TArray<FKeyframeCompressedTrack> Tracks;
+    Tracks.SetNum(Sources.Num());
+    ParallelFor(Sources.Num(), [&Sources, &Tracks, &Settings](const int32 Index)
+    {
+        Tracks[Index].Compress(Sources[Index]->Value.Keyframes, Settings);
+    });
+
+    OutTracks.Reset();
+    OutTracks.Reserve(Sources.Num());
+    for (int32 Index = 0; Index < Sources.Num(); ++Index)
+    {
+        OutTracks.Add(Sources[Index]->Key, MoveTemp(Tracks[Index]));
+    }
+}
+
+FTransform FKeyframeCompressedTrack::DecompressFrame(const int32 Index) const
+{
+    FKeyframes Keyframe;
+    DecompressRange(Index, Index + 1, &Keyframe);
+
+    return Keyframe.Coordinates;
+}
+
+void FKeyframeCompressedTrack::DecompressBlock(const int32 BlockIndex, TArray<FKeyframes>& OutKeyframes) const
+{
+    const int32 Begin{ FMath::Clamp(BlockIndex * BlockFrames, 0, NumFrames) };
+    const int32 End{ FMath::Min(Begin + BlockFrames, NumFrames) };
+
+    OutKeyframes.SetNum(End - Begin);
+    DecompressRange(Begin, End, OutKeyframes.GetData());
+}
+
+void FKeyframeCompressedTrack::Decompress(TArray<FKeyframes>& OutKeyframes) const
+{
+    OutKeyframes.SetNum(NumFrames);
+    ParallelFor(GetNumBlocks(), [this, &OutKeyframes](const int32 BlockIndex)
+    {
+        const int32 Begin{ BlockIndex * BlockFrames };
+        DecompressRange(Begin, FMath::Min(Begin + BlockFrames, NumFrames), OutKeyframes.GetData() + Begin);
+    });
+}
+
+void FKeyframeCompressedTrack::DecompressRange(const int32 Begin, const int32 End, FKeyframes* OutKeyframes) const
+{
+    using namespace KeyframeCompressedTrack;
+
+    check(Begin >= 0 && End <= NumFrames);
+    for (int32 Key = Begin; Key < End; ++Key)
+    {
+        const uint64 FrameOffset{ static_cast<uint64>(Key) * BitsPerFrame };
+
+        float Values[NumVectorChannels];
+        for (int ChannelIndex = 0; ChannelIndex < NumVectorChannels; ++ChannelIndex)
+        {
+            const FChannel& Channel{ Channels[ChannelIndex] };
+            Values[ChannelIndex] = Channel.Bits > 0 ? Channel.Min + Channel.Step * ReadBits(Data.GetData(), FrameOffset + Channel.Offset, Channel.Bits) : Channel.Min;
+        }
+
+        FQuat4f Rotation{ ConstantRotation };
+        if (RotationBits > 0)
+        {
+            uint64 BitOffset{ FrameOffset + RotationOffset };
+            const int32 Largest{ static_cast<int32>(ReadBits(Data.GetData(), BitOffset, RotationIndexBits)) };
+            BitOffset += RotationIndexBits;
+
+            float Components[4];
+            float SumSquares{ 0.0f };
+            for (int32 Component = 0; Component < 4; ++Component)
+            {
+                if (Component != Largest)
+                {
+                    Components[Component] = DequantizeUnit(ReadBits(Data.GetData(), BitOffset, RotationBits), RotationBits);
+                    SumSquares += Components[Component] * Components[Component];
+                    BitOffset += RotationBits;
+                }
+            }
+            Components[Largest] = FMath::Sqrt(FMath::Max(1.0f - SumSquares, 0.0f));
+            Rotation = FQuat4f(Components[0], Components[1], Components[2], Components[3]).GetNormalized();
+        }
+
+        FKeyframes& Keyframe{ OutKeyframes[Key - Begin] };
+        Keyframe.Frame = GetFrame(Key);
+        Keyframe.Coordinates = FTransform{ FQuat(Rotation), FVector(Values[0], Values[1], Values[2]), FVector(Values[3], Values[4], Values[5]) };
+    }
+}
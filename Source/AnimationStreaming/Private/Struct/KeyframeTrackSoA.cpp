@@ -0,0 +1,174 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Struct/KeyframeTrackSoA.h"
+
+#include "Math/KeyframeVectorMath.h"
+
+
+bool FKeyframeTrackSoA::IsConsistent() const
+{
+    for (int ChannelIndex = 0; ChannelIndex < NumChannels; ++ChannelIndex)
+    {
+        if (GetChannel(ChannelIndex).Num() != Frames.Num())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void FKeyframeTrackSoA::Reserve(const int32 NumFrames)
+{
+    Frames.Reserve(NumFrames);
+    for (int ChannelIndex = 0; ChannelIndex < NumChannels; ++ChannelIndex)
+    {
+        GetChannel(ChannelIndex).Reserve(NumFrames);
+    }
+}
+
+void FKeyframeTrackSoA::Reset(const int32 NumFrames)
+{
+    Frames.Reset(NumFrames);
+    for (int ChannelIndex = 0; ChannelIndex < NumChannels; ++ChannelIndex)
+    {
+        GetChannel(ChannelIndex).Reset(NumFrames);
+    }
+}
+
+void FKeyframeTrackSoA::SetNumUninitialized(const int32 NumFrames)
+{
+    Frames.SetNumUninitialized(NumFrames);
+    for (int ChannelIndex = 0; ChannelIndex < NumChannels; ++ChannelIndex)
+    {
+        GetChannel(ChannelIndex).SetNumUninitialized(NumFrames);
+    }
+}
+
+void FKeyframeTrackSoA::Add(const int32 Frame, const float (&Translation)[3], const float (&Rotation)[3], const float (&Scale)[3])
+{
+    Frames.Add(Frame);
+    TranslationX.Add(Translation[0]);
+    TranslationY.Add(Translation[1]);
+    TranslationZ.Add(Translation[2]);
+    Roll.Add(Rotation[0]);
+    Pitch.Add(Rotation[1]);
+    Yaw.Add(Rotation[2]);
+    ScaleX.Add(Scale[0]);
+    ScaleY.Add(Scale[1]);
+    ScaleZ.Add(Scale[2]);
+}
+
+TArray<float>& FKeyframeTrackSoA::GetChannel(const int ChannelIndex)
+{
+    return const_cast<TArray<float>&>(static_cast<const FKeyframeTrackSoA*>(this)->GetChannel(ChannelIndex));
+}
+
+const TArray<float>& FKeyframeTrackSoA::GetChannel(const int ChannelIndex) const
+{
+    switch (ChannelIndex)
+    {
+    case 0: return TranslationX;
+    case 1: return TranslationY;
+    case 2: return TranslationZ;
+    case 3: return Roll;
+    case 4: return Pitch;
+    case 5: return Yaw;
+    case 6: return ScaleX;
+    case 7: return ScaleY;
+    default:
+        check(ChannelIndex == 8);
+        return ScaleZ;
+    }
+}
+
+FTransform FKeyframeTrackSoA::GetTransform(const int32 Index) const
+{
+    return FTransform
+    {
+        FRotator(Pitch[Index], Yaw[Index], Roll[Index]).Quaternion(),
+        FVector(TranslationX[Index], TranslationY[Index], TranslationZ[Index]),
+        FVector(ScaleX[Index], ScaleY[Index], ScaleZ[Index])
+    };
+}
+
+void FKeyframeTrackSoA::ToKeyframes(TArray<FKeyframes>& OutKeyframes) const
+{
+    const int32 NumFrames{ Num() };
+    TArray<float> Quat[4];
+    for (TArray<float>& Component : Quat)
+    {
+        Component.SetNumUninitialized(NumFrames);
+    }
+    FKeyframeVectorMath::EulerToQuat(Roll.GetData(), Pitch.GetData(), Yaw.GetData(), Quat[0].GetData(), Quat[1].GetData(), Quat[2].GetData(), Quat[3].GetData(), NumFrames);
+
+    OutKeyframes.Reset(NumFrames);
+    for (int32 Index = 0; Index < NumFrames; ++Index)
+    {
+        FKeyframes& Keyframe{ OutKeyframes.AddDefaulted_GetRef() };
+        Keyframe.Frame = Frames[Index];
+        Keyframe.Coordinates = FTransform
+        {
+            FQuat(Quat[0][Index], Quat[1][Index], Quat[2][Index], Quat[3][Index]),
+            FVector(TranslationX[Index], TranslationY[Index], TranslationZ[Index]),
+            FVector(ScaleX[Index], ScaleY[Index], ScaleZ[Index])
+        };
+    }
+}
+
+FKeyframeTrackSoA FKeyframeTrackSoA::FromKeyframes(const TArray<FKeyframes>& Keyframes)
+{
+    TArray<int32> Order;
+    Order.SetNumUninitialized(Keyframes.Num());
+    for (int32 Index = 0; Index < Keyframes.Num(); ++Index)
+    {
+        Order[Index] = Index;
+    }
+
+    return FromKeyframes(Keyframes, Order, false);
+}
+
+FKeyframeTrackSoA FKeyframeTrackSoA::FromKeyframes(const TArray<FKeyframes>& Keyframes, TConstArrayView<int32> Order, const bool bUnwindRotation)
+{
+    const int32 NumFrames{ Order.Num() };
+    FKeyframeTrackSoA Track;
+    Track.SetNumUninitialized(NumFrames);
+
+    TArray<float> Quat[4];
+    for (TArray<float>& Component : Quat)
+    {
+        Component.SetNumUninitialized(NumFrames);
+    }
+
+    for (int32 Index = 0; Index < NumFrames; ++Index)
+    {
+        const FKeyframes& Keyframe{ Keyframes[Order[Index]] };
+        const FVector Location{ Keyframe.Coordinates.GetLocation() };
+        const FQuat Rotation{ Keyframe.Coordinates.GetRotation() };
+        const FVector Scale{ Keyframe.Coordinates.GetScale3D() };
+
+        Track.Frames[Index] = Keyframe.Frame;
+        Track.TranslationX[Index] = static_cast<float>(Location.X);
+        Track.TranslationY[Index] = static_cast<float>(Location.Y);
+        Track.TranslationZ[Index] = static_cast<float>(Location.Z);
+        Quat[0][Index] = static_cast<float>(Rotation.X);
+        Quat[1][Index] = static_cast<float>(Rotation.Y);
+        Quat[2][Index] = static_cast<float>(Rotation.Z);
+        Quat[3][Index] = static_cast<float>(Rotation.W);
+        Track.ScaleX[Index] = static_cast<float>(Scale.X);
+        Track.ScaleY[Index] = static_cast<float>(Scale.Y);
+        Track.ScaleZ[Index] = static_cast<float>(Scale.Z);
+    }
+
+    //One batch conversion instead of a Rotator() per key.
+    FKeyframeVectorMath::QuatToEuler(Quat[0].GetData(), Quat[1].GetData(), Quat[2].GetData(), Quat[3].GetData(), Track.Roll.GetData(), Track.Pitch.GetData(), Track.Yaw.GetData(), NumFrames);
+    if (bUnwindRotation)
+    {
+        FKeyframeVectorMath::UnwindDegrees(Track.Roll.GetData(), NumFrames);
+        FKeyframeVectorMath::UnwindDegrees(Track.Pitch.GetData(), NumFrames);
+        FKeyframeVectorMath::UnwindDegrees(Track.Yaw.GetData(), NumFrames);
+    }
+
+    return Track;
+}
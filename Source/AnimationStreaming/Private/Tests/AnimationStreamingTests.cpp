@@ -0,0 +1,1080 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Benchmark/SyntheticCapture.h"
+#include "Format/KeyframeBinarySource.h"
+#include "Format/KeyframeCsvSource.h"
+#include "Import/ChunkedKeyframeImporter.h"
+#include "Json/KeyframeCache.h"
+#include "Json/KeyframeJsonParser.h"
+#include "Playback/KeyframePlaybackTrack.h"
+#include "Sequencer/KeyframeDeltaImport.h"
+#include "Sequencer/KeyframeFrameIndex.h"
+#include "Sequencer/SequencerImportSession.h"
+#include "Struct/KeyframeCompressedTrack.h"
+
+#include "Runtime/LevelSequence/Public/LevelSequence.h"
+#include "MovieScene.h"
+#include "Tracks/MovieScene3DTransformTrack.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Math/RandomStream.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace AnimationStreamingTests
+{
+    constexpr int32 Seed{ 1337 };
+    constexpr int32 NumFrames{ 300 };
+    constexpr int32 NumControls{ 3 };
+    //Synthetic captures print five decimals.
+    constexpr float JsonTolerance{ 1.e-4f };
+
+    //Adds one error for the first mismatch instead of one per value.
+    bool TestTracksEqual(FAutomationTestBase& Test, const FString& What, const FKeyframeTrackSoA& Actual, const FKeyframeTrackSoA& Expected, const float Tolerance)
+    {
+        if (!Test.TestEqual(FString::Printf(TEXT("%s frame count"), *What), Actual.Num(), Expected.Num()))
+        {
+            return false;
+        }
+
+        for (int32 Index = 0; Index < Expected.Num(); ++Index)
+        {
+            if (Actual.Frames[Index] != Expected.Frames[Index])
+            {
+                Test.AddError(FString::Printf(TEXT("%s frame %d is %d, expected %d"), *What, Index, Actual.Frames[Index], Expected.Frames[Index]));
+                return false;
+            }
+
+            for (int ChannelIndex = 0; ChannelIndex < FKeyframeTrackSoA::NumChannels; ++ChannelIndex)
+            {
+                const float Value{ Actual.GetChannel(ChannelIndex)[Index] };
+                const float ExpectedValue{ Expected.GetChannel(ChannelIndex)[Index] };
+                if (!FMath::IsNearlyEqual(Value, ExpectedValue, Tolerance))
+                {
+                    Test.AddError(FString::Printf(TEXT("%s channel %d at frame %d is %f, expected %f"), *What, ChannelIndex, Expected.Frames[Index], Value, ExpectedValue));
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    //Keys of every channel of Session must be Track at the session's tick resolution.
+    bool TestSessionKeys(FAutomationTestBase& Test, const FString& What, const FSequencerImportSession& Session, const FKeyframeTrackSoA& Track)
+    {
+        for (int ChannelIndex = 0; ChannelIndex < FSequencerImportSession::NumTransformChannels; ++ChannelIndex)
+        {
+            const FMovieSceneDoubleChannel* Channel{ Session.GetChannel(ChannelIndex) };
+            if (!Test.TestNotNull(FString::Printf(TEXT("%s channel %d"), *What, ChannelIndex), Channel))
+            {
+                return false;
+            }
+
+            const TArrayView<const FFrameNumber> Times{ Channel->GetTimes() };
+            const TArrayView<const FMovieSceneDoubleValue> Values{ Channel->GetValues() };
+            if (!Test.TestEqual(FString::Printf(TEXT("%s channel %d key count"), *What, ChannelIndex), Times.Num(), Track.Num()))
+            {
+                return false;
+            }
+
+            //Rotation channels may be unwound along the take, only the translation and scale values are compared.
+            const bool bCompareValues{ ChannelIndex < 3 || ChannelIndex > 5 };
+            for (int32 Index = 0; Index < Track.Num(); ++Index)
+            {
+                if (Times[Index] != Session.GetTimeMapping().ToTick(Track.Frames[Index]))
+                {
+                    Test.AddError(FString::Printf(TEXT("%s channel %d key %d is at tick %d"), *What, ChannelIndex, Index, Times[Index].Value));
+                    return false;
+                }
+
+                if (bCompareValues && !FMath::IsNearlyEqual(Values[Index].Value, static_cast<double>(Track.GetChannel(ChannelIndex)[Index]), 1.e-4))
+                {
+                    Test.AddError(FString::Printf(TEXT("%s channel %d key %d is %f"), *What, ChannelIndex, Index, Values[Index].Value));
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    //Every channel of Actual must hold the keys of Expected, tangents included.
+    bool TestSameChannels(FAutomationTestBase& Test, const FString& What, const FSequencerImportSession& Actual, const FSequencerImportSession& Expected, const double ValueTolerance)
+    {
+        for (int ChannelIndex = 0; ChannelIndex < FSequencerImportSession::NumTransformChannels; ++ChannelIndex)
+        {
+            const TArrayView<const FFrameNumber> ActualTimes{ Actual.GetChannel(ChannelIndex)->GetTimes() };
+            const TArrayView<const FFrameNumber> ExpectedTimes{ Expected.GetChannel(ChannelIndex)->GetTimes() };
+            const TArrayView<const FMovieSceneDoubleValue> ActualValues{ Actual.GetChannel(ChannelIndex)->GetValues() };
+            const TArrayView<const FMovieSceneDoubleValue> ExpectedValues{ Expected.GetChannel(ChannelIndex)->GetValues() };
+            if (!Test.TestEqual(FString::Printf(TEXT("%s channel %d key count"), *What, ChannelIndex), ActualTimes.Num(), ExpectedTimes.Num()))
+            {
+                return false;
+            }
+
+            for (int32 Index = 0; Index < ExpectedTimes.Num(); ++Index)
+            {
+                const FMovieSceneDoubleValue& Key{ ActualValues[Index] };
+                const FMovieSceneDoubleValue& ExpectedKey{ ExpectedValues[Index] };
+                if (ActualTimes[Index] != ExpectedTimes[Index] || Key.InterpMode != ExpectedKey.InterpMode
+                    || !FMath::IsNearlyEqual(Key.Value, ExpectedKey.Value, ValueTolerance)
+                    || !FMath::IsNearlyEqual(Key.Tangent.ArriveTangent, ExpectedKey.Tangent.ArriveTangent, 1.e-4f)
+                    || !FMath::IsNearlyEqual(Key.Tangent.LeaveTangent, ExpectedKey.Tangent.LeaveTangent, 1.e-4f))
+                {
+                    Test.AddError(FString::Printf(TEXT("%s channel %d key %d is %f at tick %d, expected %f at tick %d"), *What, ChannelIndex, Index, Key.Value, ActualTimes[Index].Value, ExpectedKey.Value, ExpectedTimes[Index].Value));
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKeyframeJsonParserRoundTripTest, "AnimationStreaming.Json.ParseRoundTrip", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKeyframeJsonParserRoundTripTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimationStreamingTests;
+
+    TArray<uint8> Json;
+    FSyntheticCapture::WriteJson(NumFrames, NumControls, Seed, Json);
+
+    FString InfoMessage;
+    TMap<FString, FKeyframeTrackSoA> Controls;
+    if (!TestTrue(TEXT("ParseAllControls"), FKeyframeJsonParser::ParseAllControls(Json, Controls, InfoMessage)))
+    {
+        AddError(InfoMessage);
+        return false;
+    }
+    TestEqual(TEXT("Control count"), Controls.Num(), NumControls);
+
+    for (int32 ControlIndex = 0; ControlIndex < NumControls; ++ControlIndex)
+    {
+        const FString ControlName{ FSyntheticCapture::GetControlName(ControlIndex) };
+        const FKeyframeTrackSoA* Parsed{ Controls.Find(ControlName) };
+        if (TestNotNull(ControlName, Parsed))
+        {
+            TestTracksEqual(*this, ControlName, *Parsed, FSyntheticCapture::MakeTrack(NumFrames, ControlIndex, Seed), JsonTolerance);
+        }
+    }
+
+    //Range split parses must give exactly the serial result.
+    const FString ControlName{ FSyntheticCapture::GetControlName(1) };
+    FKeyframeTrackSoA Serial;
+    FKeyframeTrackSoA Split;
+    TestTrue(TEXT("Serial ParseControl"), FKeyframeJsonParser::ParseControl(Json, ControlName, Serial, InfoMessage, 1));
+    TestTrue(TEXT("Split ParseControl"), FKeyframeJsonParser::ParseControl(Json, ControlName, Split, InfoMessage, 4));
+    TestTracksEqual(*this, TEXT("Split parse"), Split, Serial, 0.0f);
+
+    //A bad number in the middle of the first control passes the structural pre-scan and fails the range parse,
+    //the output keeps only what it held before the call.
+    TArray<uint8> Corrupted{ Json };
+    const FAnsiStringView Text{ reinterpret_cast<const ANSICHAR*>(Corrupted.GetData()), Corrupted.Num() };
+    const int32 ValueIndex{ Text.Find("\"x\": ", Corrupted.Num() / (2 * NumControls)) };
+    if (TestTrue(TEXT("Found a value to corrupt"), ValueIndex != INDEX_NONE))
+    {
+        Corrupted[ValueIndex + 5] = 'q';
+        for (const int32 NumRanges : { 1, 4 })
+        {
+            FKeyframeTrackSoA Prefilled{ FSyntheticCapture::MakeTrack(5, 0, Seed) };
+            TestFalse(FString::Printf(TEXT("Corrupted ParseControl in %d ranges"), NumRanges), FKeyframeJsonParser::ParseControl(Corrupted, FSyntheticCapture::GetControlName(0), Prefilled, InfoMessage, NumRanges));
+            TestTracksEqual(*this, FString::Printf(TEXT("Output of a failed parse in %d ranges"), NumRanges), Prefilled, FSyntheticCapture::MakeTrack(5, 0, Seed), 0.0f);
+        }
+
+        //Tokens made of number characters must still follow the JSON number grammar.
+        const int32 NumberBegin{ ValueIndex + 5 };
+        int32 NumberEnd{ NumberBegin };
+        while (NumberEnd < Json.Num() && Json[NumberEnd] != ',')
+        {
+            ++NumberEnd;
+        }
+        for (const ANSICHAR* Token : { "1-2", "--3", "01", "1.", ".5", "1e", "+1", "1e+-2" })
+        {
+            TArray<uint8> Malformed{ Json.GetData(), NumberBegin };
+            Malformed.Append(reinterpret_cast<const uint8*>(Token), FCStringAnsi::Strlen(Token));
+            Malformed.Append(Json.GetData() + NumberEnd, Json.Num() - NumberEnd);
+
+            FKeyframeTrackSoA Track;
+            TestFalse(FString::Printf(TEXT("Number '%hs' is rejected"), Token), FKeyframeJsonParser::ParseControl(Malformed, FSyntheticCapture::GetControlName(0), Track, InfoMessage, 1));
+        }
+        for (const ANSICHAR* Token : { "0", "-0.5", "2.5e-3", "-1E+2" })
+        {
+            TArray<uint8> WellFormed{ Json.GetData(), NumberBegin };
+            WellFormed.Append(reinterpret_cast<const uint8*>(Token), FCStringAnsi::Strlen(Token));
+            WellFormed.Append(Json.GetData() + NumberEnd, Json.Num() - NumberEnd);
+
+            FKeyframeTrackSoA Track;
+            TestTrue(FString::Printf(TEXT("Number '%hs' is accepted"), Token), FKeyframeJsonParser::ParseControl(WellFormed, FSyntheticCapture::GetControlName(0), Track, InfoMessage, 1));
+        }
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKeyframeCacheTest, "AnimationStreaming.Json.Cache", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKeyframeCacheTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimationStreamingTests;
+
+    const FString SourcePath{ FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("AnimationStreaming"), TEXT("CacheTest.json")) };
+    const FString CachePath{ FKeyframeCache::GetCachePath(SourcePath) };
+    IFileManager::Get().Delete(*CachePath, false, true, true);
+
+    TArray<uint8> Json;
+    FSyntheticCapture::WriteJson(NumFrames, NumControls, Seed, Json);
+    if (!TestTrue(TEXT("Save source"), FFileHelper::SaveArrayToFile(Json, *SourcePath)))
+    {
+        return false;
+    }
+
+    FString InfoMessage;
+    TMap<FString, FKeyframeTrackSoA> Controls;
+    TestTrue(TEXT("ParseAllControls"), FKeyframeJsonParser::ParseAllControls(Json, Controls, InfoMessage));
+
+    //A single control merge caches that control only and does not pass as a complete sidecar.
+    const FString FirstName{ FSyntheticCapture::GetControlName(0) };
+    TMap<FString, FKeyframeTrackSoA> FirstControl;
+    FirstControl.Add(FirstName, Controls.FindChecked(FirstName));
+    TestTrue(TEXT("Merge"), FKeyframeCache::Merge(SourcePath, Json, FirstControl));
+
+    TMap<FString, FKeyframeTrack> LoadedAll;
+    TestFalse(TEXT("LoadAll of a partial sidecar"), FKeyframeCache::LoadAll(SourcePath, LoadedAll));
+
+    FKeyframeTrackSoA Loaded;
+    if (TestTrue(TEXT("Load merged control"), FKeyframeCache::Load(SourcePath, FirstName, Loaded)))
+    {
+        TestTracksEqual(*this, TEXT("Merged control"), Loaded, Controls.FindChecked(FirstName), 0.0f);
+    }
+    TestFalse(TEXT("Load of a control that was not merged"), FKeyframeCache::Load(SourcePath, FSyntheticCapture::GetControlName(1), Loaded));
+
+    //A full write is complete and every control reads back as written, also through the mapped view.
+    TestTrue(TEXT("Write"), FKeyframeCache::Write(SourcePath, Json, Controls));
+    if (TestTrue(TEXT("LoadAll"), FKeyframeCache::LoadAll(SourcePath, LoadedAll)))
+    {
+        TestEqual(TEXT("LoadAll control count"), LoadedAll.Num(), NumControls);
+    }
+
+    TMap<FString, FKeyframeTrackSoA> LoadedTracks;
+    if (TestTrue(TEXT("LoadAll tracks"), FKeyframeCache::LoadAll(SourcePath, LoadedTracks)))
+    {
+        for (const TPair<FString, FKeyframeTrackSoA>& Control : Controls)
+        {
+            if (const FKeyframeTrackSoA* Track = LoadedTracks.Find(Control.Key))
+            {
+                TestTracksEqual(*this, FString::Printf(TEXT("LoadAll track %s"), *Control.Key), *Track, Control.Value, 0.0f);
+            }
+            else
+            {
+                AddError(FString::Printf(TEXT("LoadAll tracks lost '%s'"), *Control.Key));
+            }
+        }
+    }
+
+    {
+        FKeyframeCacheView View;
+        if (TestTrue(TEXT("Open view"), View.Open(SourcePath)))
+        {
+            TestTrue(TEXT("View is complete"), View.IsComplete());
+            TestEqual(TEXT("View control count"), View.GetControls().Num(), NumControls);
+        }
+    }
+
+    for (const TPair<FString, FKeyframeTrackSoA>& Control : Controls)
+    {
+        if (TestTrue(FString::Printf(TEXT("Load %s"), *Control.Key), FKeyframeCache::Load(SourcePath, Control.Key, Loaded)))
+        {
+            TestTracksEqual(*this, Control.Key, Loaded, Control.Value, 0.0f);
+        }
+    }
+
+    //Another take of the same size makes the sidecar stale.
+    TArray<uint8> OtherJson;
+    FSyntheticCapture::WriteJson(NumFrames, NumControls, Seed + 1, OtherJson);
+    FFileHelper::SaveArrayToFile(OtherJson, *SourcePath);
+    TestFalse(TEXT("Load of a stale sidecar"), FKeyframeCache::Load(SourcePath, FirstName, Loaded));
+
+    IFileManager::Get().Delete(*SourcePath, false, true, true);
+    IFileManager::Get().Delete(*CachePath, false, true, true);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSequencerImportSessionKeyingTest, "AnimationStreaming.Sequencer.Keying", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSequencerImportSessionKeyingTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimationStreamingTests;
+
+    TArray<FGuid> Bindings;
+    ULevelSequence* Sequence{ FSyntheticCapture::MakeTransientSequence(2, Bindings) };
+    const FKeyframeTrackSoA Track{ FSyntheticCapture::MakeTrack(NumFrames, 0, Seed) };
+
+    //Batch write.
+    bool bSuccess{ false };
+    FSequencerImportSession BatchSession{ Sequence, Bindings[0], 0, bSuccess };
+    if (TestTrue(TEXT("Batch session is valid"), BatchSession.IsValid()))
+    {
+        BatchSession.AddTransformKeyframes(Track, 1, bSuccess);
+        TestTrue(TEXT("AddTransformKeyframes"), bSuccess);
+        TestSessionKeys(*this, TEXT("Batch"), BatchSession, Track);
+
+        //Writing the take again replaces the keys instead of adding to them.
+        BatchSession.AddTransformKeyframes(Track, 1, bSuccess);
+        TestSessionKeys(*this, TEXT("Batch rewrite"), BatchSession, Track);
+    }
+
+    //Per-key writes, in reverse so every key is a sorted insert, end up with the same keys.
+    FSequencerImportSession PerKeySession{ Sequence, Bindings[1], 0, bSuccess };
+    if (TestTrue(TEXT("Per-key session is valid"), PerKeySession.IsValid()))
+    {
+        for (int32 Index = Track.Num() - 1; Index >= 0; --Index)
+        {
+            PerKeySession.AddTransformKeyframe(Track.Frames[Index], Track.GetTransform(Index), 1, bSuccess);
+        }
+        TestSessionKeys(*this, TEXT("Per-key"), PerKeySession, Track);
+    }
+
+    Sequence->MarkAsGarbage();
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSequencerImportSessionRotationTest, "AnimationStreaming.Sequencer.Rotation", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSequencerImportSessionRotationTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimationStreamingTests;
+
+    //The yaw of the take crosses the +-180 seam, every import path must unwind it the same way.
+    const FKeyframeTrackSoA Track{ FSyntheticCapture::MakeTrack(NumFrames, 0, Seed) };
+    TArray<FKeyframes> Keyframes;
+    Track.ToKeyframes(Keyframes);
+
+    TArray<FGuid> Bindings;
+    ULevelSequence* Sequence{ FSyntheticCapture::MakeTransientSequence(4, Bindings) };
+    bool bSuccess{ false };
+    FSequencerImportSession TrackSession{ Sequence, Bindings[0], 0, bSuccess };
+    FSequencerImportSession KeyframesSession{ Sequence, Bindings[1], 0, bSuccess };
+    FSequencerImportSession PerKeySession{ Sequence, Bindings[2], 0, bSuccess };
+    FSequencerImportSession ChunkedSession{ Sequence, Bindings[3], 0, bSuccess };
+
+    TrackSession.AddTransformKeyframes(Track, 1, bSuccess);
+    KeyframesSession.AddTransformKeyframes(Keyframes, 1, bSuccess);
+    for (int32 Index = 0; Index < Track.Num(); ++Index)
+    {
+        PerKeySession.AddTransformKeyframe(Track.Frames[Index], Track.GetTransform(Index), 1, bSuccess);
+    }
+
+    //Chunks are unwound on their own and must still continue the keys before them.
+    constexpr int32 ChunkSize{ 64 };
+    for (int32 First = 0; First < Track.Num(); First += ChunkSize)
+    {
+        const int32 Num{ FMath::Min(ChunkSize, Track.Num() - First) };
+        FKeyframeTrackSoA Chunk;
+        Chunk.SetNumUninitialized(Num);
+        FMemory::Memcpy(Chunk.Frames.GetData(), Track.Frames.GetData() + First, Num * sizeof(int32));
+        for (int ChannelIndex = 0; ChannelIndex < FKeyframeTrackSoA::NumChannels; ++ChannelIndex)
+        {
+            FMemory::Memcpy(Chunk.GetChannel(ChannelIndex).GetData(), Track.GetChannel(ChannelIndex).GetData() + First, Num * sizeof(float));
+        }
+        ChunkedSession.AddTransformKeyframes(Chunk, 1, bSuccess);
+    }
+
+    const TPair<const TCHAR*, const FSequencerImportSession*> Paths[]{ { TEXT("Keyframes"), &KeyframesSession }, { TEXT("Per-key"), &PerKeySession }, { TEXT("Chunked"), &ChunkedSession } };
+    for (int ChannelIndex = 3; ChannelIndex < 6; ++ChannelIndex)
+    {
+        const TArrayView<const FMovieSceneDoubleValue> Expected{ TrackSession.GetChannel(ChannelIndex)->GetValues() };
+        if (!TestEqual(FString::Printf(TEXT("Track channel %d key count"), ChannelIndex), Expected.Num(), Track.Num()))
+        {
+            continue;
+        }
+
+        for (int32 Index = 1; Index < Expected.Num(); ++Index)
+        {
+            if (FMath::Abs(Expected[Index].Value - Expected[Index - 1].Value) > 180.0)
+            {
+                AddError(FString::Printf(TEXT("Track channel %d jumps %f degrees at key %d"), ChannelIndex, Expected[Index].Value - Expected[Index - 1].Value, Index));
+                break;
+            }
+        }
+
+        for (const TPair<const TCHAR*, const FSequencerImportSession*>& Path : Paths)
+        {
+            const TArrayView<const FMovieSceneDoubleValue> Values{ Path.Value->GetChannel(ChannelIndex)->GetValues() };
+            if (!TestEqual(FString::Printf(TEXT("%s channel %d key count"), Path.Key, ChannelIndex), Values.Num(), Expected.Num()))
+            {
+                continue;
+            }
+
+            for (int32 Index = 0; Index < Values.Num(); ++Index)
+            {
+                if (!FMath::IsNearlyEqual(Values[Index].Value, Expected[Index].Value, 1.e-2))
+                {
+                    AddError(FString::Printf(TEXT("%s channel %d key %d is %f, the track import has %f"), Path.Key, ChannelIndex, Index, Values[Index].Value, Expected[Index].Value));
+                    break;
+                }
+            }
+        }
+    }
+
+    Sequence->MarkAsGarbage();
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKeyframeSourcesTest, "AnimationStreaming.Format.Sources", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKeyframeSourcesTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimationStreamingTests;
+
+    TMap<FString, FKeyframeTrackSoA> Controls;
+    for (int32 ControlIndex = 0; ControlIndex < NumControls; ++ControlIndex)
+    {
+        Controls.Add(FSyntheticCapture::GetControlName(ControlIndex), FSyntheticCapture::MakeTrack(NumFrames, ControlIndex, Seed));
+    }
+
+    const FKeyframeBinarySource Binary;
+    TArray<uint8> Kfb;
+    FKeyframeBinarySource::Write(Controls, false, Kfb);
+
+    FString InfoMessage;
+    TMap<FString, FKeyframeTrackSoA> Loaded;
+    TestTrue(TEXT("Binary LoadAllControls"), Binary.LoadAllControls(Kfb, Loaded, InfoMessage));
+    for (const TPair<FString, FKeyframeTrackSoA>& Control : Controls)
+    {
+        if (const FKeyframeTrackSoA* Track = Loaded.Find(Control.Key))
+        {
+            TestTracksEqual(*this, FString::Printf(TEXT("Binary %s"), *Control.Key), *Track, Control.Value, 0.0f);
+        }
+        else
+        {
+            AddError(FString::Printf(TEXT("Binary capture lost '%s'"), *Control.Key));
+        }
+    }
+
+    //Every truncation point and the untrusted counts must fail cleanly instead of reading past the bytes.
+    for (const int32 Size : { 0, 8, 16, 20, Kfb.Num() / 2, Kfb.Num() - 1 })
+    {
+        TMap<FString, FKeyframeTrackSoA> Truncated;
+        TestFalse(FString::Printf(TEXT("Binary capture truncated to %d bytes"), Size), Binary.LoadAllControls(TArrayView<const uint8>(Kfb.GetData(), Size), Truncated, InfoMessage));
+    }
+
+    TArray<uint8> HugeCount{ Kfb };
+    const uint32 NumControlsField{ MAX_uint32 };
+    FMemory::Memcpy(HugeCount.GetData() + STRUCT_OFFSET(FKeyframeBinaryHeader, NumControls), &NumControlsField, sizeof(NumControlsField));
+    TMap<FString, FKeyframeTrackSoA> Corrupted;
+    TestFalse(TEXT("Binary capture with a huge control count"), Binary.LoadAllControls(HugeCount, Corrupted, InfoMessage));
+
+    TArray<uint8> HugeRecords{ Kfb };
+    const uint32 NumRecordsField{ 0x80000000u };
+    FMemory::Memcpy(HugeRecords.GetData() + sizeof(FKeyframeBinaryHeader) + STRUCT_OFFSET(FKeyframeBinaryControlHeader, NumRecords), &NumRecordsField, sizeof(NumRecordsField));
+    TestFalse(TEXT("Binary capture with a negative record count"), Binary.LoadAllControls(HugeRecords, Corrupted, InfoMessage));
+
+    //CSV rows: frames must be whole int32 numbers, values must follow the number grammar.
+    const FKeyframeCsvSource Csv;
+    const auto LoadCsv = [&Csv, &InfoMessage](const ANSICHAR* Text, FKeyframeTrackSoA& OutTrack)
+    {
+        return Csv.LoadControl(TArrayView<const uint8>(reinterpret_cast<const uint8*>(Text), FCStringAnsi::Strlen(Text)), TEXT("global_ctrl"), OutTrack, InfoMessage);
+    };
+
+    FKeyframeTrackSoA CsvTrack;
+    if (TestTrue(TEXT("Valid CSV"), LoadCsv("frame,tx,ty,tz\n0,1,2,3\n-4,0.5,-1e2,0\n", CsvTrack)) && TestEqual(TEXT("CSV rows"), CsvTrack.Num(), 2))
+    {
+        TestEqual(TEXT("CSV negative frame"), CsvTrack.Frames[1], -4);
+        TestEqual(TEXT("CSV exponent value"), CsvTrack.TranslationY[1], -100.0f);
+    }
+
+    for (const ANSICHAR* Text : { "frame,tx\n12.5,0\n", "frame,tx\n1e3,0\n", "frame,tx\n,0\n", "frame,tx\n3000000000,0\n", "tx,frame\n1\n", "frame,tx\n1,1-2\n", "frame,tx\n1,--3\n" })
+    {
+        FKeyframeTrackSoA Rejected;
+        if (TestFalse(FString::Printf(TEXT("CSV '%hs' is rejected"), Text), LoadCsv(Text, Rejected)))
+        {
+            TestTrue(FString::Printf(TEXT("CSV '%hs' error names the line"), Text), InfoMessage.Contains(TEXT("line 2")));
+        }
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKeyframeCompressedTrackTest, "AnimationStreaming.Struct.Compression", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKeyframeCompressedTrackTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimationStreamingTests;
+
+    const FKeyframeTrackSoA Contiguous{ FSyntheticCapture::MakeTrack(NumFrames, 1, Seed) };
+    //Every third frame dropped, so the track keeps its frame numbers.
+    FKeyframeTrackSoA Gapped;
+    for (int32 Index = 0; Index < Contiguous.Num(); ++Index)
+    {
+        if (Index % 3 != 2)
+        {
+            const float Translation[3]{ Contiguous.TranslationX[Index], Contiguous.TranslationY[Index], Contiguous.TranslationZ[Index] };
+            const float Rotation[3]{ Contiguous.Roll[Index], Contiguous.Pitch[Index], Contiguous.Yaw[Index] };
+            const float Scale[3]{ Contiguous.ScaleX[Index], Contiguous.ScaleY[Index], Contiguous.ScaleZ[Index] };
+            Gapped.Add(Contiguous.Frames[Index], Translation, Rotation, Scale);
+        }
+    }
+
+    FKeyframeCompressionSettings Settings;
+    Settings.BlockFrames = 64;
+
+    for (const FKeyframeTrackSoA* Track : { &Contiguous, &Gapped })
+    {
+        const FString What{ Track == &Contiguous ? TEXT("Contiguous") : TEXT("Gapped") };
+
+        FKeyframeCompressedTrack Compressed;
+        Compressed.Compress(*Track, Settings);
+        if (!TestEqual(FString::Printf(TEXT("%s frame count"), *What), Compressed.Num(), Track->Num()))
+        {
+            continue;
+        }
+        TestTrue(FString::Printf(TEXT("%s is smaller than the track"), *What), Compressed.GetAllocatedSize() < static_cast<SIZE_T>(Track->Num()) * sizeof(float) * (FKeyframeTrackSoA::NumChannels + 1));
+
+        TArray<FKeyframes> Decompressed;
+        Compressed.Decompress(Decompressed);
+
+        double MaxTranslationError{ 0.0 };
+        double MaxRotationError{ 0.0 };
+        double MaxScaleError{ 0.0 };
+        for (int32 Index = 0; Index < Track->Num(); ++Index)
+        {
+            const FTransform Expected{ Track->GetTransform(Index) };
+            const FTransform& Actual{ Decompressed[Index].Coordinates };
+            if (Decompressed[Index].Frame != Track->Frames[Index] || Compressed.GetFrame(Index) != Track->Frames[Index])
+            {
+                AddError(FString::Printf(TEXT("%s key %d is frame %d, expected %d"), *What, Index, Decompressed[Index].Frame, Track->Frames[Index]));
+                break;
+            }
+
+            MaxTranslationError = FMath::Max(MaxTranslationError, (Expected.GetLocation() - Actual.GetLocation()).GetAbs().GetMax());
+            MaxScaleError = FMath::Max(MaxScaleError, (Expected.GetScale3D() - Actual.GetScale3D()).GetAbs().GetMax());
+            MaxRotationError = FMath::Max(MaxRotationError, FMath::RadiansToDegrees(Expected.GetRotation().AngularDistance(Actual.GetRotation())));
+
+            //Random access decodes the same bits.
+            if (!Compressed.DecompressFrame(Index).Equals(Actual, 0.0))
+            {
+                AddError(FString::Printf(TEXT("%s DecompressFrame %d differs from Decompress"), *What, Index));
+                break;
+            }
+        }
+
+        TestTrue(FString::Printf(TEXT("%s translation error %f within tolerance"), *What, MaxTranslationError), MaxTranslationError <= Settings.TranslationTolerance);
+        TestTrue(FString::Printf(TEXT("%s rotation error %f within tolerance"), *What, MaxRotationError), MaxRotationError <= Settings.RotationTolerance);
+        TestTrue(FString::Printf(TEXT("%s scale error %f within tolerance"), *What, MaxScaleError), MaxScaleError <= Settings.ScaleTolerance);
+
+        //Blocks cover the track in order.
+        TArray<FKeyframes> Block;
+        int32 Offset{ 0 };
+        for (int32 BlockIndex = 0; BlockIndex < Compressed.GetNumBlocks(); ++BlockIndex)
+        {
+            Compressed.DecompressBlock(BlockIndex, Block);
+            for (int32 Index = 0; Index < Block.Num() && Offset + Index < Decompressed.Num(); ++Index)
+            {
+                if (Block[Index].Frame != Decompressed[Offset + Index].Frame || !Block[Index].Coordinates.Equals(Decompressed[Offset + Index].Coordinates, 0.0))
+                {
+                    AddError(FString::Printf(TEXT("%s block %d key %d differs from Decompress"), *What, BlockIndex, Index));
+                    break;
+                }
+            }
+            Offset += Block.Num();
+        }
+        TestEqual(FString::Printf(TEXT("%s block key count"), *What), Offset, Track->Num());
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSequencerImportSessionFanOutTest, "AnimationStreaming.Sequencer.FanOut", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSequencerImportSessionFanOutTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimationStreamingTests;
+
+    const FKeyframeTrackSoA Track{ FSyntheticCapture::MakeTrack(NumFrames, 0, Seed) };
+
+    //Two sequences share a time mapping and one builds its own keys at another display rate.
+    TArray<ULevelSequence*> Sequences;
+    TArray<FSequencerImportSession> Sessions;
+    for (int32 Index = 0; Index < 3; ++Index)
+    {
+        TArray<FGuid> Bindings;
+        Sequences.Add(FSyntheticCapture::MakeTransientSequence(1, Bindings));
+        if (Index == 2)
+        {
+            Sequences.Last()->GetMovieScene()->SetDisplayRate(FFrameRate(24, 1));
+        }
+
+        bool bSuccess{ false };
+        Sessions.Emplace(Sequences.Last(), Bindings[0], 0, bSuccess);
+        TestTrue(FString::Printf(TEXT("Session %d is valid"), Index), Sessions.Last().IsValid());
+    }
+
+    bool bSuccess{ false };
+    FKeyframeImportReport Report;
+    FSequencerImportSession::CommitTrackToSessions(Sessions, Track, 1, bSuccess, Report);
+    TestTrue(TEXT("CommitTrackToSessions"), bSuccess);
+    TestEqual(TEXT("Keys written"), Report.KeysWritten, Track.Num() * FSequencerImportSession::NumTransformChannels * Sessions.Num());
+
+    for (int32 Index = 0; Index < Sessions.Num(); ++Index)
+    {
+        TestSessionKeys(*this, FString::Printf(TEXT("Fan-out %d"), Index), Sessions[Index], Track);
+    }
+
+    //Cubic keys: fresh targets share the tangents of one build, a target with keys runs its own pass.
+    //Both must match a single import into one section.
+    TArray<ULevelSequence*> CubicSequences;
+    TArray<FSequencerImportSession> CubicSessions;
+    for (int32 Index = 0; Index < 3; ++Index)
+    {
+        TArray<FGuid> CubicBindings;
+        CubicSequences.Add(FSyntheticCapture::MakeTransientSequence(1, CubicBindings));
+        CubicSessions.Emplace(CubicSequences.Last(), CubicBindings[0], 0, bSuccess);
+    }
+    CubicSessions[1].AddTransformKeyframes(FSyntheticCapture::MakeTrack(NumFrames, 1, Seed), 0, bSuccess);
+    FSequencerImportSession Single{ MoveTemp(CubicSessions.Last()) };
+    CubicSessions.Pop();
+    Single.AddTransformKeyframes(Track, 0, bSuccess);
+
+    FSequencerImportSession::CommitTrackToSessions(CubicSessions, Track, 0, bSuccess, Report);
+    TestTrue(TEXT("Cubic CommitTrackToSessions"), bSuccess);
+    for (int32 Index = 0; Index < CubicSessions.Num(); ++Index)
+    {
+        for (int ChannelIndex = 0; ChannelIndex < FSequencerImportSession::NumTransformChannels; ++ChannelIndex)
+        {
+            const TArrayView<const FMovieSceneDoubleValue> Values{ CubicSessions[Index].GetChannel(ChannelIndex)->GetValues() };
+            const TArrayView<const FMovieSceneDoubleValue> Expected{ Single.GetChannel(ChannelIndex)->GetValues() };
+            if (!TestEqual(FString::Printf(TEXT("Cubic fan-out %d channel %d key count"), Index, ChannelIndex), Values.Num(), Expected.Num()))
+            {
+                continue;
+            }
+
+            for (int32 Key = 0; Key < Values.Num(); ++Key)
+            {
+                if (!FMath::IsNearlyEqual(Values[Key].Value, Expected[Key].Value) || !FMath::IsNearlyEqual(Values[Key].Tangent.ArriveTangent, Expected[Key].Tangent.ArriveTangent)
+                    || !FMath::IsNearlyEqual(Values[Key].Tangent.LeaveTangent, Expected[Key].Tangent.LeaveTangent))
+                {
+                    AddError(FString::Printf(TEXT("Cubic fan-out %d channel %d key %d differs from a single import"), Index, ChannelIndex, Key));
+                    break;
+                }
+            }
+        }
+    }
+
+    //An invalid target fails the whole fan-out before anything is written.
+    TArray<FGuid> Bindings;
+    ULevelSequence* Untouched{ FSyntheticCapture::MakeTransientSequence(1, Bindings) };
+    TArray<FSequencerImportSession> WithInvalid;
+    WithInvalid.Emplace(Untouched, Bindings[0], 0, bSuccess);
+    WithInvalid.AddDefaulted();
+
+    AddExpectedError(TEXT("CommitTrackToSessions is failed"), EAutomationExpectedErrorFlags::Contains, 1);
+    FSequencerImportSession::CommitTrackToSessions(WithInvalid, Track, 1, bSuccess, Report);
+    TestFalse(TEXT("CommitTrackToSessions with an invalid session"), bSuccess);
+    TestEqual(TEXT("Keys of the valid target"), WithInvalid[0].GetChannel(0)->GetNumKeys(), 0);
+
+    for (ULevelSequence* Sequence : Sequences)
+    {
+        Sequence->MarkAsGarbage();
+    }
+    for (ULevelSequence* Sequence : CubicSequences)
+    {
+        Sequence->MarkAsGarbage();
+    }
+    Untouched->MarkAsGarbage();
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSequencerImportSessionRangedTangentsTest, "AnimationStreaming.Sequencer.RangedTangents", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSequencerImportSessionRangedTangentsTest::RunTest(const FString& Parameters)
+{
+    //Mixed interpolation and tangent modes, user tangents must survive both passes.
+    TArray<FFrameNumber> Times;
+    TArray<FMovieSceneDoubleValue> Values;
+    for (int32 Index = 0; Index < 40; ++Index)
+    {
+        Times.Add(FFrameNumber(Index * 800 + (Index % 3) * 100));
+        FMovieSceneDoubleValue& Key{ Values.Emplace_GetRef(100.0 * FMath::Sin(Index * 0.4) + (Index % 7 == 0 ? 30.0 : 0.0)) };
+        switch (Index % 6)
+        {
+        case 0: Key.InterpMode = RCIM_Cubic; Key.TangentMode = RCTM_Auto; break;
+        case 1: Key.InterpMode = RCIM_Cubic; Key.TangentMode = RCTM_SmartAuto; break;
+        case 2: Key.InterpMode = RCIM_Linear; break;
+        case 3: Key.InterpMode = RCIM_Cubic; Key.TangentMode = RCTM_Auto; break;
+        case 4: Key.InterpMode = RCIM_Constant; break;
+        default:
+            Key.InterpMode = RCIM_Cubic;
+            Key.TangentMode = RCTM_User;
+            Key.Tangent.ArriveTangent = 0.01f;
+            Key.Tangent.LeaveTangent = -0.02f;
+            break;
+        }
+    }
+
+    FMovieSceneDoubleChannel Reference;
+    Reference.Set(Times, Values);
+    Reference.AutoSetTangents();
+    FMovieSceneDoubleChannel Ranged;
+    Ranged.Set(Times, Values);
+
+    auto TestSameKeys = [this](const TCHAR* What, const FMovieSceneDoubleChannel& Actual, const FMovieSceneDoubleChannel& Expected)
+    {
+        const TArrayView<const FMovieSceneDoubleValue> ActualValues{ Actual.GetValues() };
+        const TArrayView<const FMovieSceneDoubleValue> ExpectedValues{ Expected.GetValues() };
+        for (int32 Index = 0; Index < ExpectedValues.Num(); ++Index)
+        {
+            const FMovieSceneTangentData& ActualTangent{ ActualValues[Index].Tangent };
+            const FMovieSceneTangentData& ExpectedTangent{ ExpectedValues[Index].Tangent };
+            if (ActualValues[Index].Value != ExpectedValues[Index].Value
+                || ActualTangent.ArriveTangent != ExpectedTangent.ArriveTangent || ActualTangent.LeaveTangent != ExpectedTangent.LeaveTangent
+                || ActualTangent.ArriveTangentWeight != ExpectedTangent.ArriveTangentWeight || ActualTangent.LeaveTangentWeight != ExpectedTangent.LeaveTangentWeight
+                || ActualTangent.TangentWeightMode != ExpectedTangent.TangentWeightMode)
+            {
+                AddError(FString::Printf(TEXT("%s key %d differs from the engine pass"), What, Index));
+                return;
+            }
+        }
+    };
+
+    //Over every key the ranged pass is the engine pass.
+    FSequencerImportSession::AutoSetTangents(Ranged, Times[0], Times.Last());
+    TestSameKeys(TEXT("Full range"), Ranged, Reference);
+
+    //One edited key, only it and its neighbours are recomputed and the result still matches a full pass.
+    for (const int32 Edited : { 0, 13, 20, 39 })
+    {
+        for (FMovieSceneDoubleChannel* Channel : { &Reference, &Ranged })
+        {
+            Channel->GetData().GetValues()[Edited].Value += 25.0;
+        }
+        Reference.AutoSetTangents();
+        FSequencerImportSession::AutoSetTangents(Ranged, Times[Edited], Times[Edited]);
+        TestSameKeys(*FString::Printf(TEXT("Edited key %d"), Edited), Ranged, Reference);
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKeyframeReductionTest, "AnimationStreaming.Sequencer.Reduction", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKeyframeReductionTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimationStreamingTests;
+
+    FKeyframeReductionSettings Settings;
+    Settings.TranslationTolerance = 0.05f;
+    Settings.RotationTolerance = 0.05f;
+    Settings.ScaleTolerance = 0.001f;
+
+    const FKeyframeTrackSoA Track{ FSyntheticCapture::MakeTrack(NumFrames, 0, Seed) };
+    TArray<FGuid> Bindings;
+    ULevelSequence* Sequence{ FSyntheticCapture::MakeTransientSequence(2, Bindings) };
+
+    //Linear and cubic sections, evaluated as Sequencer will, stay within the tolerance at every dropped frame.
+    const TPair<const TCHAR*, int> Cases[]{ { TEXT("Linear"), 1 }, { TEXT("Cubic"), 0 } };
+    for (int32 CaseIndex = 0; CaseIndex < static_cast<int32>(UE_ARRAY_COUNT(Cases)); ++CaseIndex)
+    {
+        const TCHAR* What{ Cases[CaseIndex].Key };
+        bool bSuccess{ false };
+        FSequencerImportSession Session{ Sequence, Bindings[CaseIndex], 0, bSuccess };
+        if (!TestTrue(FString::Printf(TEXT("%s session is valid"), What), Session.IsValid()))
+        {
+            continue;
+        }
+
+        FTransformChannelKeys Full;
+        FSequencerImportSession::BuildChannelKeys(Track, Session.GetTimeMapping(), Cases[CaseIndex].Value, Full);
+        FTransformChannelKeys Reduced{ Full };
+        FKeyframeReducer::ReduceChannelKeys(Reduced, Settings);
+        Session.CommitChannelKeys(Reduced, bSuccess);
+        TestTrue(FString::Printf(TEXT("%s commit"), What), bSuccess);
+
+        int32 NumReducedKeys{ 0 };
+        for (int ChannelIndex = 0; ChannelIndex < FSequencerImportSession::NumTransformChannels; ++ChannelIndex)
+        {
+            const double Tolerance{ ChannelIndex < 3 ? Settings.TranslationTolerance : ChannelIndex < 6 ? Settings.RotationTolerance : Settings.ScaleTolerance };
+            const FMovieSceneDoubleChannel* Channel{ Session.GetChannel(ChannelIndex) };
+            NumReducedKeys += Channel->GetNumKeys();
+
+            for (int32 Index = 0; Index < Full.Times.Num(); ++Index)
+            {
+                double Value{ 0.0 };
+                Channel->Evaluate(FFrameTime(Full.Times[Index]), Value);
+                const double Expected{ Full.Values[ChannelIndex][Index].Value };
+                if (FMath::Abs(Value - Expected) > Tolerance + 1.e-6)
+                {
+                    AddError(FString::Printf(TEXT("%s channel %d at frame %d is %f, expected %f within %f"), What, ChannelIndex, Track.Frames[Index], Value, Expected, Tolerance));
+                    break;
+                }
+            }
+        }
+        TestTrue(FString::Printf(TEXT("%s drops keys (%d of %d kept)"), What, NumReducedKeys, FSequencerImportSession::NumTransformChannels * Track.Num()), NumReducedKeys < FSequencerImportSession::NumTransformChannels * Track.Num());
+    }
+
+    Sequence->MarkAsGarbage();
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKeyframeDeltaImportTest, "AnimationStreaming.Sequencer.DeltaImport", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKeyframeDeltaImportTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimationStreamingTests;
+
+    //32 frame blocks, the 300 frame take spans 10 of them.
+    constexpr int32 BlockFrames{ 32 };
+    constexpr int KeyInterpolation{ 0 };
+
+    TArray<FGuid> Bindings;
+    ULevelSequence* Sequence{ FSyntheticCapture::MakeTransientSequence(2, Bindings) };
+    bool bSuccess{ false };
+    FSequencerImportSession DeltaSession{ Sequence, Bindings[0], 0, bSuccess };
+    FSequencerImportSession FullSession{ Sequence, Bindings[1], 0, bSuccess };
+    if (!TestTrue(TEXT("Sessions are valid"), DeltaSession.IsValid() && FullSession.IsValid()))
+    {
+        Sequence->MarkAsGarbage();
+        return false;
+    }
+
+    auto Reimport = [this, &DeltaSession, &bSuccess](const TCHAR* What, const FKeyframeTrackSoA& Track)
+    {
+        FTransformChannelKeys Keys;
+        FSequencerImportSession::BuildChannelKeys(Track, DeltaSession.GetTimeMapping(), KeyInterpolation, Keys);
+        FKeyframeImportReport Report;
+        FKeyframeDeltaImporter::Reimport(DeltaSession, Keys, bSuccess, Report, BlockFrames);
+        TestTrue(What, bSuccess);
+
+        return Report;
+    };
+
+    //The first import writes every block.
+    FKeyframeTrackSoA Track{ FSyntheticCapture::MakeTrack(NumFrames, 0, Seed) };
+    TestEqual(TEXT("First import changed blocks"), Reimport(TEXT("First import"), Track).ChangedBlocks, 10);
+    TestEqual(TEXT("Unchanged import changed blocks"), Reimport(TEXT("Unchanged import"), Track).ChangedBlocks, 0);
+
+    //Values edited inside one block, the key times stay and only that block is spliced.
+    for (int32 Index = 100; Index < 110; ++Index)
+    {
+        Track.TranslationX[Index] += 5.0f;
+        Track.ScaleZ[Index] += 0.5f;
+    }
+    const FKeyframeImportReport EditedReport{ Reimport(TEXT("Edited import"), Track) };
+    TestEqual(TEXT("Edited import changed blocks"), EditedReport.ChangedBlocks, 1);
+    TestTrue(TEXT("Edited import writes fewer keys than a full import"), EditedReport.KeysWritten < FSequencerImportSession::NumTransformChannels * Track.Num());
+    FullSession.AddTransformKeyframes(Track, KeyInterpolation, bSuccess);
+    TestSameChannels(*this, TEXT("Edited splice"), DeltaSession, FullSession, 1.e-6);
+
+    //Frames dropped inside one block move the key times, the channel is rebuilt around that block.
+    FKeyframeTrackSoA Shortened;
+    for (int32 Index = 0; Index < Track.Num(); ++Index)
+    {
+        if (Index >= 200 && Index < 205)
+        {
+            continue;
+        }
+
+        const float Translation[3]{ Track.TranslationX[Index], Track.TranslationY[Index], Track.TranslationZ[Index] };
+        const float Rotation[3]{ Track.Roll[Index], Track.Pitch[Index], Track.Yaw[Index] };
+        const float Scale[3]{ Track.ScaleX[Index], Track.ScaleY[Index], Track.ScaleZ[Index] };
+        Shortened.Add(Track.Frames[Index], Translation, Rotation, Scale);
+    }
+    TestEqual(TEXT("Shortened import changed blocks"), Reimport(TEXT("Shortened import"), Shortened).ChangedBlocks, 1);
+    FullSession.AddTransformKeyframes(Shortened, KeyInterpolation, bSuccess);
+    TestSameChannels(*this, TEXT("Shortened splice"), DeltaSession, FullSession, 1.e-6);
+
+    Sequence->MarkAsGarbage();
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChunkedKeyframeImportTest, "AnimationStreaming.Import.Chunked", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FChunkedKeyframeImportTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimationStreamingTests;
+
+    const FString SourcePath{ FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("AnimationStreaming"), TEXT("ChunkedTest.json")) };
+    TArray<uint8> Json;
+    FSyntheticCapture::WriteJson(NumFrames, NumControls, Seed, Json);
+    if (!TestTrue(TEXT("Save source"), FFileHelper::SaveArrayToFile(Json, *SourcePath)))
+    {
+        return false;
+    }
+
+    FString InfoMessage;
+    TMap<FString, FKeyframeTrackSoA> Controls;
+    TestTrue(TEXT("ParseAllControls"), FKeyframeJsonParser::ParseAllControls(Json, Controls, InfoMessage));
+
+    //The last control, so the chunks before it are skipped, read in the smallest chunks and flushed many times.
+    const FString ControlName{ FSyntheticCapture::GetControlName(NumControls - 1) };
+    FChunkedImportSettings Settings;
+    Settings.ChunkSizeBytes = 4 * 1024;
+    Settings.FlushFrameCount = 64;
+
+    TArray<FGuid> Bindings;
+    ULevelSequence* Sequence{ FSyntheticCapture::MakeTransientSequence(4, Bindings) };
+    const TPair<const TCHAR*, int> Cases[]{ { TEXT("Linear"), 1 }, { TEXT("Cubic"), 0 } };
+    for (int32 CaseIndex = 0; CaseIndex < static_cast<int32>(UE_ARRAY_COUNT(Cases)); ++CaseIndex)
+    {
+        const TCHAR* What{ Cases[CaseIndex].Key };
+        bool bSuccess{ false };
+        FSequencerImportSession ChunkedSession{ Sequence, Bindings[CaseIndex * 2], 0, bSuccess };
+        FSequencerImportSession OneShotSession{ Sequence, Bindings[CaseIndex * 2 + 1], 0, bSuccess };
+
+        FKeyframeImportReport Report;
+        FChunkedKeyframeImporter::Import(ChunkedSession, SourcePath, ControlName, Cases[CaseIndex].Value, Settings, bSuccess, InfoMessage, Report);
+        if (!TestTrue(FString::Printf(TEXT("%s chunked import: %s"), What, *InfoMessage), bSuccess))
+        {
+            continue;
+        }
+        TestEqual(FString::Printf(TEXT("%s chunked frames"), What), Report.Frames, NumFrames);
+
+        OneShotSession.AddTransformKeyframes(Controls.FindChecked(ControlName), Cases[CaseIndex].Value, bSuccess);
+        //Batches are unwound on their own, as in the Rotation test the turns they continue from may differ by rounding.
+        TestSameChannels(*this, FString::Printf(TEXT("%s chunked"), What), ChunkedSession, OneShotSession, 1.e-2);
+    }
+
+    //A control missing from the file fails instead of importing nothing.
+    {
+        bool bSuccess{ true };
+        FSequencerImportSession Session{ Sequence, Bindings[0], 0, bSuccess };
+        FKeyframeImportReport Report;
+        FChunkedKeyframeImporter::Import(Session, SourcePath, TEXT("missing_ctrl"), 1, Settings, bSuccess, InfoMessage, Report);
+        TestFalse(TEXT("Chunked import of a missing control"), bSuccess);
+    }
+
+    Sequence->MarkAsGarbage();
+    IFileManager::Get().Delete(*SourcePath, false, true, true);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKeyframeFrameIndexTest, "AnimationStreaming.Sequencer.FrameIndex", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKeyframeFrameIndexTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimationStreamingTests;
+
+    //Shuffled frames over more than one radix digit, with duplicates and gaps.
+    FRandomStream Random{ Seed };
+    TArray<int32> Frames;
+    for (int32 Index = 0; Index < 5000; ++Index)
+    {
+        Frames.Add(Random.RandRange(-100, 6000));
+    }
+
+    const FKeyframeFrameIndex FrameIndex{ Frames };
+
+    //The expected result: every distinct frame once, at the index of its last occurrence.
+    TMap<int32, int32> LastOccurrence;
+    for (int32 Index = 0; Index < Frames.Num(); ++Index)
+    {
+        LastOccurrence.Add(Frames[Index], Index);
+    }
+    LastOccurrence.KeySort(TLess<int32>());
+
+    TestEqual(TEXT("Unique frames"), FrameIndex.Num(), LastOccurrence.Num());
+    TestEqual(TEXT("Duplicates"), FrameIndex.NumDuplicates, Frames.Num() - LastOccurrence.Num());
+    int32 Position{ 0 };
+    for (const TPair<int32, int32>& Frame : LastOccurrence)
+    {
+        if (!FrameIndex.Order.IsValidIndex(Position) || FrameIndex.Order[Position] != Frame.Value)
+        {
+            AddError(FString::Printf(TEXT("Frame %d is not indexed at its last occurrence %d"), Frame.Key, Frame.Value));
+            break;
+        }
+        ++Position;
+    }
+
+    const int32 FirstFrame{ LastOccurrence.CreateConstIterator().Key() };
+    int32 LastFrame{ FirstFrame };
+    for (const TPair<int32, int32>& Frame : LastOccurrence)
+    {
+        LastFrame = Frame.Key;
+    }
+    TestEqual(TEXT("First frame"), FrameIndex.FirstFrame, FirstFrame);
+    TestEqual(TEXT("Last frame"), FrameIndex.LastFrame, LastFrame);
+    TestEqual(TEXT("Missing frames"), FrameIndex.GetNumMissingFrames(), LastFrame - FirstFrame + 1 - LastOccurrence.Num());
+
+    //Sorted input takes the same path without the sort.
+    const FKeyframeTrackSoA Track{ FSyntheticCapture::MakeTrack(NumFrames, 0, Seed) };
+    const FKeyframeFrameIndex SortedIndex{ Track.Frames };
+    TestEqual(TEXT("Sorted unique frames"), SortedIndex.Num(), Track.Num());
+    TestTrue(TEXT("Sorted has no gaps"), SortedIndex.Gaps.Num() == 0 && SortedIndex.NumDuplicates == 0);
+
+    //29.97 frames map to ticks from the exact rate, 1001 seconds of capture land on the exact tick.
+    const FKeyframeTimeMapping NtscMapping{ FFrameRate(30000, 1001), FFrameRate(24000, 1) };
+    TestEqual(TEXT("29.97 to 24000 ticks"), NtscMapping.ToTick(30000).Value, 24000 * 1001);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKeyframePlaybackTrackTest, "AnimationStreaming.Playback.Evaluate", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKeyframePlaybackTrackTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimationStreamingTests;
+
+    const FKeyframeTrackSoA Track{ FSyntheticCapture::MakeTrack(NumFrames, 0, Seed) };
+    FKeyframePlaybackTrack Playback;
+    Playback.Build(Track);
+    if (!TestEqual(TEXT("Playback key count"), Playback.Num(), Track.Num()))
+    {
+        return false;
+    }
+
+    auto TestTransform = [this](const FString& What, const FTransform& Actual, const FTransform& Expected)
+    {
+        if (!Actual.GetTranslation().Equals(Expected.GetTranslation(), 1.e-3) || !Actual.GetRotation().Equals(Expected.GetRotation(), 1.e-4)
+            || !Actual.GetScale3D().Equals(Expected.GetScale3D(), 1.e-4))
+        {
+            AddError(FString::Printf(TEXT("%s is %s, expected %s"), *What, *Actual.ToString(), *Expected.ToString()));
+            return false;
+        }
+
+        return true;
+    };
+
+    //On a key every interpolation returns the key, forwards through the hint and backwards against it.
+    int32 Hint{ 0 };
+    for (int32 Index = 0; Index < Track.Num(); ++Index)
+    {
+        if (!TestTransform(FString::Printf(TEXT("Forward frame %d"), Track.Frames[Index]), Playback.Evaluate(Track.Frames[Index], 1, Hint), Track.GetTransform(Index)))
+        {
+            break;
+        }
+    }
+    for (int32 Index = Track.Num() - 1; Index >= 0; --Index)
+    {
+        if (!TestTransform(FString::Printf(TEXT("Backward frame %d"), Track.Frames[Index]), Playback.Evaluate(Track.Frames[Index], 0, Hint), Track.GetTransform(Index)))
+        {
+            break;
+        }
+    }
+
+    //Between keys linear is the midpoint and constant holds the earlier key, outside the track the end keys hold.
+    const int32 Middle{ Track.Num() / 2 };
+    const FTransform Linear{ Playback.Evaluate(Track.Frames[Middle] + 0.5, 1, Hint) };
+    const FVector ExpectedTranslation{ (Track.GetTransform(Middle).GetTranslation() + Track.GetTransform(Middle + 1).GetTranslation()) * 0.5 };
+    TestTrue(TEXT("Linear midpoint"), Linear.GetTranslation().Equals(ExpectedTranslation, 1.e-3));
+    TestTransform(TEXT("Constant between keys"), Playback.Evaluate(Track.Frames[Middle] + 0.5, 2, Hint), Track.GetTransform(Middle));
+    TestTransform(TEXT("Before the track"), Playback.Evaluate(Track.Frames[0] - 10.0, 1, Hint), Track.GetTransform(0));
+    TestTransform(TEXT("After the track"), Playback.Evaluate(Track.Frames.Last() + 10.0, 1, Hint), Track.GetTransform(Track.Num() - 1));
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Struct/Keyframes.h"
+
+#include "AnimSequenceBaker.generated.h"
+
+class UAnimSequence;
+class USkeleton;
+
+
+USTRUCT(BlueprintType, Category = KeyFrames)
+struct ANIMATIONSTREAMING_API FAnimBakeSettings
+{
+	GENERATED_BODY()
+
+public:
+    //Capture control to bone. Controls without an entry are baked into the bone of the same name.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TMap<FString, FName> ControlToBone;
+
+    //Controls with no bone in the skeleton are skipped with a warning instead of failing the bake.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bSkipUnmatchedControls{ true };
+};
+
+//Dense per-frame keys of one bone, the layout the animation data controller takes in one call.
+struct ANIMATIONSTREAMING_API FBoneTrackKeys
+{
+    FName BoneName;
+    TArray<FVector3f> Positions;
+    TArray<FQuat4f> Rotations;
+    TArray<FVector3f> Scales;
+};
+
+
+/**
+ * Bakes parsed per-bone capture tracks into a UAnimSequence through its animation data controller,
+ * one bulk key write per bone. Capture transforms are taken as bone space (relative to the parent bone).
+ * The result is bound with USequencerManager::AddSkeletalAnimationToActor instead of one transform track per control.
+ */
+class ANIMATIONSTREAMING_API FAnimSequenceBaker
+{
+public:
+    //Thread safe. Fills NumFrames samples from FirstFrame, frames missing from the capture are interpolated.
+    static void BuildBoneKeys(const TArray<FKeyframes>& Keyframes, const int32 FirstFrame, const int32 NumFrames, FBoneTrackKeys& OutKeys);
+
+    //Game thread only, editor builds only. Creates the asset at AssetPath ("/Game/Path/Name") or replaces the bone tracks of an existing one.
+    static UAnimSequence* Bake(const TMap<FString, FKeyframeTrack>& Controls, USkeleton* Skeleton, const FString& AssetPath, const FFrameRate& FrameRate, const FAnimBakeSettings& Settings, bool& bOutSuccess, FString& OutInfoMessage);
+};
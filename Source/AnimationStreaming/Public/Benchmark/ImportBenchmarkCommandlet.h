@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "ImportBenchmarkCommandlet.generated.h"
+
+//One measurement, results are written in long format so every suite can add its own metrics.
+struct FImportBenchmarkResult
+{
+    FString Suite;
+    FString Case;
+    int32 Frames{ 0 };
+    int32 Controls{ 0 };
+    FString Metric;
+    double Value{ 0.0 };
+    FString Unit;
+};
+
+
+/**
+ * Headless import benchmarks on synthetic captures, writes results.csv and results.json.
+ *
+ * UnrealEditor-Cmd AnimationStreaming.uproject -run=ImportBenchmark -nullrhi -unattended
+ *     [-frames=1000,100000,1000000] [-controls=1,50,300] [-suites=parse,bake,kernels,compression]
+ *     [-maxtotalframes=5000000] [-perkeylimit=100000] [-output=<dir>] [-keepcaptures]
+ *
+ * Add -llm for the memory the parse paths hold, and -trace=default,memory for their
+ * allocation counts per trace region in Unreal Insights.
+ */
+UCLASS()
+class ANIMATIONSTREAMING_API UImportBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UImportBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+private:
+    void RunParseSuite(const FString& CapturePath, TArrayView<const uint8> Json, const int32 Frames, const int32 Controls);
+    void RunBakeSuite(const FString& CapturePath, const int32 Frames, const int32 Controls);
+    void RunKernelSuite(const int32 Frames);
+    void RunCompressionSuite(const int32 Frames, const int32 Controls);
+
+    void AddResult(const FString& Suite, const FString& Case, const int32 Frames, const int32 Controls, const FString& Metric, const double Value, const FString& Unit);
+    //Warns about a case above -maxtotalframes and records it as a "skipped" result.
+    void SkipCase(const FString& Suite, const int32 Frames, const int32 Controls, const int64 MaxTotalFrames);
+    bool WriteResults(const FString& OutputDirectory) const;
+
+    TArray<FImportBenchmarkResult> Results;
+    int64 PerKeyLimit{ 100000 };
+};
@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Struct/KeyframeTrackSoA.h"
+
+class ULevelSequence;
+
+
+/**
+ * Deterministic synthetic captures for benchmarks and tests: smooth per-control curves with a little noise,
+ * written in the same json layout as the recorded captures.
+ */
+class ANIMATIONSTREAMING_API FSyntheticCapture
+{
+public:
+    static FString GetControlName(const int32 ControlIndex);
+    static FKeyframeTrackSoA MakeTrack(const int32 NumFrames, const int32 ControlIndex, const int32 Seed);
+    static void WriteJson(const int32 NumFrames, const int32 NumControls, const int32 Seed, TArray<uint8>& OutJson);
+    //Transient sequence at 30 fps with one possessable, transform track and an unbounded section per binding.
+    static ULevelSequence* MakeTransientSequence(const int32 NumBindings, TArray<FGuid>& OutBindings);
+};
@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/Float16.h"
+#include "Format/KeyframeSource.h"
+#include "Streaming/KeyframeStreamTypes.h"
+
+
+/**
+ * Compact little-endian capture file ("<file>.kfb"):
+ * FKeyframeBinaryHeader, then per control an FKeyframeBinaryControlHeader, the UTF-8 name padded
+ * to 4 bytes and NumRecords fixed-size records in frame order. Records are FKeyframePacketRecord,
+ * the stream wire record, or FKeyframeHalfRecord when the header has the Float16 flag.
+ * Float16 keeps about three significant digits, translations above 65504 do not fit.
+ */
+struct FKeyframeBinaryHeader
+{
+    static constexpr uint32 ExpectedMagic{ 0x42464B41 }; // "AKFB"
+    static constexpr uint16 CurrentVersion{ 1 };
+    static constexpr uint16 Float16Flag{ 1 << 0 };
+
+    uint32 Magic{ ExpectedMagic };
+    uint16 Version{ CurrentVersion };
+    uint16 Flags{ 0 };
+    uint32 NumControls{ 0 };
+    uint32 Reserved{ 0 };
+};
+static_assert(sizeof(FKeyframeBinaryHeader) == 16, "FKeyframeBinaryHeader is a file format and must stay packed");
+
+struct FKeyframeBinaryControlHeader
+{
+    uint32 NameLength{ 0 };
+    uint32 NumRecords{ 0 };
+};
+static_assert(sizeof(FKeyframeBinaryControlHeader) == 8, "FKeyframeBinaryControlHeader is a file format and must stay packed");
+
+//Channels in section order.
+struct FKeyframeHalfRecord
+{
+    int32 Frame{ 0 };
+    FFloat16 Channels[9];
+    uint16 Padding{ 0 };
+};
+static_assert(sizeof(FKeyframeHalfRecord) == 24, "FKeyframeHalfRecord is a file format and must stay packed");
+
+
+class ANIMATIONSTREAMING_API FKeyframeBinarySource : public IKeyframeSource
+{
+public:
+    virtual FName GetFormatName() const override;
+    virtual bool MatchesHeader(TArrayView<const uint8> Head) const override;
+    virtual bool MatchesExtension(const FString& Extension) const override;
+
+    virtual bool LoadControl(TArrayView<const uint8> Bytes, const FString& ControlName, FKeyframeTrackSoA& OutTrack, FString& OutInfoMessage) const override;
+    virtual bool LoadAllControls(TArrayView<const uint8> Bytes, TMap<FString, FKeyframeTrackSoA>& OutControls, FString& OutInfoMessage) const override;
+
+    //Writes Controls sorted by frame, bFloat16 quantizes every channel.
+    static void Write(const TMap<FString, FKeyframeTrackSoA>& Controls, const bool bFloat16, TArray<uint8>& OutBytes);
+
+private:
+    struct FControlRange
+    {
+        FString Name;
+        int64 RecordsOffset{ 0 };
+        int32 NumRecords{ 0 };
+    };
+
+    //Validates the header and walks the control table.
+    static bool ReadControlTable(TArrayView<const uint8> Bytes, bool& bOutFloat16, TArray<FControlRange>& OutControls, FString& OutInfoMessage);
+    static void DecodeRecords(TArrayView<const uint8> Bytes, const FControlRange& Control, const bool bFloat16, FKeyframeTrackSoA& OutTrack);
+};
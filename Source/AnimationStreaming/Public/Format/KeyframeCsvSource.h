@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Format/KeyframeSource.h"
+#include "Json/KeyframeJsonParser.h"
+
+
+/**
+ * One keyframe per row after a header line naming the columns:
+ * control,frame,tx,ty,tz,roll,pitch,yaw,sx,sy,sz
+ * Only frame is required, missing channels default to the identity. Without a control column
+ * every row belongs to whichever control is asked for, LoadAllControls names it global_ctrl.
+ */
+class ANIMATIONSTREAMING_API FKeyframeCsvSource : public IKeyframeSource
+{
+public:
+    virtual FName GetFormatName() const override;
+    virtual bool MatchesHeader(TArrayView<const uint8> Head) const override;
+    virtual bool MatchesExtension(const FString& Extension) const override;
+
+    virtual bool LoadControl(TArrayView<const uint8> Bytes, const FString& ControlName, FKeyframeTrackSoA& OutTrack, FString& OutInfoMessage) const override;
+    virtual bool LoadAllControls(TArrayView<const uint8> Bytes, TMap<FString, FKeyframeTrackSoA>& OutControls, FString& OutInfoMessage) const override;
+
+private:
+    //Visits every row in file order. Control is empty when the file has no control column.
+    static bool ParseRows(TArrayView<const uint8> Bytes, TFunctionRef<void(const FAnsiStringView Control, const FKeyframeJsonParser::FParsedFrame& Frame)> Visitor, FString& OutInfoMessage);
+};
@@ -0,0 +1,19 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Format/KeyframeSource.h"
+
+
+//The recorded capture layout, read with FKeyframeJsonParser.
+class ANIMATIONSTREAMING_API FKeyframeJsonSource : public IKeyframeSource
+{
+public:
+    virtual FName GetFormatName() const override;
+    virtual bool MatchesHeader(TArrayView<const uint8> Head) const override;
+    virtual bool MatchesExtension(const FString& Extension) const override;
+
+    virtual bool LoadControl(TArrayView<const uint8> Bytes, const FString& ControlName, FKeyframeTrackSoA& OutTrack, FString& OutInfoMessage) const override;
+    virtual bool LoadAllControls(TArrayView<const uint8> Bytes, TMap<FString, FKeyframeTrackSoA>& OutControls, FString& OutInfoMessage) const override;
+};
@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Struct/Keyframes.h"
+#include "Struct/KeyframeTrackSoA.h"
+
+
+/**
+ * One capture file format. Sources are stateless and called from any thread,
+ * the bytes are the whole file already in memory.
+ */
+class ANIMATIONSTREAMING_API IKeyframeSource
+{
+public:
+    virtual ~IKeyframeSource() = default;
+
+    virtual FName GetFormatName() const = 0;
+    //Header magic or signature, Head holds at most the first kilobyte of the file.
+    virtual bool MatchesHeader(TArrayView<const uint8> Head) const = 0;
+    //Lower case extension without the dot.
+    virtual bool MatchesExtension(const FString& Extension) const = 0;
+
+    //Rotation stays in the Euler degrees of the file, unnormalized, so the cache holds the source values.
+    virtual bool LoadControl(TArrayView<const uint8> Bytes, const FString& ControlName, FKeyframeTrackSoA& OutTrack, FString& OutInfoMessage) const = 0;
+    virtual bool LoadAllControls(TArrayView<const uint8> Bytes, TMap<FString, FKeyframeTrackSoA>& OutControls, FString& OutInfoMessage) const = 0;
+};
+
+
+/**
+ * Picks the source of a capture by header magic first, then by file extension.
+ * Json, csv and the binary frame format are built in, later registrations take precedence.
+ */
+class ANIMATIONSTREAMING_API FKeyframeSourceRegistry
+{
+public:
+    static FKeyframeSourceRegistry& Get();
+
+    //Game thread, before the imports that should see the source start.
+    void Register(const TSharedRef<IKeyframeSource>& Source);
+    void Unregister(const FName FormatName);
+
+    const IKeyframeSource* FindSource(const FString& FilePath, TArrayView<const uint8> Bytes) const;
+    const IKeyframeSource* FindSourceByName(const FName FormatName) const;
+
+    //FindSource and load in one call, fails with a message when no source matches.
+    bool LoadControl(const FString& FilePath, TArrayView<const uint8> Bytes, const FString& ControlName, FKeyframeTrackSoA& OutTrack, FString& OutInfoMessage) const;
+    bool LoadAllControls(const FString& FilePath, TArrayView<const uint8> Bytes, TMap<FString, FKeyframeTrackSoA>& OutControls, FString& OutInfoMessage) const;
+
+private:
+    FKeyframeSourceRegistry();
+
+    TArray<TSharedRef<IKeyframeSource>> Sources;
+};
@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+
+/**
+ * Read-only capture file for the parsers. The file is memory-mapped so the bytes are paged
+ * in by the OS as the parser walks them, platforms without mapping fall back to a heap copy.
+ * The view stays valid until the file is closed or destroyed.
+ */
+class ANIMATIONSTREAMING_API FKeyframeSourceFile
+{
+public:
+    FKeyframeSourceFile();
+    ~FKeyframeSourceFile();
+
+    bool Open(const FString& FilePath);
+    void Close();
+    bool IsMapped() const { return Region.IsValid(); }
+
+    TArrayView<const uint8> GetBytes() const { return Bytes; }
+
+private:
+    TUniquePtr<IMappedFileHandle> MappedFile;
+    TUniquePtr<IMappedFileRegion> Region;
+    TArray<uint8> Fallback;
+    TArrayView<const uint8> Bytes;
+};
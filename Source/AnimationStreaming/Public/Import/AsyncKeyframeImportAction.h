@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "Sequencer/SequencerImportSession.h"
+#include "Import/KeyframeImportReport.h"
+
+#include "AsyncKeyframeImportAction.generated.h"
+
+struct FAsyncKeyframeImportState;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FKeyframeImportProgressDelegate, float, Progress);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FKeyframeImportCompletedDelegate, bool, bSuccess, const FString&, InfoMessage, const FKeyframeImportReport&, Report);
+
+
+/**
+ * Imports one control of a json capture into a transform section without blocking the game thread.
+ * Chunked reads, parsing and channel building run on a worker task with the next read already in flight,
+ * only the final channel commit runs on the game thread.
+ */
+UCLASS()
+class ANIMATIONSTREAMING_API UAsyncKeyframeImportAction : public UBlueprintAsyncActionBase
+{
+    GENERATED_BODY()
+
+public:
+    UFUNCTION(BlueprintCallable, Category = Sequencer, meta = (BlueprintInternalUseOnly = "true"))
+    static UAsyncKeyframeImportAction* ImportJsonToSequencerAsync(AActor* Actor, const FString& FilePath, const FString& ControlName, const FString& SequencerPath, const int SectionIndex, int KeyInterpolation);
+
+    //Stops after the chunk in progress, nothing is written to the section.
+    UFUNCTION(BlueprintCallable, Category = Sequencer)
+    void Cancel();
+
+    //0..1, fired on the game thread.
+    UPROPERTY(BlueprintAssignable)
+    FKeyframeImportProgressDelegate OnProgress;
+
+    UPROPERTY(BlueprintAssignable)
+    FKeyframeImportCompletedDelegate OnCompleted;
+
+    virtual void Activate() override;
+
+private:
+    void CommitOnGameThread();
+    void Complete(const bool bSuccess, const FString& InfoMessage);
+
+    TWeakObjectPtr<AActor> Actor;
+    FString FilePath;
+    FString ControlName;
+    FString SequencerPath;
+    int SectionIndex{ 0 };
+    int KeyInterpolation{ 0 };
+
+    FSequencerImportSession Session;
+    TSharedPtr<FAsyncKeyframeImportState, ESPMode::ThreadSafe> State;
+    double StartSeconds{ 0.0 };
+    bool bCompleted{ false };
+};
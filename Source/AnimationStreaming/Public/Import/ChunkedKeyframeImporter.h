@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Import/KeyframeImportReport.h"
+
+#include "ChunkedKeyframeImporter.generated.h"
+
+class FSequencerImportSession;
+
+
+USTRUCT(BlueprintType, Category = KeyFrames)
+struct ANIMATIONSTREAMING_API FChunkedImportSettings
+{
+	GENERATED_BODY()
+
+public:
+    //Bytes read from the file per request, the read buffer is allocated once.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 ChunkSizeBytes{ 1024 * 1024 };
+
+    //Parsed frames kept in memory before they are written to the section.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 FlushFrameCount{ 4096 };
+};
+
+/**
+ * Bounded-memory import of one control: the file is read in fixed-size chunks and every
+ * FlushFrameCount parsed frames are keyed into the section before more is read.
+ * Peak memory is one chunk plus one batch of frames, independent of the take length.
+ */
+class ANIMATIONSTREAMING_API FChunkedKeyframeImporter
+{
+public:
+    //Game thread only. Batches flushed before a parse error stay in the section.
+    static void Import(FSequencerImportSession& Session, const FString& FilePath, const FString& ControlName, int KeyInterpolation, const FChunkedImportSettings& Settings, bool& bOutSuccess, FString& OutInfoMessage, FKeyframeImportReport& OutReport);
+};
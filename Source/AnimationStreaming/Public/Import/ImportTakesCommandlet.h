@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "ImportTakesCommandlet.generated.h"
+
+class ULevelSequence;
+class UPackage;
+
+//One capture control keyed into one binding of a level sequence asset.
+struct FTakeImportJob
+{
+    FString FilePath;
+    FString SequencePath;
+    //Possessable or spawnable name, or a binding guid.
+    FString Binding;
+    FString ControlName{ TEXT("global_ctrl") };
+    int32 SectionIndex{ 0 };
+    int32 KeyInterpolation{ 0 };
+};
+
+
+/**
+ * Headless batch import of json captures into level sequence assets.
+ *
+ * UnrealEditor-Cmd AnimationStreaming.uproject -run=ImportTakes -nullrhi -unattended
+ *     -manifest=<takes.json> | -file=<capture.json> -sequence=</Game/Path.Asset> -binding=<name|guid> [-control=global_ctrl] [-section=0] [-interpolation=0]
+ *     [-batchsize=16] [-createsections] [-nosave]
+ *
+ * Manifest: { "jobs": [ { "file", "sequence", "binding", "control", "section", "interpolation" } ] }, relative files resolve against the manifest.
+ * Each batch parses its files in parallel, builds keys in parallel, commits on the game thread and saves the touched packages.
+ */
+UCLASS()
+class ANIMATIONSTREAMING_API UImportTakesCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UImportTakesCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+private:
+    static bool ReadJobs(const FString& Params, TArray<FTakeImportJob>& OutJobs);
+    //Returns the number of failed jobs.
+    static int32 ImportBatch(TArrayView<const FTakeImportJob> Batch, const bool bCreateSections, const bool bSave);
+    static int32 SavePackages(const TSet<UPackage*>& Packages);
+
+    static FGuid FindBinding(ULevelSequence* Sequence, const FString& Binding);
+    static void EnsureTransformSection(ULevelSequence* Sequence, const FGuid& Binding);
+};
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "KeyframeImportReport.generated.h"
+
+
+/**
+ * Summary of one import. Phase times are wall-clock seconds on the thread that ran the phase,
+ * Tokenize includes narrowing into float channels, Convert is the channel key build.
+ */
+USTRUCT(BlueprintType, Category = KeyFrames)
+struct ANIMATIONSTREAMING_API FKeyframeImportReport
+{
+	GENERATED_BODY()
+
+public:
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    int64 BytesRead{ 0 };
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    int32 Frames{ 0 };
+
+    //Keys across all nine channels.
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    int32 KeysWritten{ 0 };
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    bool bFromCache{ false };
+
+    //Frame blocks rewritten by a delta re-import.
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    int32 ChangedBlocks{ 0 };
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    double ReadSeconds{ 0.0 };
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    double TokenizeSeconds{ 0.0 };
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    double ConvertSeconds{ 0.0 };
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    double SequenceLookupSeconds{ 0.0 };
+
+    //Channel merges without the Modify() call.
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    double ChannelWriteSeconds{ 0.0 };
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    double ModifySeconds{ 0.0 };
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    double TotalSeconds{ 0.0 };
+
+    //Highest process physical memory seen at the phase boundaries.
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    int64 PeakUsedPhysicalBytes{ 0 };
+
+    void SampleMemory();
+    FString ToString() const;
+    //One line on LogAnimationStreaming.
+    void Log(const FString& Label) const;
+};
@@ -5,9 +5,12 @@
 #include "CoreMinimal.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "Struct/Keyframes.h"
+#include "Struct/KeyframeTrackSoA.h"
 
 #include "JsonManager.generated.h"
 
+class FKeyframeSourceFile;
+
 
 UCLASS()
 class ANIMATIONSTREAMING_API UJsonManager : public UBlueprintFunctionLibrary
@@ -24,14 +27,25 @@ public:
     UFUNCTION(BlueprintCallable, Category = Json)
     static TArray<FKeyframes> LoadJsonArrayToStruct(const FString& FilePath, bool& bOutSuccess, FString& OutInfoMessage);
 
+    //Parses one control straight into contiguous per-channel arrays.
+    //The format (json, csv, binary) is picked by FKeyframeSourceRegistry from the header or the extension.
+    UFUNCTION(BlueprintCallable, Category = Json)
+    static FKeyframeTrackSoA LoadJsonToTrack(const FString& FilePath, const FString& ControlName, bool& bOutSuccess, FString& OutInfoMessage);
+
+    //Parses every top-level rig control of the file in one read.
+    UFUNCTION(BlueprintCallable, Category = Json)
+    static TMap<FString, FKeyframeTrack> LoadAllControls(const FString& FilePath, bool& bOutSuccess, FString& OutInfoMessage);
+
+    //LoadAllControls without the quat round trip, the controls keep the Euler values of the source.
+    UFUNCTION(BlueprintCallable, Category = Json)
+    static TMap<FString, FKeyframeTrackSoA> LoadAllTracks(const FString& FilePath, bool& bOutSuccess, FString& OutInfoMessage);
+
     UFUNCTION()
     static void PrintKeyframeData(const TArray<FKeyframes>& Keyframes);
 
 private:
-    static float SafeConvertToFloat(const double ValueToConvert);
-    static int GetLastFrame(const TMap<FString, TSharedPtr<FJsonValue>>& JsonData);
-    static FRotator GetParsedRotation(const TSharedPtr<FJsonObject>& SubObject);
-    static FVector GetParsedLocation(const TSharedPtr<FJsonObject>& SubObject);
-    static FVector GetParsedScale(const TSharedPtr<FJsonObject>& SubObject);
-    static FKeyframes GetInitializedKeyFrameStruct(const FTransform& Coordinates, const int Frame);
+    //Maps the capture, the parsers read it in place.
+    static void OpenSourceFile(const FString& FilePath, bool& bOutSuccess, FString& OutInfoMessage, FKeyframeSourceFile& OutSourceFile);
+    //Frame order, duplicated frames collapse onto the last one in the file.
+    static void SortKeyframes(TArray<FKeyframes>& InOutKeyframes);
 };
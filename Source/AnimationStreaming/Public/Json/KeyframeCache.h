@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Struct/Keyframes.h"
+#include "Struct/KeyframeTrackSoA.h"
+#include "Containers/StaticArray.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+
+/**
+ * Versioned binary sidecar written next to a parsed json capture ("<file>.kfcache").
+ *
+ * Layout: FKeyframeCacheHeader, FKeyframeCacheControlEntry table, control names,
+ * then per control 16-byte aligned SoA arrays: int32 frames followed by nine float
+ * channels in section order (tx, ty, tz, roll, pitch, yaw, sx, sy, sz).
+ * Loads memory-map the sidecar and are validated against the source size, mtime and an XXH64 of the whole source.
+ */
+struct FKeyframeCacheHeader
+{
+    static constexpr uint32 ExpectedMagic{ 0x43464B41 }; // "AKFC"
+    static constexpr uint32 CurrentVersion{ 4 };
+    //Set when the sidecar holds every control of the source, LoadAll only accepts such sidecars.
+    static constexpr uint32 CompleteFlag{ 1 << 0 };
+
+    uint32 Magic{ ExpectedMagic };
+    uint32 Version{ CurrentVersion };
+    int64 SourceSize{ 0 };
+    int64 SourceTimestamp{ 0 };
+    uint64 SourceHash{ 0 };
+    uint32 NumControls{ 0 };
+    uint32 Flags{ 0 };
+};
+
+struct FKeyframeCacheControlEntry
+{
+    uint64 NameOffset{ 0 };
+    uint64 DataOffset{ 0 };
+    uint32 NameLength{ 0 };
+    uint32 NumFrames{ 0 };
+};
+
+//One control of a mapped sidecar, the views point straight into the mapping.
+struct FKeyframeCacheControlView
+{
+    FAnsiStringView Name;
+    TConstArrayView<int32> Frames;
+    TStaticArray<TConstArrayView<float>, FKeyframeTrackSoA::NumChannels> Channels;
+
+    int32 Num() const { return Frames.Num(); }
+};
+
+/**
+ * Keeps a validated sidecar mapped. Control arrays are read in place without a copy
+ * and stay valid until the view is closed or destroyed.
+ */
+class ANIMATIONSTREAMING_API FKeyframeCacheView
+{
+public:
+    FKeyframeCacheView();
+    ~FKeyframeCacheView();
+
+    //Maps the sidecar of SourcePath, fails when it is missing, malformed or stale.
+    bool Open(const FString& SourcePath);
+    void Close();
+    bool IsOpen() const { return Region.IsValid(); }
+    bool IsComplete() const { return bComplete; }
+
+    const TArray<FKeyframeCacheControlView>& GetControls() const { return Controls; }
+    const FKeyframeCacheControlView* FindControl(const FString& ControlName) const;
+
+private:
+    TUniquePtr<IMappedFileHandle> MappedFile;
+    TUniquePtr<IMappedFileRegion> Region;
+    TArray<FKeyframeCacheControlView> Controls;
+    bool bComplete{ false };
+};
+
+class ANIMATIONSTREAMING_API FKeyframeCache
+{
+public:
+    static constexpr int NumChannels{ 9 };
+
+    static FString GetCachePath(const FString& SourcePath);
+
+    //Controls hold the values as the source stores them, rotation in unnormalized Euler degrees.
+    //Controls are every control of the source, the sidecar is replaced and marked complete.
+    static bool Write(const FString& SourcePath, TArrayView<const uint8> SourceBytes, const TMap<FString, FKeyframeTrackSoA>& Controls);
+    //Controls are some controls of the source. They are merged into a valid sidecar of the same source,
+    //so single control loads neither drop the other controls nor overwrite each other.
+    static bool Merge(const FString& SourcePath, TArrayView<const uint8> SourceBytes, const TMap<FString, FKeyframeTrackSoA>& Controls);
+    static bool Load(const FString& SourcePath, const FString& ControlName, TArray<FKeyframes>& OutKeyframes);
+    static bool Load(const FString& SourcePath, const FString& ControlName, FKeyframeTrackSoA& OutTrack);
+    static bool LoadAll(const FString& SourcePath, TMap<FString, FKeyframeTrack>& OutControls);
+    static bool LoadAll(const FString& SourcePath, TMap<FString, FKeyframeTrackSoA>& OutControls);
+
+private:
+    friend class FKeyframeCacheView;
+
+    static bool WriteSidecar(const FString& SourcePath, TArrayView<const uint8> SourceBytes, const TMap<FString, FKeyframeTrackSoA>& Controls, const bool bComplete);
+    //XXH64 of the whole source, streamed from disk.
+    static bool ReadSourceHash(const FString& SourcePath, uint64& OutHash);
+    static void DecodeControl(const FKeyframeCacheControlView& Control, TArray<FKeyframes>& OutKeyframes);
+    static void DecodeControl(const FKeyframeCacheControlView& Control, FKeyframeTrackSoA& OutTrack);
+};
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Json/KeyframeJsonParser.h"
+#include "Struct/KeyframeTrackSoA.h"
+
+
+/**
+ * Resumable parser for one control, fed with consecutive chunks of a json capture.
+ * Nesting and string state carry over chunk boundaries and only the frame entry in progress is buffered,
+ * every completed entry goes through FKeyframeJsonParser::ParseFrameEntry.
+ */
+class ANIMATIONSTREAMING_API FKeyframeJsonChunkParser
+{
+public:
+    FKeyframeJsonChunkParser(const FString& InControlName, FKeyframeTrackSoA& InTrack);
+
+    bool Consume(TArrayView<const uint8> Chunk);
+    //Flushes the staged frames, fails when the control was not found or not closed.
+    bool Finish();
+
+    //The control object is closed, the rest of the file does not need to be read.
+    bool IsControlComplete() const { return bControlComplete; }
+    int64 GetBytesConsumed() const { return BytesConsumed; }
+    const FString& GetError() const { return Error; }
+
+private:
+    bool CompleteFrameEntry();
+    bool Fail(const FString& Message);
+
+    FString ControlName;
+    TArray<ANSICHAR> ControlNameUtf8;
+    FKeyframeTrackSoA& Track;
+    FKeyframeJsonParser::FTrackBlockWriter BlockWriter;
+
+    //Top-level key or frame entry in progress.
+    TArray<ANSICHAR> Pending;
+    int32 Depth{ 0 };
+    bool bInString{ false };
+    bool bEscaped{ false };
+    bool bCapturingKey{ false };
+    bool bCapturingEntry{ false };
+    bool bKeyMatches{ false };
+    bool bInControl{ false };
+    bool bControlComplete{ false };
+    int64 BytesConsumed{ 0 };
+    FString Error;
+};
@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Struct/Keyframes.h"
+#include "Struct/KeyframeTrackSoA.h"
+
+
+/**
+ * Forward-only keyframe parser over raw UTF-8 bytes.
+ * Emits FKeyframes straight into the output array without building a json DOM,
+ * fields are dispatched on their bytes instead of FJsonObject hash lookups.
+ *
+ * Expected layout: { "<control>": { "<frame>": { "rotation": {x,y,z}, "translation": {x,y,z}, "scale": {x,y,z} } } }
+ */
+class ANIMATIONSTREAMING_API FKeyframeJsonParser
+{
+public:
+    //Byte range of one top-level member value.
+    struct FMemberRange
+    {
+        FString Name;
+        int64 ValueBegin{ 0 };
+        int64 ValueEnd{ 0 };
+    };
+
+    //One frame as parsed, rotation in roll/pitch/yaw degrees.
+    //Values stay double until a sink narrows them, the SoA sink does it a block at a time.
+    struct FParsedFrame
+    {
+        int32 Frame{ 0 };
+        double Translation[3]{ 0.0, 0.0, 0.0 };
+        double Rotation[3]{ 0.0, 0.0, 0.0 };
+        double Scale[3]{ 1.0, 1.0, 1.0 };
+
+        FTransform ToTransform() const;
+    };
+
+    //Stages parsed frames as doubles in section channel order and narrows them into a track per block.
+    struct FTrackBlockWriter
+    {
+        static constexpr int32 BlockSize{ 128 };
+
+        //Returns true once the block is full and should be flushed.
+        bool Add(const FParsedFrame& Frame);
+        void Flush(FKeyframeTrackSoA& OutTrack);
+        //Writes the staged frames from Offset on, into a track that is already sized for them.
+        void FlushTo(FKeyframeTrackSoA& OutTrack, const int32 Offset);
+
+    private:
+        int32 Frames[BlockSize];
+        double Channels[FKeyframeTrackSoA::NumChannels][BlockSize];
+        int32 Num{ 0 };
+    };
+
+    //Byte range of whole "<frame>": { ... } entries, without the separating commas.
+    struct FEntryRange
+    {
+        int64 Begin{ 0 };
+        int64 End{ 0 };
+        int32 NumEntries{ 0 };
+    };
+
+    //Frame objects are split into ranges of at least this many bytes when the range count is picked by size.
+    static constexpr int64 MinRangeBytes{ 4 * 1024 * 1024 };
+
+    FKeyframeJsonParser(const ANSICHAR* InBegin, const ANSICHAR* InEnd);
+
+    //NumRanges splits the control's frame object into ranges parsed in parallel straight into their slots of the output,
+    //the result is the same as a serial parse. 0 picks the count from the size and the worker threads, 1 parses serially.
+    static bool ParseControl(TArrayView<const uint8> Json, const FString& ControlName, TArray<FKeyframes>& OutKeyframes, FString& OutInfoMessage, const int32 NumRanges = 0);
+    static bool ParseControl(TArrayView<const uint8> Json, const FString& ControlName, FKeyframeTrackSoA& OutTrack, FString& OutInfoMessage, const int32 NumRanges = 0);
+    //Finds every top-level control in one structural pass, then parses the controls in parallel.
+    //With fewer controls than worker threads, as in single global_ctrl captures, each control is split into ranges instead.
+    static bool ParseAllControls(TArrayView<const uint8> Json, TMap<FString, FKeyframeTrack>& OutControls, FString& OutInfoMessage);
+    static bool ParseAllControls(TArrayView<const uint8> Json, TMap<FString, FKeyframeTrackSoA>& OutControls, FString& OutInfoMessage);
+
+    //JSON number grammar: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+    static bool IsValidNumber(const FAnsiStringView Number);
+
+    //Collects the byte ranges of the top-level members whose values are objects.
+    bool ScanTopLevelMembers(TArray<FMemberRange>& OutMembers);
+
+    //Moves the cursor onto the value of the top-level member ControlName.
+    bool FindTopLevelMember(const FAnsiStringView ControlName);
+    //Counts the members of the object under the cursor without consuming it.
+    int32 CountObjectMembers() const;
+    //Parses the object under the cursor as "<frame>": { ... } entries.
+    bool ParseFrameObject(TArray<FKeyframes>& OutKeyframes);
+    bool ParseFrameObject(FKeyframeTrackSoA& OutTrack);
+    //Structural pre-scan of the frame object under the cursor: cuts it at top-level commas into ranges
+    //of about TargetBytes, counts their entries and moves the cursor past the object.
+    //Offsets are relative to the parser's bytes.
+    bool SplitFrameObject(const int64 TargetBytes, TArray<FEntryRange>& OutRanges);
+    //Parses exactly NumEntries comma separated "<frame>": { ... } entries up to the end of the parser's bytes
+    //into output that is already sized for them, from Index on.
+    bool ParseFrameEntries(TArray<FKeyframes>& OutKeyframes, const int32 Index, const int32 NumEntries);
+    bool ParseFrameEntries(FKeyframeTrackSoA& OutTrack, const int32 Index, const int32 NumEntries);
+    //Parses a single "<frame>": { ... } entry.
+    bool ParseFrameEntry(FKeyframes& OutKeyframe);
+    bool ParseFrameEntry(FParsedFrame& OutFrame);
+
+    const FString& GetError() const { return Error; }
+    int64 GetOffset() const { return Cursor - Begin; }
+
+private:
+    template <typename TrackType>
+    static bool ParseAllControlsImpl(TArrayView<const uint8> Json, TMap<FString, TrackType>& OutControls, FString& OutInfoMessage);
+    template <typename SinkType>
+    bool ParseFrameObjectImpl(SinkType&& Sink);
+    template <typename SinkType>
+    bool ParseFrameEntriesImpl(const int32 NumEntries, SinkType&& Sink);
+    //Parses the frame object under the cursor, split into NumRanges ranges when that is more than one.
+    //On failure Output is cut back to its size before the call.
+    template <typename OutputType>
+    bool ParseFrameObjectInRanges(const int32 NumRanges, OutputType& Output);
+
+    void SkipWhitespace();
+    bool Expect(const ANSICHAR Character);
+    bool ParseString(FAnsiStringView& OutString);
+    bool ParseNumber(double& OutValue);
+    bool ParseFrameNumber(const FAnsiStringView Key, int32& OutFrame);
+    bool ParseVector(double (&OutComponents)[3]);
+    bool SkipValue();
+    bool Fail(const TCHAR* Message);
+
+    static float NarrowToFloat(const double Value);
+
+    const ANSICHAR* Begin;
+    const ANSICHAR* End;
+    const ANSICHAR* Cursor;
+    FString Error;
+};
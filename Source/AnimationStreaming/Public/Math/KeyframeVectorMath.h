@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+/**
+ * Batch conversion kernels over contiguous keyframe channels, four lanes at a time through VectorRegister math.
+ * Rotations are Euler degrees in roll/pitch/yaw channels and quaternions in x/y/z/w channels,
+ * both follow FRotator::Quaternion and FQuat::Rotator. Pointers may be unaligned, tails are handled per element.
+ */
+class ANIMATIONSTREAMING_API FKeyframeVectorMath
+{
+public:
+    //Narrows to float, values that are not finite floats (NaN, inf, beyond FLT_MAX) become 0. Returns how many were replaced.
+    static int32 NarrowToFloat(const double* Source, float* Out, const int32 Num);
+
+    static void EulerToQuat(const float* Roll, const float* Pitch, const float* Yaw, float* OutX, float* OutY, float* OutZ, float* OutW, const int32 Num);
+    static void QuatToEuler(const float* X, const float* Y, const float* Z, const float* W, float* OutRoll, float* OutPitch, float* OutYaw, const int32 Num);
+
+    //Shifts each value by whole turns so consecutive values never jump by more than 180 degrees.
+    static void UnwindDegrees(float* Values, const int32 Num);
+};
@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Misc/FrameRate.h"
+#include "Struct/Keyframes.h"
+#include "Playback/KeyframePlaybackTrack.h"
+
+#include "KeyframePlaybackComponent.generated.h"
+
+class USceneComponent;
+
+
+/**
+ * Plays parsed capture tracks on actors at runtime without any level sequence, editor or shipping.
+ * One component drives every registered actor: each tick evaluates all tracks in a ParallelFor
+ * and writes the relative transforms of the actors' root components in one pass on the game thread.
+ */
+UCLASS(ClassGroup = (AnimationStreaming), meta = (BlueprintSpawnableComponent))
+class ANIMATIONSTREAMING_API UKeyframePlaybackComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UKeyframePlaybackComponent();
+
+    //Replaces the track the actor had, if any.
+    UFUNCTION(BlueprintCallable, Category = Playback)
+    void SetActorTrack(AActor* Actor, const TArray<FKeyframes>& Keyframes, bool& bOutSuccess);
+
+    //Loads one control of a capture in any registered format.
+    UFUNCTION(BlueprintCallable, Category = Playback)
+    void SetActorTrackFromFile(AActor* Actor, const FString& FilePath, const FString& ControlName, bool& bOutSuccess, FString& OutInfoMessage);
+
+    UFUNCTION(BlueprintCallable, Category = Playback)
+    void RemoveActor(AActor* Actor);
+
+    UFUNCTION(BlueprintCallable, Category = Playback)
+    void ClearActors();
+
+    UFUNCTION(BlueprintCallable, Category = Playback)
+    void Play();
+
+    UFUNCTION(BlueprintCallable, Category = Playback)
+    void Stop();
+
+    //Moves the playhead and applies the pose right away, playing or not.
+    UFUNCTION(BlueprintCallable, Category = Playback)
+    void SetPlaybackFrame(double Frame);
+
+    UFUNCTION(BlueprintPure, Category = Playback)
+    double GetPlaybackFrame() const { return PlaybackFrame; }
+
+    UFUNCTION(BlueprintPure, Category = Playback)
+    bool IsPlaying() const { return bPlaying; }
+
+    UFUNCTION(BlueprintPure, Category = Playback)
+    int GetNumActors() const { return Targets.Num(); }
+
+    //Rate the capture frames were recorded at.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Playback)
+    FFrameRate FrameRate{ 30, 1 };
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Playback)
+    float PlayRate{ 1.0f };
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Playback)
+    bool bLoop{ true };
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Playback)
+    bool bAutoPlay{ true };
+
+    //0 cubic, 1 linear, otherwise constant, as in the importer.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Playback)
+    int KeyInterpolation{ 1 };
+
+    //Fewer actors than this per worker are not worth a task.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Playback)
+    int MinActorsPerTask{ 32 };
+
+    virtual void BeginPlay() override;
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+    struct FPlaybackTarget
+    {
+        TWeakObjectPtr<USceneComponent> Component;
+        FKeyframePlaybackTrack Track;
+        int32 Hint{ 0 };
+    };
+
+    FPlaybackTarget* FindOrAddTarget(AActor* Actor);
+    void UpdateRange();
+    void ApplyPose();
+
+    TArray<FPlaybackTarget> Targets;
+    TArray<FTransform> Pose;
+    double PlaybackFrame{ 0.0 };
+    int32 FirstFrame{ 0 };
+    int32 LastFrame{ 0 };
+    bool bPlaying{ false };
+};
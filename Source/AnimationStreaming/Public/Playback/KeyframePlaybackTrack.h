@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Struct/Keyframes.h"
+#include "Struct/KeyframeTrackSoA.h"
+
+
+//One key with its translation, rotation and scale side by side, 40 bytes, so an evaluation reads adjacent keys only.
+struct ANIMATIONSTREAMING_API FKeyframePlaybackKey
+{
+    FVector3f Translation;
+    FQuat4f Rotation;
+    FVector3f Scale;
+};
+
+
+/**
+ * A parsed control track in the layout runtime playback reads: sorted unique frames next to packed keys
+ * with rotations already on one quaternion hemisphere. Evaluation touches no UObject and is thread safe
+ * as long as every caller owns its hint, sequential playback finds its key in constant time through it.
+ */
+class ANIMATIONSTREAMING_API FKeyframePlaybackTrack
+{
+public:
+    //Duplicated frames keep the last parsed one.
+    void Build(const FKeyframeTrackSoA& Track);
+    void Build(const TArray<FKeyframes>& Keyframes);
+
+    int32 Num() const { return Frames.Num(); }
+    bool IsEmpty() const { return Frames.Num() == 0; }
+    int32 GetFirstFrame() const { return Frames.Num() > 0 ? Frames[0] : 0; }
+    int32 GetLastFrame() const { return Frames.Num() > 0 ? Frames.Last() : 0; }
+    SIZE_T GetAllocatedSize() const { return Frames.GetAllocatedSize() + Keys.GetAllocatedSize(); }
+
+    //Frame is in capture frames and may fall between keys, outside the track the end keys hold.
+    //KeyInterpolation follows the importer: 0 cubic, 1 linear, otherwise constant.
+    FTransform Evaluate(const double Frame, const int KeyInterpolation, int32& InOutHint) const;
+
+private:
+    //Index of the last key at or before Frame, 0 before the first key.
+    int32 FindKey(const double Frame, int32& InOutHint) const;
+    void AddKey(const int32 Frame, const FTransform& Transform);
+
+    TArray<int32> Frames;
+    TArray<FKeyframePlaybackKey> Keys;
+};
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+#include "Sequencer/SequencerImportSession.h"
+#include "Import/KeyframeImportReport.h"
+
+#include "KeyframeDeltaImport.generated.h"
+
+class UMovieSceneSection;
+
+//Content hashes of the keys last imported into one transform section, one per block of frames.
+USTRUCT()
+struct ANIMATIONSTREAMING_API FKeyframeSectionHashes
+{
+	GENERATED_BODY()
+
+public:
+    UPROPERTY()
+    FGuid BindingID;
+
+    UPROPERTY()
+    FName SectionName;
+
+    UPROPERTY()
+    int32 BlockTicks{ 0 };
+
+    UPROPERTY()
+    int32 KeyInterpolation{ 0 };
+
+    //Keys per channel after the import, a different count means the keys were edited since.
+    UPROPERTY()
+    int32 NumKeys{ 0 };
+
+    //Block index (tick / BlockTicks) to the hash of its times and nine channel values.
+    UPROPERTY()
+    TMap<int32, uint64> Blocks;
+};
+
+//Stored on the level sequence asset so hashes survive save and reload.
+UCLASS()
+class ANIMATIONSTREAMING_API UKeyframeSectionHashData : public UAssetUserData
+{
+    GENERATED_BODY()
+
+public:
+    UPROPERTY()
+    TArray<FKeyframeSectionHashes> Sections;
+
+    FKeyframeSectionHashes* Find(const FGuid& BindingID, const FName SectionName);
+    FKeyframeSectionHashes& FindOrAdd(const FGuid& BindingID, const FName SectionName);
+    //Returns true if hashes of the section were dropped.
+    bool Remove(const FGuid& BindingID, const FName SectionName);
+};
+
+
+/**
+ * Re-import that diffs the new keys against the block hashes of the previous import and
+ * replaces keys only in the changed frame ranges of the nine channels.
+ * Writes through FSequencerImportSession and USequencerManager drop the section's hashes, so the next re-import rewrites
+ * every block. Keys added or removed by hand in Sequencer are caught by the key count, hand edited values are not.
+ */
+class ANIMATIONSTREAMING_API FKeyframeDeltaImporter
+{
+public:
+    static constexpr int32 DefaultBlockFrames{ 256 };
+
+    //Thread safe, Keys must not be reduced.
+    static void HashBlocks(const FTransformChannelKeys& Keys, const int32 BlockTicks, TMap<int32, uint64>& OutBlocks);
+
+    //Game thread only. The first import of a section, or one with another block size or interpolation, rewrites every block.
+    static void Reimport(FSequencerImportSession& Session, FTransformChannelKeys& Keys, bool& bOutSuccess, FKeyframeImportReport& Report, const int32 BlockFrames = DefaultBlockFrames);
+
+    //Game thread only, called by every other writer of a section's keys.
+    static void InvalidateHashes(ULevelSequence* LevelSequence, const FGuid& BindingID, const UMovieSceneSection* Section);
+
+private:
+    //Ranges are sorted, disjoint and closed-open. Returns the number of keys written.
+    //Ranges whose key times did not move are overwritten in place, otherwise the channel is rebuilt.
+    static int32 SpliceRanges(FMovieSceneDoubleChannel& Channel, TConstArrayView<TRange<FFrameNumber>> Ranges, const TArray<FFrameNumber>& Times, const TArray<FMovieSceneDoubleValue>& Values);
+};
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/FrameRate.h"
+#include "Misc/MemStack.h"
+#include "Struct/KeyframeTrackSoA.h"
+
+
+/**
+ * Capture frame to sequence tick, computed from the two rates instead of a truncated integer
+ * ticks-per-frame, so ratios like 24000 / 29.97 do not drift along the take.
+ * The tick resolution must be at least the capture rate for distinct frames to stay distinct keys.
+ */
+struct ANIMATIONSTREAMING_API FKeyframeTimeMapping
+{
+    FFrameRate SourceRate{ 30, 1 };
+    FFrameRate TickResolution{ 24000, 1 };
+
+    FKeyframeTimeMapping() = default;
+    FKeyframeTimeMapping(const FFrameRate& InSourceRate, const FFrameRate& InTickResolution);
+
+    //Nearest tick of the exact, sub-frame precise time.
+    FFrameNumber ToTick(const int32 Frame) const;
+    FFrameTime ToTickTime(const FFrameTime& Frame) const;
+};
+
+
+/**
+ * Frame order of a parsed track: radix sorted, duplicates collapsed onto their last
+ * occurrence in file order and gaps recorded, so writers append keys without sorted inserts.
+ */
+struct ANIMATIONSTREAMING_API FKeyframeFrameIndex
+{
+    //Frames strictly between After and Before are missing.
+    struct FGap
+    {
+        int32 After{ 0 };
+        int32 Before{ 0 };
+    };
+
+    //Indices into the source frames, strictly increasing by frame.
+    TArray<int32> Order;
+    TArray<FGap> Gaps;
+    int32 NumDuplicates{ 0 };
+    int32 FirstFrame{ 0 };
+    int32 LastFrame{ 0 };
+
+    FKeyframeFrameIndex() = default;
+    explicit FKeyframeFrameIndex(TConstArrayView<int32> Frames) { Build(Frames); }
+
+    void Build(TConstArrayView<int32> Frames);
+
+    int32 Num() const { return Order.Num(); }
+    int32 GetNumMissingFrames() const;
+
+    //Linear resample of the indexed track onto every TargetRate frame it covers, gaps included.
+    //Euler channels are unwound along the timeline first.
+    void Resample(const FKeyframeTrackSoA& Track, const FFrameRate& SourceRate, const FFrameRate& TargetRate, FKeyframeTrackSoA& OutTrack) const;
+
+private:
+    //Stable LSD radix sort of the frame values, 11 bits per pass over the used range only.
+    //Scratch and result live on the calling thread's FMemStack, under the caller's mark.
+    static void RadixSort(TConstArrayView<int32> Frames, const int32 MinFrame, const int32 MaxFrame, TArray<int32, TMemStackAllocator<>>& OutOrder);
+};
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "KeyframeReduction.generated.h"
+
+struct FTransformChannelKeys;
+
+
+USTRUCT(BlueprintType, Category = KeyFrames)
+struct ANIMATIONSTREAMING_API FKeyframeReductionSettings
+{
+	GENERATED_BODY()
+
+public:
+    //Maximum deviation in centimeters.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float TranslationTolerance{ 0.01f };
+
+    //Maximum deviation in degrees.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float RotationTolerance{ 0.01f };
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float ScaleTolerance{ 0.0001f };
+
+    //Channels that never leave the tolerance band keep a single key.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bCollapseConstantChannels{ true };
+};
+
+/**
+ * Drops redundant keys per channel before they are written to a section.
+ * Linear and cubic channels use Ramer-Douglas-Peucker against the straight line between kept keys,
+ * cubic channels are then checked against the auto tangent curve the section will rebuild and
+ * get keys back wherever it leaves the tolerance.
+ * Constant channels keep only the keys where the held value changes by more than the tolerance.
+ */
+class ANIMATIONSTREAMING_API FKeyframeReducer
+{
+public:
+    static void ReduceChannelKeys(FTransformChannelKeys& Keys, const FKeyframeReductionSettings& Settings);
+
+    //Returns the sorted indices of the keys to keep.
+    static void ReduceChannel(TArrayView<const FFrameNumber> Times, TArrayView<const double> Values, const double Tolerance, const int KeyInterpolation, const bool bCollapseConstant, TArray<int32>& OutKeptIndices);
+
+private:
+    //Re-inserts the worst sample of every span whose auto tangent cubic misses the tolerance until all spans pass.
+    static void RefineCubic(TArrayView<const FFrameNumber> Times, TArrayView<const double> Values, const double Tolerance, TBitArray<>& InOutKeep);
+};
@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
+#include "Channels/MovieSceneDoubleChannel.h"
+#include "Struct/Keyframes.h"
+#include "Struct/KeyframeTrackSoA.h"
+#include "Sequencer/KeyframeReduction.h"
+#include "Sequencer/KeyframeFrameIndex.h"
+#include "Import/KeyframeImportReport.h"
+
+class AActor;
+class ULevelSequence;
+class UMovieScene3DTransformTrack;
+class UMovieScene3DTransformSection;
+
+
+/**
+ * Sorted key times shared by all nine transform channels and the
+ * per-channel values, built in one pass from a batch of keyframes.
+ * After reduction every channel keeps its own times in ReducedTimes.
+ */
+struct ANIMATIONSTREAMING_API FTransformChannelKeys
+{
+    TArray<FFrameNumber> Times;
+    TStaticArray<TArray<FMovieSceneDoubleValue>, 9> Values;
+    TStaticArray<TArray<FFrameNumber>, 9> ReducedTimes;
+    bool bReduced{ false };
+    int KeyInterpolation{ 0 };
+    //Incremental writers commit many batches and set tangents once at the end with AutoSetTangents().
+    bool bDeferAutoTangents{ false };
+
+    const TArray<FFrameNumber>& GetTimes(const int ChannelIndex) const { return bReduced ? ReducedTimes[ChannelIndex] : Times; }
+};
+
+/**
+ * Resolves the level sequence, actor binding, transform track, section, tick ratio
+ * and the nine double channels of a transform section once.
+ * Keyframe writes through the session go straight to the cached channels.
+ */
+class ANIMATIONSTREAMING_API FSequencerImportSession
+{
+public:
+    static constexpr int NumTransformChannels{ 9 };
+
+    FSequencerImportSession() = default;
+    FSequencerImportSession(AActor* Actor, const FString& SequencerPath, const int SectionIndex, bool& bOutSuccess);
+    FSequencerImportSession(ULevelSequence* InLevelSequence, const FGuid& InBindingID, const int SectionIndex, bool& bOutSuccess);
+
+    bool IsValid() const;
+
+    void AddTransformKeyframe(const int Frame, const FTransform& Transform, int KeyInterpolation, bool& bOutSuccess);
+    void AddKeyframeToChannel(const int ChannelIndex, const int Frame, double Value, int KeyInterpolation, bool& bOutSuccess);
+
+    //Batch path: sorts once, builds every channel in bulk and calls Modify() once.
+    void AddTransformKeyframes(const TArray<FKeyframes>& Keyframes, int KeyInterpolation, bool& bOutSuccess);
+    void AddTransformKeyframes(const TArray<FKeyframes>& Keyframes, int KeyInterpolation, const FKeyframeReductionSettings& ReductionSettings, bool& bOutSuccess);
+    void AddTransformKeyframes(const FKeyframeTrackSoA& Track, int KeyInterpolation, bool& bOutSuccess);
+
+    //Thread safe, touches no UObject. Frames are radix sorted and de-duplicated, the last parsed one wins.
+    static void BuildChannelKeys(const TArray<FKeyframes>& Keyframes, const FKeyframeTimeMapping& TimeMapping, int KeyInterpolation, FTransformChannelKeys& OutKeys);
+    static void BuildChannelKeys(const FKeyframeTrackSoA& Track, const FKeyframeTimeMapping& TimeMapping, int KeyInterpolation, FTransformChannelKeys& OutKeys);
+    //Game thread only, merges the built keys into the cached channels.
+    void CommitChannelKeys(FTransformChannelKeys& Keys, bool& bOutSuccess);
+    //Adds the Modify and channel write times and the written keys to Report.
+    void CommitChannelKeys(FTransformChannelKeys& Keys, bool& bOutSuccess, FKeyframeImportReport& Report);
+    //Game thread only, recomputes auto tangents on every channel.
+    void AutoSetTangents();
+    //Only the keys in [First, Last] and their direct neighbours, so appending a batch costs O(batch) instead of O(channel).
+    void AutoSetTangents(const FFrameNumber First, const FFrameNumber Last);
+    static void AutoSetTangents(FMovieSceneDoubleChannel& Channel, const FFrameNumber First, const FFrameNumber Last);
+    //Commits ChannelKeys[Index] into Sessions[Index] as one undo entry. A failed commit cancels the
+    //transaction, which restores the sections already written when an undo buffer is active.
+    static void CommitSessions(TArray<FSequencerImportSession>& Sessions, TArray<FTransformChannelKeys>& ChannelKeys, const FText& Description, bool& bOutSuccess, FKeyframeImportReport& Report);
+    //Writes Track into every session inside one transaction. Keys are built once per distinct time mapping
+    //in parallel, with their auto tangents when a target section is empty. Only targets that already hold keys
+    //run their own tangent pass, the rest take a copy of the shared build.
+    static void CommitTrackToSessions(TArray<FSequencerImportSession>& Sessions, const FKeyframeTrackSoA& Track, int KeyInterpolation, bool& bOutSuccess, FKeyframeImportReport& Report);
+
+    ULevelSequence* GetLevelSequence() const { return LevelSequence.Get(); }
+    const FGuid& GetBindingID() const { return BindingID; }
+    UMovieScene3DTransformTrack* GetTransformTrack() const { return TransformTrack.Get(); }
+    UMovieScene3DTransformSection* GetTransformSection() const { return TransformSection.Get(); }
+    FMovieSceneDoubleChannel* GetChannel(const int ChannelIndex) const;
+    const FKeyframeTimeMapping& GetTimeMapping() const { return TimeMapping; }
+
+private:
+    void Resolve(const int SectionIndex, bool& bOutSuccess);
+    void AddKeyToChannel(FMovieSceneDoubleChannel& Channel, const FFrameNumber FrameNumber, double Value, int KeyInterpolation) const;
+    //Existing keys inside ReplacedRange are dropped, reduced batches leave gaps on purpose. Empty keeps them.
+    static void MergeKeysIntoChannel(FMovieSceneDoubleChannel& Channel, const TArray<FFrameNumber>& Times, TArray<FMovieSceneDoubleValue>& Values, const TRange<FFrameNumber>& ReplacedRange);
+    static FMovieSceneDoubleValue MakeKeyValue(double Value, int KeyInterpolation);
+
+    TWeakObjectPtr<ULevelSequence> LevelSequence;
+    FGuid BindingID;
+    TWeakObjectPtr<UMovieScene3DTransformTrack> TransformTrack;
+    TWeakObjectPtr<UMovieScene3DTransformSection> TransformSection;
+    TStaticArray<FMovieSceneDoubleChannel*, NumTransformChannels> Channels{ InPlace, nullptr };
+    FKeyframeTimeMapping TimeMapping;
+};
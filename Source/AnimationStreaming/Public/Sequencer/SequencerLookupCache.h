@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "UObject/ObjectKey.h"
+
+#include "SequencerLookupCache.generated.h"
+
+class AActor;
+class ULevelSequence;
+class UMovieScene3DTransformTrack;
+
+
+/**
+ * Level sequences by object path, actor bindings by (sequence, actor) and transform tracks by (sequence, binding),
+ * so tools calling USequencerManager in loops skip StaticLoadObject and the world's binding resolution.
+ * Hits are checked against the binding state of the movie scene, not its signature, so keying does not invalidate them.
+ * A changed possessable, spawnable or binding count makes a cached binding resolve to the actor again.
+ * Rebinding an existing possessable to another actor outside USequencerManager needs InvalidateSequence.
+ * Everything is dropped on package reload, replaced objects and world cleanup.
+ */
+UCLASS()
+class ANIMATIONSTREAMING_API USequencerLookupCache : public UEngineSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    //Cached when called on the game thread with an engine, uncached otherwise.
+    static ULevelSequence* LoadSequence(const FString& Path);
+    static FGuid ResolveBinding(ULevelSequence* LevelSequence, AActor* Actor);
+    static UMovieScene3DTransformTrack* ResolveTransformTrack(ULevelSequence* LevelSequence, const FGuid& BindingID);
+
+    //Write-through for bindings and tracks created by the manager.
+    static void NotifyBindingAdded(ULevelSequence* LevelSequence, AActor* Actor, const FGuid& BindingID);
+    static void NotifyTransformTrackAdded(ULevelSequence* LevelSequence, const FGuid& BindingID, UMovieScene3DTransformTrack* TransformTrack);
+
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    UFUNCTION(BlueprintCallable, Category = Sequencer)
+    void InvalidateSequence(ULevelSequence* LevelSequence);
+
+    UFUNCTION(BlueprintCallable, Category = Sequencer)
+    void InvalidateAll();
+
+private:
+    //Counts that change whenever a binding is added to or removed from the movie scene.
+    struct FBindingStamp
+    {
+        int32 NumPossessables{ 0 };
+        int32 NumSpawnables{ 0 };
+        int32 NumBindings{ 0 };
+
+        bool operator==(const FBindingStamp& Other) const
+        {
+            return NumPossessables == Other.NumPossessables && NumSpawnables == Other.NumSpawnables && NumBindings == Other.NumBindings;
+        }
+    };
+
+    struct FBindingEntry
+    {
+        FGuid BindingID;
+        //Binding state when the entry was last checked.
+        FBindingStamp Stamp;
+    };
+
+    struct FTrackEntry
+    {
+        TWeakObjectPtr<UMovieScene3DTransformTrack> TransformTrack;
+    };
+
+    static USequencerLookupCache* Get();
+    static FBindingStamp MakeStamp(const ULevelSequence* LevelSequence);
+    static bool HasBinding(const ULevelSequence* LevelSequence, const FGuid& BindingID);
+    static bool HasTrack(const ULevelSequence* LevelSequence, const FGuid& BindingID, const UMovieScene3DTransformTrack* TransformTrack);
+    static bool IsBoundTo(const ULevelSequence* LevelSequence, const FGuid& BindingID, AActor* Actor);
+
+    void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+#if WITH_EDITOR
+    void OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap);
+    void OnPackageReloaded(const EPackageReloadPhase Phase, FPackageReloadedEvent* Event);
+#endif
+
+    TMap<FString, TWeakObjectPtr<ULevelSequence>> Sequences;
+    TMap<TPair<FObjectKey, FObjectKey>, FBindingEntry> Bindings;
+    TMap<TPair<FObjectKey, FGuid>, FTrackEntry> TransformTracks;
+
+    FDelegateHandle WorldCleanupHandle;
+#if WITH_EDITOR
+    FDelegateHandle ObjectsReplacedHandle;
+    FDelegateHandle PackageReloadedHandle;
+#endif
+};
@@ -6,6 +6,12 @@
 
 #include "Evaluation/Blending/MovieSceneBlendType.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "Struct/Keyframes.h"
+#include "Struct/KeyframeTrackSoA.h"
+#include "Sequencer/KeyframeReduction.h"
+#include "Import/ChunkedKeyframeImporter.h"
+#include "Import/KeyframeImportReport.h"
+#include "Animation/AnimSequenceBaker.h"
 
 #include "SequencerManager.generated.h"
 
@@ -13,6 +19,9 @@ class ULevelSequence;
 class UMovieScene3DTransformTrack;
 class UMovieSceneSkeletalAnimationTrack;
 class UMovieScene3DTransformSection;
+class UMovieSceneSection;
+class UAnimSequence;
+class USkeleton;
 
 
 UCLASS()
@@ -51,6 +60,50 @@ public:
     UFUNCTION(BlueprintCallable, Category = Sequencer)
     static void AddTransformKeyframe(AActor* Actor, const FString& SequencerPath, const int SectionIndex, const int Frame, const FTransform& Transform, int KeyInterpolation, bool& bOutSuccess);
 
+    UFUNCTION(BlueprintCallable, Category = Sequencer)
+    static void AddTransformKeyframes(AActor* Actor, const FString& SequencerPath, const int SectionIndex, const TArray<FKeyframes>& Keyframes, int KeyInterpolation, bool& bOutSuccess);
+
+    //Writes a parsed SoA track, Euler values go to the channels without a quaternion round-trip.
+    UFUNCTION(BlueprintCallable, Category = Sequencer)
+    static void AddTransformTrack(AActor* Actor, const FString& SequencerPath, const int SectionIndex, const FKeyframeTrackSoA& Track, int KeyInterpolation, bool& bOutSuccess);
+
+    //Resamples a track captured at CaptureRate onto every display frame of the sequence it covers.
+    UFUNCTION(BlueprintCallable, Category = Sequencer)
+    static void AddResampledTransformTrack(AActor* Actor, const FString& SequencerPath, const int SectionIndex, const FKeyframeTrackSoA& Track, const FFrameRate& CaptureRate, int KeyInterpolation, bool& bOutSuccess);
+
+    //Drops keys within the tolerances of ReductionSettings before they are written.
+    UFUNCTION(BlueprintCallable, Category = Sequencer)
+    static void AddReducedTransformKeyframes(AActor* Actor, const FString& SequencerPath, const int SectionIndex, const TArray<FKeyframes>& Keyframes, int KeyInterpolation, const FKeyframeReductionSettings& ReductionSettings, bool& bOutSuccess);
+
+    //Actors[i] receives Tracks[i]. Keys are built in parallel, only the commit runs on the game thread.
+    UFUNCTION(BlueprintCallable, Category = Sequencer)
+    static void ImportTakeForActors(const TArray<AActor*>& Actors, const TArray<FKeyframeTrack>& Tracks, const FString& SequencerPath, const int SectionIndex, int KeyInterpolation, bool& bOutSuccess);
+
+    //Writes one parsed take of Actor into every sequence of SequencerPaths inside a single transaction.
+    //Keys are built once per distinct time mapping off the game thread, each package is dirtied once.
+    UFUNCTION(BlueprintCallable, Category = Sequencer)
+    static void ImportTakeToSequences(AActor* Actor, const FKeyframeTrackSoA& Track, const TArray<FString>& SequencerPaths, const int SectionIndex, int KeyInterpolation, bool& bOutSuccess, FKeyframeImportReport& OutReport);
+
+    //Reads, parses and keys ControlName of a json capture in one call, OutReport holds the per phase timings.
+    UFUNCTION(BlueprintCallable, Category = Sequencer)
+    static void ImportJsonToSequencer(AActor* Actor, const FString& FilePath, const FString& ControlName, const FString& SequencerPath, const int SectionIndex, int KeyInterpolation, bool& bOutSuccess, FKeyframeImportReport& OutReport);
+
+    //Rewrites only the frame blocks that changed since the previous import of the same section.
+    UFUNCTION(BlueprintCallable, Category = Sequencer)
+    static void ReimportJsonToSequencer(AActor* Actor, const FString& FilePath, const FString& ControlName, const FString& SequencerPath, const int SectionIndex, int KeyInterpolation, bool& bOutSuccess, FKeyframeImportReport& OutReport);
+
+    //Reads, parses and keys ControlName chunk by chunk, memory stays bounded for takes of any length.
+    UFUNCTION(BlueprintCallable, Category = Sequencer)
+    static void ImportJsonChunked(AActor* Actor, const FString& FilePath, const FString& ControlName, const FString& SequencerPath, const int SectionIndex, int KeyInterpolation, const FChunkedImportSettings& Settings, bool& bOutSuccess, FKeyframeImportReport& OutReport);
+
+    //-------------------SKELETAL ANIMATION-------------------------
+    //Bakes every control of a json capture into the bone of the same name (or Settings.ControlToBone) at the display rate of the sequence.
+    UFUNCTION(BlueprintCallable, Category = Sequencer)
+    static UAnimSequence* BakeJsonToAnimSequence(const FString& FilePath, USkeleton* Skeleton, const FString& AnimSequencePath, const FString& SequencerPath, const FAnimBakeSettings& Settings, bool& bOutSuccess);
+
+    UFUNCTION(BlueprintCallable, Category = Sequencer)
+    static UMovieSceneSection* AddSkeletalAnimationToActor(AActor* Actor, const FString& SequencerPath, UAnimSequence* AnimSequence, const int StartFrame, bool& bOutSuccess);
+
     UFUNCTION(BlueprintCallable, Category = Sequencer)
     static void AddKeyframeToDoubleChannel(UMovieSceneSection* Section, const int ChannelIndex, const int Frame, double Value, int KeyInterpolation, bool& bOutSuccess);
 
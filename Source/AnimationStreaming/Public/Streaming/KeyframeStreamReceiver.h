@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/CircularQueue.h"
+#include "Containers/Ticker.h"
+#include "UObject/Object.h"
+#include "Sequencer/SequencerImportSession.h"
+#include "Streaming/KeyframeStreamTypes.h"
+
+#include "KeyframeStreamReceiver.generated.h"
+
+class FKeyframeStreamWorker;
+
+
+/**
+ * Receives keyframes over a loopback UDP port and keys them into a running sequence.
+ * The network thread only pushes into a lock-free SPSC ring buffer and never waits on the game thread,
+ * a core ticker drains the buffer in batches on the game thread.
+ */
+UCLASS(BlueprintType)
+class ANIMATIONSTREAMING_API UKeyframeStreamReceiver : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UKeyframeStreamReceiver();
+    virtual ~UKeyframeStreamReceiver() override;
+
+    UFUNCTION(BlueprintCallable, Category = Streaming)
+    void StartStreaming(AActor* Actor, const FString& SequencerPath, const int SectionIndex, const int Port, int KeyInterpolation, bool& bOutSuccess);
+
+    UFUNCTION(BlueprintCallable, Category = Streaming)
+    void StopStreaming();
+
+    UFUNCTION(BlueprintPure, Category = Streaming)
+    bool IsStreaming() const;
+
+    UFUNCTION(BlueprintPure, Category = Streaming)
+    FKeyframeStreamStats GetStreamStats() const;
+
+    //Upper bound of frames keyed per game-thread tick.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Streaming)
+    int MaxFramesPerTick{ 4096 };
+
+    //Only stops the receive thread and the ticker, sequencer objects are not touched during garbage collection.
+    virtual void BeginDestroy() override;
+
+private:
+    bool DrainRingBuffer(float DeltaTime);
+    void StopReceiving();
+    //Keys what is still buffered before the streamed actor's world goes away.
+    void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+    TUniquePtr<TCircularQueue<FStreamedKeyframe>> RingBuffer;
+    TUniquePtr<FKeyframeStreamWorker> Worker;
+    FTSTicker::FDelegateHandle TickerHandle;
+    FDelegateHandle WorldCleanupHandle;
+    TWeakObjectPtr<UWorld> StreamedWorld;
+    FSequencerImportSession Session;
+    int KeyInterpolation{ 0 };
+
+    TArray<FKeyframes> Batch;
+    FTransformChannelKeys BatchKeys;
+    TArray<uint64> BatchReceiveCycles;
+    FKeyframeStreamStats Stats;
+    double TotalLatencyMs{ 0.0 };
+};
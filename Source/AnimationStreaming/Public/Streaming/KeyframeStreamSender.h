@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Struct/Keyframes.h"
+
+class FSocket;
+class FInternetAddr;
+
+
+/**
+ * Loopback sender for UKeyframeStreamReceiver, packs keyframes into wire datagrams.
+ */
+class ANIMATIONSTREAMING_API FKeyframeStreamSender
+{
+public:
+    FKeyframeStreamSender() = default;
+    ~FKeyframeStreamSender();
+
+    bool Connect(const int Port);
+    void Disconnect();
+
+    //Returns the number of keyframes that were handed to the socket.
+    int32 Send(TArrayView<const FKeyframes> Keyframes);
+
+private:
+    FSocket* Socket{ nullptr };
+    TSharedPtr<FInternetAddr> Destination;
+};
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Struct/Keyframes.h"
+
+#include "KeyframeStreamTypes.generated.h"
+
+
+/**
+ * Little-endian wire record of one keyframe, channels in section order.
+ * A datagram is one FKeyframePacketHeader followed by NumRecords records.
+ */
+struct FKeyframePacketRecord
+{
+    int32 Frame{ 0 };
+    float Translation[3]{ 0.0f, 0.0f, 0.0f };
+    //Roll, pitch, yaw in degrees.
+    float Rotation[3]{ 0.0f, 0.0f, 0.0f };
+    float Scale[3]{ 1.0f, 1.0f, 1.0f };
+
+    static FKeyframePacketRecord FromKeyframe(const FKeyframes& Keyframe);
+    FKeyframes ToKeyframe() const;
+};
+static_assert(sizeof(FKeyframePacketRecord) == 40, "FKeyframePacketRecord is a wire format and must stay packed");
+
+struct FKeyframePacketHeader
+{
+    static constexpr uint32 ExpectedMagic{ 0x53464B41 }; // "AKFS"
+    static constexpr uint16 CurrentVersion{ 1 };
+    static constexpr int32 MaxDatagramSize{ 1400 };
+    static constexpr int32 MaxRecordsPerPacket{ (MaxDatagramSize - 8) / static_cast<int32>(sizeof(FKeyframePacketRecord)) };
+
+    uint32 Magic{ ExpectedMagic };
+    uint16 Version{ CurrentVersion };
+    uint16 NumRecords{ 0 };
+};
+static_assert(sizeof(FKeyframePacketHeader) == 8, "FKeyframePacketHeader is a wire format and must stay packed");
+
+//Ring buffer entry, stamped on the network thread when the datagram arrives.
+struct FStreamedKeyframe
+{
+    FKeyframes Keyframe;
+    uint64 ReceiveCycles{ 0 };
+};
+
+USTRUCT(BlueprintType, Category = KeyFrames)
+struct ANIMATIONSTREAMING_API FKeyframeStreamStats
+{
+	GENERATED_BODY()
+
+public:
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    int64 FramesReceived{ 0 };
+
+    //Frames lost because the ring buffer was full or the datagram was malformed.
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    int64 FramesDropped{ 0 };
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    int64 FramesWritten{ 0 };
+
+    //Receive to key-in-sequence latency.
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    double AverageLatencyMs{ 0.0 };
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    double MaxLatencyMs{ 0.0 };
+};
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
+#include "Struct/Keyframes.h"
+#include "Struct/KeyframeTrackSoA.h"
+
+
+//Largest allowed reconstruction error per component, in centimeters, degrees and scale units.
+struct ANIMATIONSTREAMING_API FKeyframeCompressionSettings
+{
+    float TranslationTolerance{ 0.01f };
+    float RotationTolerance{ 0.01f };
+    float ScaleTolerance{ 0.0001f };
+    //Frames per DecompressBlock call.
+    int32 BlockFrames{ 64 };
+};
+
+
+/**
+ * One control's keys quantized for keeping whole libraries of takes in memory.
+ * Translation and scale channels are quantized to their own range with just enough bits for the tolerance,
+ * rotations are stored as smallest-three quaternions and channels within tolerance of a constant take no bits.
+ * Every frame has the same bit width, so any frame or block decodes without touching the others.
+ */
+class ANIMATIONSTREAMING_API FKeyframeCompressedTrack
+{
+public:
+    static constexpr int32 NumVectorChannels{ 6 };
+
+    //Game thread or worker. Frames are sorted and duplicates keep the last parsed one.
+    void Compress(const FKeyframeTrackSoA& Track, const FKeyframeCompressionSettings& Settings);
+    void Compress(const TArray<FKeyframes>& Keyframes, const FKeyframeCompressionSettings& Settings);
+
+    //Compresses every control in parallel.
+    static void CompressControls(const TMap<FString, FKeyframeTrack>& Controls, const FKeyframeCompressionSettings& Settings, TMap<FString, FKeyframeCompressedTrack>& OutTracks);
+
+    int32 Num() const { return NumFrames; }
+    int32 GetNumBlocks() const { return NumFrames > 0 ? (NumFrames + BlockFrames - 1) / BlockFrames : 0; }
+    int32 GetBlockFrames() const { return BlockFrames; }
+    int32 GetBitsPerFrame() const { return BitsPerFrame; }
+    int32 GetFrame(const int32 Index) const { return Frames.Num() > 0 ? Frames[Index] : FirstFrame + Index; }
+    //Heap and inline bytes of the track.
+    SIZE_T GetAllocatedSize() const { return sizeof(*this) + Frames.GetAllocatedSize() + Data.GetAllocatedSize(); }
+
+    FTransform DecompressFrame(const int32 Index) const;
+    //Keys of one block in frame order, OutKeyframes is overwritten.
+    void DecompressBlock(const int32 BlockIndex, TArray<FKeyframes>& OutKeyframes) const;
+    void Decompress(TArray<FKeyframes>& OutKeyframes) const;
+
+private:
+    //Bits 0 is a constant channel holding Min.
+    struct FChannel
+    {
+        float Min{ 0.0f };
+        float Step{ 0.0f };
+        uint8 Bits{ 0 };
+        uint16 Offset{ 0 };
+    };
+
+    void DecompressRange(const int32 Begin, const int32 End, FKeyframes* OutKeyframes) const;
+
+    TStaticArray<FChannel, NumVectorChannels> Channels;
+    FQuat4f ConstantRotation{ FQuat4f::Identity };
+    uint8 RotationBits{ 0 };
+    uint16 RotationOffset{ 0 };
+    uint16 BitsPerFrame{ 0 };
+    int32 NumFrames{ 0 };
+    int32 FirstFrame{ 0 };
+    int32 BlockFrames{ 64 };
+    //Only filled when the frames have gaps, contiguous takes are FirstFrame + index.
+    TArray<int32> Frames;
+    //Little-endian bit stream, padded by 8 bytes so every read can load a whole 64-bit word.
+    TArray<uint8> Data;
+};
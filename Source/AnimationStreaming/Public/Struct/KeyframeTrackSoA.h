@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Struct/Keyframes.h"
+
+#include "KeyframeTrackSoA.generated.h"
+
+
+/**
+ * One control's keyframes as contiguous per-channel arrays, 40 bytes per frame.
+ * Rotation stays in Euler degrees as parsed, so no quaternion round-trip happens
+ * between the parser and the channel writer. Channels use section order.
+ */
+USTRUCT(BlueprintType, Category = KeyFrames)
+struct ANIMATIONSTREAMING_API FKeyframeTrackSoA
+{
+	GENERATED_BODY()
+
+public:
+    static constexpr int NumChannels{ 9 };
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<int32> Frames;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<float> TranslationX;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<float> TranslationY;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<float> TranslationZ;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<float> Roll;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<float> Pitch;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<float> Yaw;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<float> ScaleX;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<float> ScaleY;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<float> ScaleZ;
+
+    int32 Num() const { return Frames.Num(); }
+    bool IsConsistent() const;
+
+    void Reserve(const int32 NumFrames);
+    void Reset(const int32 NumFrames = 0);
+    void SetNumUninitialized(const int32 NumFrames);
+    void Add(const int32 Frame, const float (&Translation)[3], const float (&Rotation)[3], const float (&Scale)[3]);
+
+    //0-2 translation, 3-5 roll/pitch/yaw, 6-8 scale.
+    TArray<float>& GetChannel(const int ChannelIndex);
+    const TArray<float>& GetChannel(const int ChannelIndex) const;
+
+    FTransform GetTransform(const int32 Index) const;
+
+    void ToKeyframes(TArray<FKeyframes>& OutKeyframes) const;
+    static FKeyframeTrackSoA FromKeyframes(const TArray<FKeyframes>& Keyframes);
+    //Gathers Keyframes in the given index order, optionally unwinding the Euler channels along it.
+    static FKeyframeTrackSoA FromKeyframes(const TArray<FKeyframes>& Keyframes, TConstArrayView<int32> Order, const bool bUnwindRotation);
+};
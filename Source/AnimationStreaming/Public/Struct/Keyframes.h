@@ -18,3 +18,13 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     FTransform Coordinates;
 };
+
+USTRUCT(BlueprintType, Category = KeyFrames)
+struct ANIMATIONSTREAMING_API FKeyframeTrack
+{
+	GENERATED_BODY()
+
+public:
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<FKeyframes> Keyframes;
+};